@@ -0,0 +1,53 @@
+'use strict';
+
+const common = require('../common');
+const fs = require('fs');
+const path = require('path');
+
+const bench = common.createBenchmark(main, {
+  n: [10],
+  dir: [ 'lib', 'deps' ],
+  method: ['walk', 'readdir']
+});
+
+// Lists the tree below `dir` the way tools did before fs.walk() existed,
+// with one fs.readdir() call per directory.
+function readdirRecursive(dir, callback) {
+  let pending = 1;
+  let count = 0;
+  (function visit(dir) {
+    fs.readdir(dir, { withFileTypes: true }, (err, entries) => {
+      if (err) throw err;
+      for (const entry of entries) {
+        if (entry.isFile())
+          count++;
+        if (entry.isDirectory()) {
+          pending++;
+          visit(path.join(dir, entry.name));
+        }
+      }
+      if (--pending === 0)
+        callback(count);
+    });
+  })(dir);
+}
+
+async function walk(dir, callback) {
+  let count = 0;
+  for await (const entry of fs.walk(dir, { withFileTypes: true })) {
+    if (entry.isFile())
+      count++;
+  }
+  callback(count);
+}
+
+function main({ n, dir, method }) {
+  const fullPath = path.resolve(__dirname, '../../', dir);
+  const fn = method === 'walk' ? walk : readdirRecursive;
+  bench.start();
+  (function r(cntr) {
+    if (cntr-- <= 0)
+      return bench.end(n);
+    fn(fullPath, () => r(cntr));
+  }(n));
+}
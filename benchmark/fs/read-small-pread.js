@@ -0,0 +1,48 @@
+// Test the throughput of many small positional fs.read() calls, which run on
+// an io_uring instead of libuv's threadpool on Linux unless that is disabled.
+'use strict';
+
+const path = require('path');
+const common = require('../common.js');
+const fs = require('fs');
+
+const filename = path.resolve(process.env.NODE_TMPDIR || __dirname,
+                              `.removeme-benchmark-garbage-${process.pid}`);
+
+const bench = common.createBenchmark(main, {
+  iouring: [0, 1],
+  concurrent: [1, 16, 64],
+  size: [512, 4096],
+  n: [1e5]
+});
+
+function main({ iouring, concurrent, size, n }) {
+  // The io_uring is set up by the first request that could use it, so this
+  // has to happen before any asynchronous fs call.
+  process.env.UV_USE_IO_URING = `${iouring}`;
+
+  const filesize = 1024 * 1024;
+  fs.writeFileSync(filename, Buffer.alloc(filesize, 'a'));
+  const fd = fs.openSync(filename, 'r');
+  let started = 0;
+  let finished = 0;
+
+  function read() {
+    const buffer = Buffer.allocUnsafe(size);
+    const position = (started++ * size) % (filesize - size);
+    fs.read(fd, buffer, 0, size, position, (err, bytesRead) => {
+      if (err) throw err;
+      if (++finished === n) {
+        bench.end(n);
+        fs.closeSync(fd);
+        try { fs.unlinkSync(filename); } catch {}
+      } else if (started < n) {
+        read();
+      }
+    });
+  }
+
+  bench.start();
+  for (var i = 0; i < concurrent && i < n; i++)
+    read();
+}
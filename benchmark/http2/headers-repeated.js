@@ -0,0 +1,86 @@
+'use strict';
+
+// Small requests that repeat the same headers, like gRPC calls do, so that
+// most of them are sent as references into the HPACK dynamic table.
+// With `measure=gc`, reports the number of garbage collections per 1000
+// requests instead of the request rate, as a measure of how much the header
+// handling allocates.
+
+const common = require('../common.js');
+const PORT = common.PORT;
+
+const bench = common.createBenchmark(main, {
+  n: [1e4],
+  streams: [1, 100],
+  nheaders: [0, 10],
+  measure: ['rate', 'gc']
+}, { flags: ['--no-warnings'] });
+
+function main({ n, streams, nheaders, measure }) {
+  const http2 = require('http2');
+  const { PerformanceObserver } = require('perf_hooks');
+  const server = http2.createServer();
+
+  let gcs = 0;
+  const obs = new PerformanceObserver((list) => {
+    gcs += list.getEntries().length;
+  });
+
+  const headersObject = {
+    ':method': 'POST',
+    ':path': '/helloworld.Greeter/SayHello',
+    'content-type': 'application/grpc',
+    'te': 'trailers',
+    'grpc-accept-encoding': 'identity,deflate,gzip',
+    'user-agent': 'grpc-node/1.20.0 grpc-c/7.0.0 (linux; chttp2; godric)'
+  };
+
+  for (var i = 0; i < nheaders; i++) {
+    headersObject[`x-metadata-${i}`] = `some metadata value ${i}`;
+  }
+
+  const responseHeaders = {
+    ':status': 200,
+    'content-type': 'application/grpc'
+  };
+
+  server.on('stream', (stream) => {
+    stream.respond(responseHeaders);
+    stream.end();
+  });
+  server.listen(PORT, () => {
+    const client = http2.connect(`http://localhost:${PORT}/`);
+    let started = 0;
+    let finished = 0;
+
+    function doRequest() {
+      started++;
+      const req = client.request(headersObject, { endStream: true });
+      req.resume();
+      req.on('end', () => {
+        if (++finished === n) {
+          if (measure === 'gc') {
+            obs.disconnect();
+            bench.report(gcs * 1000 / n, process.hrtime(start));
+          } else {
+            bench.end(n);
+          }
+          server.close();
+          client.destroy();
+        } else if (started < n) {
+          doRequest();
+        }
+      });
+    }
+
+    let start;
+    if (measure === 'gc') {
+      start = process.hrtime();
+      obs.observe({ entryTypes: ['gc'] });
+    } else {
+      bench.start();
+    }
+    for (var j = 0; j < streams && j < n; j++)
+      doRequest();
+  });
+}
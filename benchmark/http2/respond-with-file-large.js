@@ -0,0 +1,36 @@
+'use strict';
+
+const common = require('../common.js');
+const path = require('path');
+const fs = require('fs');
+const tmpdir = require('../../test/common/tmpdir');
+
+const bench = common.createBenchmark(main, {
+  requests: [100, 1000],
+  streams: [1, 10, 100],
+  size: [1024 * 1024, 16 * 1024 * 1024],
+  clients: [2],
+  benchmarker: ['h2load']
+}, { flags: ['--no-warnings'] });
+
+function main({ requests, streams, size, clients }) {
+  tmpdir.refresh();
+  const file = path.join(tmpdir.path, 'http2-benchmark-asset');
+  fs.writeFileSync(file, Buffer.alloc(size, 'a'));
+
+  const http2 = require('http2');
+  const server = http2.createServer();
+  server.on('stream', (stream) => {
+    stream.respondWithFile(file);
+    stream.on('error', (err) => {});
+  });
+  server.listen(common.PORT, () => {
+    bench.http({
+      path: '/',
+      requests,
+      maxConcurrentStreams: streams,
+      clients,
+      threads: clients
+    }, () => server.close());
+  });
+}
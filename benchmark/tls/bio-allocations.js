@@ -0,0 +1,75 @@
+// Reports the number of NodeBIO buffers allocated per MB transferred over TLS
+// connections that send their data in bursts, i.e. the allocations that the
+// per-Environment buffer pool could not serve.
+'use strict';
+const common = require('../common.js');
+const bench = common.createBenchmark(main, {
+  conns: [1, 32],
+  burst: [1024, 64 * 1024],
+  mb: [64]
+}, { flags: ['--expose-internals'] });
+
+const fs = require('fs');
+const path = require('path');
+const tls = require('tls');
+const cert_dir = path.resolve(__dirname, '../../test/fixtures');
+
+function main({ conns, burst, mb }) {
+  const { getBIOBufferPoolStats } = common.binding('tls_wrap');
+  const options = {
+    key: fs.readFileSync(path.resolve(cert_dir, 'test_key.pem')),
+    cert: fs.readFileSync(path.resolve(cert_dir, 'test_cert.pem')),
+    ciphers: 'AES256-GCM-SHA384'
+  };
+  const total = mb * 1024 * 1024;
+  const perConnection = Math.ceil(total / conns / burst);
+  const chunk = Buffer.alloc(burst, 'b');
+
+  let received = 0;
+  let finished = false;
+  const clients = [];
+  const server = tls.createServer(options, (socket) => {
+    socket.on('data', (data) => {
+      received += data.length;
+      if (!finished && received >= perConnection * burst * conns)
+        done();
+    });
+  });
+
+  let start;
+  let allocatedAtStart;
+
+  server.listen(0, () => {
+    const port = server.address().port;
+    let connected = 0;
+    for (let i = 0; i < conns; i++) {
+      clients.push(tls.connect({ port, rejectUnauthorized: false }, () => {
+        if (++connected === conns)
+          clients.forEach(send);
+      }));
+    }
+
+    function send(client) {
+      // Wait for each burst to be flushed, so that the BIOs drain in between.
+      let left = perConnection;
+      (function next() {
+        if (left-- === 0)
+          return;
+        if (start === undefined) {
+          start = process.hrtime();
+          allocatedAtStart = getBIOBufferPoolStats()[0];
+        }
+        client.write(chunk, () => setImmediate(next));
+      })();
+    }
+  });
+
+  function done() {
+    finished = true;
+    const allocated = getBIOBufferPoolStats()[0] - allocatedAtStart;
+    bench.report(allocated / mb, process.hrtime(start));
+    for (const client of clients)
+      client.destroy();
+    server.close();
+  }
+}
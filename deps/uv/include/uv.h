@@ -235,6 +235,7 @@ typedef struct uv_interface_address_s uv_interface_address_t;
 typedef struct uv_dirent_s uv_dirent_t;
 typedef struct uv_passwd_s uv_passwd_t;
 typedef struct uv_utsname_s uv_utsname_t;
+typedef struct uv_threadpool_stats_s uv_threadpool_stats_t;
 
 typedef enum {
   UV_LOOP_BLOCK_SIGNAL
@@ -590,7 +591,30 @@ enum uv_udp_flags {
    * (provided they all set the flag) but only the last one to bind will receive
    * any traffic, in effect "stealing" the port from the previous listener.
    */
-  UV_UDP_REUSEADDR = 4
+  UV_UDP_REUSEADDR = 4,
+  /*
+   * Indicates that the message was received by recvmmsg, so the buffer provided
+   * must not be freed by the recv_cb callback.
+   */
+  UV_UDP_MMSG_CHUNK = 8,
+  /*
+   * Indicates that the buffer provided has been fully utilized by recvmmsg and
+   * that it should now be freed by the recv_cb callback. When this flag is set
+   * in uv_udp_recv_cb, nread will always be 0 and addr will always be NULL.
+   */
+  UV_UDP_MMSG_FREE = 16,
+  /*
+   * Indicates that recvmmsg should be used, if available. Only valid as a flag
+   * for uv_udp_init_ex.
+   */
+  UV_UDP_RECVMMSG = 256,
+  /*
+   * Indicates that the datagrams passed to uv_udp_try_send2 may be coalesced
+   * into a single UDP_SEGMENT (GSO) send when they share a destination and
+   * all but the last have the same size. Only valid as a flag for
+   * uv_udp_try_send2.
+   */
+  UV_UDP_SEGMENT = 512
 };
 
 typedef void (*uv_udp_send_cb)(uv_udp_send_t* req, int status);
@@ -658,6 +682,12 @@ UV_EXTERN int uv_udp_try_send(uv_udp_t* handle,
                               const uv_buf_t bufs[],
                               unsigned int nbufs,
                               const struct sockaddr* addr);
+UV_EXTERN int uv_udp_try_send2(uv_udp_t* handle,
+                               unsigned int count,
+                               uv_buf_t* bufs[/*count*/],
+                               unsigned int nbufs[/*count*/],
+                               struct sockaddr* addrs[/*count*/],
+                               unsigned int flags);
 UV_EXTERN int uv_udp_recv_start(uv_udp_t* handle,
                                 uv_alloc_cb alloc_cb,
                                 uv_udp_recv_cb recv_cb);
@@ -1020,6 +1050,45 @@ UV_EXTERN int uv_queue_work(uv_loop_t* loop,
                             uv_work_cb work_cb,
                             uv_after_work_cb after_work_cb);
 
+typedef enum {
+  UV_WORK_CPU,
+  UV_WORK_FAST_IO,
+  UV_WORK_SLOW_IO,
+  UV_WORK_KIND_MAX
+} uv_work_kind;
+
+UV_EXTERN int uv_queue_work_kind(uv_loop_t* loop,
+                                 uv_work_t* req,
+                                 uv_work_kind kind,
+                                 uv_work_cb work_cb,
+                                 uv_after_work_cb after_work_cb);
+
+struct uv_threadpool_stats_s {
+  unsigned int threads;
+  unsigned int idle_threads;
+  unsigned int queued;
+  unsigned int max_queued;
+  unsigned int running;
+  uint64_t submitted;
+  uint64_t completed;
+  uint64_t wait_time;
+  uint64_t max_wait_time;
+  uint64_t run_time;
+};
+
+UV_EXTERN int uv_threadpool_stats(uv_work_kind kind,
+                                  uv_threadpool_stats_t* stats);
+
+typedef void (*uv_work_timing_cb)(uv_loop_t* loop,
+                                  void* arg,
+                                  uv_work_kind kind,
+                                  uint64_t wait_time,
+                                  uint64_t run_time);
+
+UV_EXTERN void uv_loop_set_work_timing_cb(uv_loop_t* loop,
+                                          uv_work_timing_cb cb,
+                                          void* arg);
+
 UV_EXTERN int uv_cancel(uv_req_t* req);
 
 
@@ -1630,9 +1699,11 @@ struct uv_loop_s {
   unsigned int active_handles;
   void* handle_queue[2];
   union {
-    void* unused[2];
+    void* unused;
     unsigned int count;
   } active_reqs;
+  /* Internal storage for future extensions. */
+  void* internal_fields;
   /* Internal flag to signal loop stop. */
   unsigned int stop_flag;
   UV_LOOP_PRIVATE_FIELDS
@@ -29,22 +29,49 @@
 
 #define MAX_THREADPOOL_SIZE 128
 
+/* Every kind of work runs on a pool of its own, so that a burst of CPU-bound
+ * work can't hold up file system requests and vice versa.  The threads of a
+ * pool are started when the first request of that kind is submitted.
+ */
+struct uv__threadpool {
+  uv_cond_t cond;
+  uv_mutex_t mutex;
+  unsigned int size;
+  unsigned int nthreads;
+  unsigned int idle_threads;
+  unsigned int queued;
+  unsigned int max_queued;
+  unsigned int running;
+  uint64_t submitted;
+  uint64_t completed;
+  uint64_t wait_time;
+  uint64_t max_wait_time;
+  uint64_t run_time;
+  uv_thread_t* threads;
+  uv_thread_t default_threads[4];
+  uv_sem_t sem;
+  QUEUE exit_message;
+  QUEUE wq;
+};
+
+/* The bookkeeping of a request while it is in flight. It is kept out of
+ * struct uv__work, which is embedded in public request types, so that the
+ * layout of those doesn't change. `w->wq[0]` points to the entry from
+ * uv__work_submit() until right before the done callback, and is NULL
+ * otherwise.
+ */
+struct uv__work_entry {
+  QUEUE wq;
+  struct uv__work* w;
+  unsigned int kind;
+  uint64_t queued_at;
+  uint64_t wait_time;
+  uint64_t run_time;
+};
+
 static uv_once_t once = UV_ONCE_INIT;
-static uv_cond_t cond;
-static uv_mutex_t mutex;
-static unsigned int idle_threads;
-static unsigned int slow_io_work_running;
-static unsigned int nthreads;
-static uv_thread_t* threads;
-static uv_thread_t default_threads[4];
-static QUEUE exit_message;
-static QUEUE wq;
-static QUEUE run_slow_work_message;
-static QUEUE slow_io_pending_wq;
-
-static unsigned int slow_work_thread_threshold(void) {
-  return (nthreads + 1) / 2;
-}
+static struct uv__threadpool pools[UV_WORK_KIND_MAX];
+
 
 static void uv__cancelled(struct uv__work* w) {
   abort();
@@ -52,183 +79,200 @@ static void uv__cancelled(struct uv__work* w) {
 
 
 /* To avoid deadlock with uv_cancel() it's crucial that the worker
- * never holds the global mutex and the loop-local mutex at the same time.
+ * never holds the pool mutex and the loop-local mutex at the same time.
  */
 static void worker(void* arg) {
+  struct uv__threadpool* pool;
+  struct uv__work_entry* e;
   struct uv__work* w;
+  uint64_t started_at;
+  uint64_t run_time;
   QUEUE* q;
-  int is_slow_work;
 
-  uv_sem_post((uv_sem_t*) arg);
+  pool = arg;
+  uv_sem_post(&pool->sem);
   arg = NULL;
 
-  uv_mutex_lock(&mutex);
+  uv_mutex_lock(&pool->mutex);
   for (;;) {
-    /* `mutex` should always be locked at this point. */
-
-    /* Keep waiting while either no work is present or only slow I/O
-       and we're at the threshold for that. */
-    while (QUEUE_EMPTY(&wq) ||
-           (QUEUE_HEAD(&wq) == &run_slow_work_message &&
-            QUEUE_NEXT(&run_slow_work_message) == &wq &&
-            slow_io_work_running >= slow_work_thread_threshold())) {
-      idle_threads += 1;
-      uv_cond_wait(&cond, &mutex);
-      idle_threads -= 1;
+    /* `pool->mutex` should always be locked at this point. */
+
+    while (QUEUE_EMPTY(&pool->wq)) {
+      pool->idle_threads += 1;
+      uv_cond_wait(&pool->cond, &pool->mutex);
+      pool->idle_threads -= 1;
     }
 
-    q = QUEUE_HEAD(&wq);
-    if (q == &exit_message) {
-      uv_cond_signal(&cond);
-      uv_mutex_unlock(&mutex);
+    q = QUEUE_HEAD(&pool->wq);
+    if (q == &pool->exit_message) {
+      uv_cond_signal(&pool->cond);
+      uv_mutex_unlock(&pool->mutex);
       break;
     }
 
     QUEUE_REMOVE(q);
     QUEUE_INIT(q);  /* Signal uv_cancel() that the work req is executing. */
 
-    is_slow_work = 0;
-    if (q == &run_slow_work_message) {
-      /* If we're at the slow I/O threshold, re-schedule until after all
-         other work in the queue is done. */
-      if (slow_io_work_running >= slow_work_thread_threshold()) {
-        QUEUE_INSERT_TAIL(&wq, q);
-        continue;
-      }
-
-      /* If we encountered a request to run slow I/O work but there is none
-         to run, that means it's cancelled => Start over. */
-      if (QUEUE_EMPTY(&slow_io_pending_wq))
-        continue;
-
-      is_slow_work = 1;
-      slow_io_work_running++;
-
-      q = QUEUE_HEAD(&slow_io_pending_wq);
-      QUEUE_REMOVE(q);
-      QUEUE_INIT(q);
-
-      /* If there is more slow I/O work, schedule it to be run as well. */
-      if (!QUEUE_EMPTY(&slow_io_pending_wq)) {
-        QUEUE_INSERT_TAIL(&wq, &run_slow_work_message);
-        if (idle_threads > 0)
-          uv_cond_signal(&cond);
-      }
-    }
+    e = QUEUE_DATA(q, struct uv__work_entry, wq);
+    w = e->w;
+    started_at = uv_hrtime();
+    e->wait_time = started_at - e->queued_at;
+    pool->queued -= 1;
+    pool->running += 1;
+    pool->wait_time += e->wait_time;
+    if (e->wait_time > pool->max_wait_time)
+      pool->max_wait_time = e->wait_time;
 
-    uv_mutex_unlock(&mutex);
+    uv_mutex_unlock(&pool->mutex);
 
-    w = QUEUE_DATA(q, struct uv__work, wq);
     w->work(w);
+    run_time = uv_hrtime() - started_at;
+    e->run_time = run_time;
 
     uv_mutex_lock(&w->loop->wq_mutex);
     w->work = NULL;  /* Signal uv_cancel() that the work req is done
                         executing. */
-    QUEUE_INSERT_TAIL(&w->loop->wq, &w->wq);
+    QUEUE_INSERT_TAIL(&w->loop->wq, &e->wq);
     uv_async_send(&w->loop->wq_async);
     uv_mutex_unlock(&w->loop->wq_mutex);
 
-    /* Lock `mutex` since that is expected at the start of the next
-     * iteration. */
-    uv_mutex_lock(&mutex);
-    if (is_slow_work) {
-      /* `slow_io_work_running` is protected by `mutex`. */
-      slow_io_work_running--;
-    }
+    /* Lock `pool->mutex` since that is expected at the start of the next
+     * iteration. `w` may have been freed by now. */
+    uv_mutex_lock(&pool->mutex);
+    pool->running -= 1;
+    pool->completed += 1;
+    pool->run_time += run_time;
   }
 }
 
 
-static void post(QUEUE* q, enum uv__work_kind kind) {
-  uv_mutex_lock(&mutex);
-  if (kind == UV__WORK_SLOW_IO) {
-    /* Insert into a separate queue. */
-    QUEUE_INSERT_TAIL(&slow_io_pending_wq, q);
-    if (!QUEUE_EMPTY(&run_slow_work_message)) {
-      /* Running slow I/O tasks is already scheduled => Nothing to do here.
-         The worker that runs said other task will schedule this one as well. */
-      uv_mutex_unlock(&mutex);
-      return;
+/* Called with `pool->mutex` held.  The workers don't touch the mutex before
+ * they have posted the semaphore, so waiting for them here can't deadlock.
+ */
+static void start_threads(struct uv__threadpool* pool) {
+  unsigned int i;
+
+  pool->threads = pool->default_threads;
+  if (pool->size > ARRAY_SIZE(pool->default_threads)) {
+    pool->threads = uv__malloc(pool->size * sizeof(pool->threads[0]));
+    if (pool->threads == NULL) {
+      pool->size = ARRAY_SIZE(pool->default_threads);
+      pool->threads = pool->default_threads;
     }
-    q = &run_slow_work_message;
   }
 
-  QUEUE_INSERT_TAIL(&wq, q);
-  if (idle_threads > 0)
-    uv_cond_signal(&cond);
-  uv_mutex_unlock(&mutex);
+  if (uv_sem_init(&pool->sem, 0))
+    abort();
+
+  for (i = 0; i < pool->size; i++)
+    if (uv_thread_create(pool->threads + i, worker, pool))
+      abort();
+
+  for (i = 0; i < pool->size; i++)
+    uv_sem_wait(&pool->sem);
+
+  uv_sem_destroy(&pool->sem);
+  pool->nthreads = pool->size;
+}
+
+
+static void post(struct uv__threadpool* pool, QUEUE* q) {
+  uv_mutex_lock(&pool->mutex);
+  if (pool->nthreads == 0)
+    start_threads(pool);
+
+  if (q != &pool->exit_message) {
+    pool->submitted += 1;
+    pool->queued += 1;
+    if (pool->queued > pool->max_queued)
+      pool->max_queued = pool->queued;
+  }
+
+  QUEUE_INSERT_TAIL(&pool->wq, q);
+  if (pool->idle_threads > 0)
+    uv_cond_signal(&pool->cond);
+  uv_mutex_unlock(&pool->mutex);
 }
 
 
 #ifndef _WIN32
 UV_DESTRUCTOR(static void cleanup(void)) {
+  struct uv__threadpool* pool;
   unsigned int i;
 
-  if (nthreads == 0)
-    return;
+  for (pool = pools; pool < pools + ARRAY_SIZE(pools); pool++) {
+    if (pool->nthreads == 0)
+      continue;
 
-  post(&exit_message, UV__WORK_CPU);
+    post(pool, &pool->exit_message);
 
-  for (i = 0; i < nthreads; i++)
-    if (uv_thread_join(threads + i))
-      abort();
+    for (i = 0; i < pool->nthreads; i++)
+      if (uv_thread_join(pool->threads + i))
+        abort();
 
-  if (threads != default_threads)
-    uv__free(threads);
+    if (pool->threads != pool->default_threads)
+      uv__free(pool->threads);
 
-  uv_mutex_destroy(&mutex);
-  uv_cond_destroy(&cond);
+    uv_mutex_destroy(&pool->mutex);
+    uv_cond_destroy(&pool->cond);
 
-  threads = NULL;
-  nthreads = 0;
+    pool->threads = NULL;
+    pool->nthreads = 0;
+  }
 }
 #endif
 
 
-static void init_threads(void) {
-  unsigned int i;
+static unsigned int pool_size(const char* name, unsigned int size) {
   const char* val;
-  uv_sem_t sem;
 
-  nthreads = ARRAY_SIZE(default_threads);
-  val = getenv("UV_THREADPOOL_SIZE");
+  val = getenv(name);
   if (val != NULL)
-    nthreads = atoi(val);
-  if (nthreads == 0)
-    nthreads = 1;
-  if (nthreads > MAX_THREADPOOL_SIZE)
-    nthreads = MAX_THREADPOOL_SIZE;
-
-  threads = default_threads;
-  if (nthreads > ARRAY_SIZE(default_threads)) {
-    threads = uv__malloc(nthreads * sizeof(threads[0]));
-    if (threads == NULL) {
-      nthreads = ARRAY_SIZE(default_threads);
-      threads = default_threads;
-    }
-  }
+    size = atoi(val);
+  if (size == 0)
+    size = 1;
+  if (size > MAX_THREADPOOL_SIZE)
+    size = MAX_THREADPOOL_SIZE;
 
-  if (uv_cond_init(&cond))
-    abort();
+  return size;
+}
 
-  if (uv_mutex_init(&mutex))
-    abort();
 
-  QUEUE_INIT(&wq);
-  QUEUE_INIT(&slow_io_pending_wq);
-  QUEUE_INIT(&run_slow_work_message);
+static void init_pools(void) {
+  struct uv__threadpool* pool;
+  unsigned int nthreads;
 
-  if (uv_sem_init(&sem, 0))
-    abort();
-
-  for (i = 0; i < nthreads; i++)
-    if (uv_thread_create(threads + i, worker, &sem))
+  /* UV_THREADPOOL_SIZE sizes the CPU and fast I/O pools; slow I/O gets half
+   * as many threads, which is what it was capped at when all kinds of work
+   * still shared one pool.
+   */
+  nthreads = pool_size("UV_THREADPOOL_SIZE", 4);
+  pools[UV__WORK_CPU].size = pool_size("UV_THREADPOOL_CPU_SIZE", nthreads);
+  pools[UV__WORK_FAST_IO].size =
+      pool_size("UV_THREADPOOL_FAST_IO_SIZE", nthreads);
+  pools[UV__WORK_SLOW_IO].size =
+      pool_size("UV_THREADPOOL_SLOW_IO_SIZE", (nthreads + 1) / 2);
+
+  for (pool = pools; pool < pools + ARRAY_SIZE(pools); pool++) {
+    if (uv_cond_init(&pool->cond))
       abort();
 
-  for (i = 0; i < nthreads; i++)
-    uv_sem_wait(&sem);
+    if (uv_mutex_init(&pool->mutex))
+      abort();
 
-  uv_sem_destroy(&sem);
+    pool->nthreads = 0;
+    pool->idle_threads = 0;
+    pool->queued = 0;
+    pool->max_queued = 0;
+    pool->running = 0;
+    pool->submitted = 0;
+    pool->completed = 0;
+    pool->wait_time = 0;
+    pool->max_wait_time = 0;
+    pool->run_time = 0;
+    pool->threads = NULL;
+    QUEUE_INIT(&pool->wq);
+  }
 }
 
 
@@ -242,14 +286,14 @@ static void reset_once(void) {
 
 static void init_once(void) {
 #ifndef _WIN32
-  /* Re-initialize the threadpool after fork.
-   * Note that this discards the global mutex and condition as well
-   * as the work queue.
+  /* Re-initialize the threadpools after fork.
+   * Note that this discards the pool mutexes and conditions as well
+   * as the work queues.
    */
   if (pthread_atfork(NULL, NULL, &reset_once))
     abort();
 #endif
-  init_threads();
+  init_pools();
 }
 
 
@@ -258,33 +302,59 @@ void uv__work_submit(uv_loop_t* loop,
                      enum uv__work_kind kind,
                      void (*work)(struct uv__work* w),
                      void (*done)(struct uv__work* w, int status)) {
+  struct uv__work_entry* e;
+
   uv_once(&once, init_once);
+
+  /* Like the watcher array of the event loop, there is no way to report
+   * this to the caller.
+   */
+  e = uv__malloc(sizeof(*e));
+  if (e == NULL)
+    abort();
+
+  e->w = w;
+  e->kind = kind;
+  e->queued_at = uv_hrtime();
   w->loop = loop;
   w->work = work;
   w->done = done;
-  post(&w->wq, kind);
+  w->wq[0] = e;
+  post(&pools[kind], &e->wq);
 }
 
 
 static int uv__work_cancel(uv_loop_t* loop, uv_req_t* req, struct uv__work* w) {
+  struct uv__threadpool* pool;
+  struct uv__work_entry* e;
   int cancelled;
 
-  uv_mutex_lock(&mutex);
+  /* Not on a pool, e.g. because it runs on io_uring. The entry is only set
+   * and cleared on the loop thread, so it can be read without a lock.
+   */
+  e = w->wq[0];
+  if (e == NULL)
+    return UV_EBUSY;
+
+  pool = &pools[e->kind];
+  uv_mutex_lock(&pool->mutex);
   uv_mutex_lock(&w->loop->wq_mutex);
 
-  cancelled = !QUEUE_EMPTY(&w->wq) && w->work != NULL;
-  if (cancelled)
-    QUEUE_REMOVE(&w->wq);
+  cancelled = !QUEUE_EMPTY(&e->wq) && w->work != NULL;
+  if (cancelled) {
+    QUEUE_REMOVE(&e->wq);
+    pool->queued -= 1;
+  }
 
   uv_mutex_unlock(&w->loop->wq_mutex);
-  uv_mutex_unlock(&mutex);
+  uv_mutex_unlock(&pool->mutex);
 
   if (!cancelled)
     return UV_EBUSY;
 
   w->work = uv__cancelled;
   uv_mutex_lock(&loop->wq_mutex);
-  QUEUE_INSERT_TAIL(&loop->wq, &w->wq);
+  QUEUE_INSERT_TAIL(&loop->wq, &e->wq);
   uv_async_send(&loop->wq_async);
   uv_mutex_unlock(&loop->wq_mutex);
 
@@ -293,13 +363,19 @@ static int uv__work_cancel(uv_loop_t* loop, uv_req_t* req, struct uv__work* w) {
 
 
 void uv__work_done(uv_async_t* handle) {
+  uv__loop_internal_fields_t* lfields;
+  struct uv__work_entry* e;
   struct uv__work* w;
   uv_loop_t* loop;
+  unsigned int kind;
+  uint64_t wait_time;
+  uint64_t run_time;
   QUEUE* q;
   QUEUE wq;
   int err;
 
   loop = container_of(handle, uv_loop_t, wq_async);
+  lfields = uv__get_internal_fields(loop);
   uv_mutex_lock(&loop->wq_mutex);
   QUEUE_MOVE(&loop->wq, &wq);
   uv_mutex_unlock(&loop->wq_mutex);
@@ -308,8 +384,21 @@ void uv__work_done(uv_async_t* handle) {
     q = QUEUE_HEAD(&wq);
     QUEUE_REMOVE(q);
 
-    w = container_of(q, struct uv__work, wq);
+    e = container_of(q, struct uv__work_entry, wq);
+    w = e->w;
+    kind = e->kind;
+    wait_time = e->wait_time;
+    run_time = e->run_time;
+    w->wq[0] = NULL;
+    uv__free(e);
+
     err = (w->work == uv__cancelled) ? UV_ECANCELED : 0;
+    if (err == 0 && lfields->work_timing_cb != NULL)
+      lfields->work_timing_cb(loop,
+                              lfields->work_timing_arg,
+                              (uv_work_kind) kind,
+                              wait_time,
+                              run_time);
     w->done(w, err);
   }
 }
@@ -339,22 +428,59 @@ int uv_queue_work(uv_loop_t* loop,
                   uv_work_t* req,
                   uv_work_cb work_cb,
                   uv_after_work_cb after_work_cb) {
+  return uv_queue_work_kind(loop, req, UV_WORK_CPU, work_cb, after_work_cb);
+}
+
+
+int uv_queue_work_kind(uv_loop_t* loop,
+                       uv_work_t* req,
+                       uv_work_kind kind,
+                       uv_work_cb work_cb,
+                       uv_after_work_cb after_work_cb) {
   if (work_cb == NULL)
     return UV_EINVAL;
 
+  if (kind < UV_WORK_CPU || kind >= UV_WORK_KIND_MAX)
+    return UV_EINVAL;
+
   uv__req_init(loop, req, UV_WORK);
   req->loop = loop;
   req->work_cb = work_cb;
   req->after_work_cb = after_work_cb;
   uv__work_submit(loop,
                   &req->work_req,
-                  UV__WORK_CPU,
+                  (enum uv__work_kind) kind,
                   uv__queue_work,
                   uv__queue_done);
   return 0;
 }
 
 
+int uv_threadpool_stats(uv_work_kind kind, uv_threadpool_stats_t* stats) {
+  struct uv__threadpool* pool;
+
+  if (kind < UV_WORK_CPU || kind >= UV_WORK_KIND_MAX || stats == NULL)
+    return UV_EINVAL;
+
+  uv_once(&once, init_once);
+  pool = &pools[kind];
+  uv_mutex_lock(&pool->mutex);
+  stats->threads = pool->size;
+  stats->idle_threads = pool->idle_threads + pool->size - pool->nthreads;
+  stats->queued = pool->queued;
+  stats->max_queued = pool->max_queued;
+  stats->running = pool->running;
+  stats->submitted = pool->submitted;
+  stats->completed = pool->completed;
+  stats->wait_time = pool->wait_time;
+  stats->max_wait_time = pool->max_wait_time;
+  stats->run_time = pool->run_time;
+  uv_mutex_unlock(&pool->mutex);
+
+  return 0;
+}
+
+
 int uv_cancel(uv_req_t* req) {
   struct uv__work* wreq;
   uv_loop_t* loop;
@@ -382,3 +508,14 @@ int uv_cancel(uv_req_t* req) {
 
   return uv__work_cancel(loop, req, wreq);
 }
+
+
+void uv_loop_set_work_timing_cb(uv_loop_t* loop,
+                                uv_work_timing_cb cb,
+                                void* arg) {
+  uv__loop_internal_fields_t* lfields;
+
+  lfields = uv__get_internal_fields(loop);
+  lfields->work_timing_cb = cb;
+  lfields->work_timing_arg = arg;
+}
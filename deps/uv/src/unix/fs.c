@@ -71,6 +71,11 @@
 # include <utime.h>
 #endif
 
+/* Linux can run some requests on an io_uring instead of the threadpool. */
+#if !defined(__linux__)
+# define uv__iou_fs_submit(loop, req) 0
+#endif
+
 #if defined(_AIX) && _XOPEN_SOURCE <= 600
 extern char *mkdtemp(char *template); /* See issue #740 on AIX < 7 */
 #endif
@@ -128,6 +133,8 @@ extern char *mkdtemp(char *template); /* See issue #740 on AIX < 7 */
   do {                                                                        \
     if (cb != NULL) {                                                         \
       uv__req_register(loop, req);                                            \
+      if (uv__iou_fs_submit(loop, req))                                       \
+        return 0;                                                             \
       uv__work_submit(loop,                                                   \
                       &req->work_req,                                         \
                       UV__WORK_FAST_IO,                                       \
@@ -807,6 +814,10 @@ done:
   return r;
 }
 
+#ifdef __linux__
+static int no_copy_file_range_support;
+#endif
+
 static ssize_t uv__fs_copyfile(uv_fs_t* req) {
 #if defined(__APPLE__) && !TARGET_OS_IPHONE
   /* On macOS, use the native copyfile(3). */
@@ -898,20 +909,20 @@ static ssize_t uv__fs_copyfile(uv_fs_t* req) {
   }
 
 #ifdef FICLONE
+  /* Cloning is always tried first, it is by far the cheapest way to copy a
+     file. It's only an error when it was asked for. */
+  if (ioctl(dstfd, FICLONE, srcfd) == 0)
+    goto out;
+
   if (req->flags & UV_FS_COPYFILE_FICLONE ||
       req->flags & UV_FS_COPYFILE_FICLONE_FORCE) {
-    if (ioctl(dstfd, FICLONE, srcfd) == -1) {
-      /* If an error occurred that the sendfile fallback also won't handle, or
-         this is a force clone then exit. Otherwise, fall through to try using
-         sendfile(). */
-      if (errno != ENOTTY && errno != EOPNOTSUPP && errno != EXDEV) {
-        err = UV__ERR(errno);
-        goto out;
-      } else if (req->flags & UV_FS_COPYFILE_FICLONE_FORCE) {
-        err = UV_ENOTSUP;
-        goto out;
-      }
-    } else {
+    /* If an error occurred that the fallbacks also won't handle, or this is
+       a force clone then exit. Otherwise, fall through to try copying. */
+    if (errno != ENOTTY && errno != EOPNOTSUPP && errno != EXDEV) {
+      err = UV__ERR(errno);
+      goto out;
+    } else if (req->flags & UV_FS_COPYFILE_FICLONE_FORCE) {
+      err = UV_ENOTSUP;
       goto out;
     }
   }
@@ -924,6 +935,50 @@ static ssize_t uv__fs_copyfile(uv_fs_t* req) {
 
   bytes_to_send = statsbuf.st_size;
   in_offset = 0;
+
+#ifdef __linux__
+  /* copy_file_range() copies in the kernel, and lets the file system share
+     extents or do a server-side copy. It fails with EXDEV across file systems
+     before Linux 5.3 and with EINVAL or EOPNOTSUPP for some file systems, the
+     sendfile() loop takes over in that case. */
+  while (bytes_to_send != 0 && !no_copy_file_range_support) {
+    ssize_t r;
+
+    r = uv__copy_file_range(srcfd, &in_offset, dstfd, NULL, bytes_to_send, 0);
+    if (r == -1) {
+      if (errno == EINTR)
+        continue;
+
+      if (errno == ENOSYS) {
+        no_copy_file_range_support = 1;
+        break;
+      }
+
+      if (errno == EXDEV ||
+          errno == EINVAL ||
+          errno == EOPNOTSUPP ||
+          errno == ETXTBSY ||
+          errno == EBADF) {
+        break;
+      }
+
+      err = UV__ERR(errno);
+      goto out;
+    }
+
+    /* Files in e.g. procfs report a size but copy_file_range() doesn't
+       copy anything from them, let sendfile() try. Otherwise the file shrank
+       and there is nothing left to copy. */
+    if (r == 0) {
+      if (in_offset != 0)
+        bytes_to_send = 0;
+      break;
+    }
+
+    bytes_to_send -= r;
+  }
+#endif
+
   while (bytes_to_send != 0) {
     err = uv_fs_sendfile(NULL,
                          &fs_req,
@@ -935,6 +990,8 @@ static ssize_t uv__fs_copyfile(uv_fs_t* req) {
     uv_fs_req_cleanup(&fs_req);
     if (err < 0)
       break;
+    if (fs_req.result == 0)
+      break;  /* The file shrank. */
     bytes_to_send -= fs_req.result;
     in_offset += fs_req.result;
   }
@@ -1053,6 +1110,30 @@ static void uv__to_stat(struct stat* src, uv_stat_t* dst) {
 }
 
 
+#ifdef __linux__
+void uv__statx_to_stat(const struct uv__statx* statxbuf, uv_stat_t* buf) {
+  buf->st_dev = 256 * statxbuf->stx_dev_major + statxbuf->stx_dev_minor;
+  buf->st_mode = statxbuf->stx_mode;
+  buf->st_nlink = statxbuf->stx_nlink;
+  buf->st_uid = statxbuf->stx_uid;
+  buf->st_gid = statxbuf->stx_gid;
+  buf->st_rdev = statxbuf->stx_rdev_major;
+  buf->st_ino = statxbuf->stx_ino;
+  buf->st_size = statxbuf->stx_size;
+  buf->st_blksize = statxbuf->stx_blksize;
+  buf->st_blocks = statxbuf->stx_blocks;
+  buf->st_atim.tv_sec = statxbuf->stx_atime.tv_sec;
+  buf->st_atim.tv_nsec = statxbuf->stx_atime.tv_nsec;
+  buf->st_mtim.tv_sec = statxbuf->stx_mtime.tv_sec;
+  buf->st_mtim.tv_nsec = statxbuf->stx_mtime.tv_nsec;
+  buf->st_ctim.tv_sec = statxbuf->stx_ctime.tv_sec;
+  buf->st_ctim.tv_nsec = statxbuf->stx_ctime.tv_nsec;
+  buf->st_birthtim.tv_sec = statxbuf->stx_btime.tv_sec;
+  buf->st_birthtim.tv_nsec = statxbuf->stx_btime.tv_nsec;
+}
+#endif /* __linux__ */
+
+
 static int uv__fs_statx(int fd,
                         const char* path,
                         int is_fstat,
@@ -1095,25 +1176,7 @@ static int uv__fs_statx(int fd,
     return UV_ENOSYS;
   }
 
-  buf->st_dev = 256 * statxbuf.stx_dev_major + statxbuf.stx_dev_minor;
-  buf->st_mode = statxbuf.stx_mode;
-  buf->st_nlink = statxbuf.stx_nlink;
-  buf->st_uid = statxbuf.stx_uid;
-  buf->st_gid = statxbuf.stx_gid;
-  buf->st_rdev = statxbuf.stx_rdev_major;
-  buf->st_ino = statxbuf.stx_ino;
-  buf->st_size = statxbuf.stx_size;
-  buf->st_blksize = statxbuf.stx_blksize;
-  buf->st_blocks = statxbuf.stx_blocks;
-  buf->st_atim.tv_sec = statxbuf.stx_atime.tv_sec;
-  buf->st_atim.tv_nsec = statxbuf.stx_atime.tv_nsec;
-  buf->st_mtim.tv_sec = statxbuf.stx_mtime.tv_sec;
-  buf->st_mtim.tv_nsec = statxbuf.stx_mtime.tv_nsec;
-  buf->st_ctim.tv_sec = statxbuf.stx_ctime.tv_sec;
-  buf->st_ctim.tv_nsec = statxbuf.stx_ctime.tv_nsec;
-  buf->st_birthtim.tv_sec = statxbuf.stx_btime.tv_sec;
-  buf->st_birthtim.tv_nsec = statxbuf.stx_btime.tv_nsec;
-
+  uv__statx_to_stat(&statxbuf, buf);
   return 0;
 #else
   return UV_ENOSYS;
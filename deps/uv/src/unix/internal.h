@@ -303,6 +303,12 @@ UV_UNUSED(static char* uv__basename_r(const char* path)) {
 
 #if defined(__linux__)
 int uv__inotify_fork(uv_loop_t* loop, void* old_watchers);
+
+/* io_uring support, see linux-iouring.c. */
+int uv__iou_fs_submit(uv_loop_t* loop, uv_fs_t* req);
+void uv__iou_flush(uv_loop_t* loop);
+void uv__iou_delete(uv_loop_t* loop);
+void uv__statx_to_stat(const struct uv__statx* statxbuf, uv_stat_t* buf);
 #endif
 
 typedef int (*uv__peersockfunc)(int, struct sockaddr*, socklen_t*);
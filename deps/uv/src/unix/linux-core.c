@@ -100,6 +100,7 @@ int uv__platform_loop_init(uv_loop_t* loop) {
   loop->backend_fd = fd;
   loop->inotify_fd = -1;
   loop->inotify_watchers = NULL;
+  uv__get_internal_fields(loop)->io_uring = NULL;
 
   if (fd == -1)
     return UV__ERR(errno);
@@ -127,6 +128,8 @@ int uv__io_fork(uv_loop_t* loop) {
 
 
 void uv__platform_loop_delete(uv_loop_t* loop) {
+  uv__iou_delete(loop);
+
   if (loop->inotify_fd == -1) return;
   uv__io_stop(loop, &loop->inotify_read_watcher, POLLIN);
   uv__close(loop->inotify_fd);
@@ -215,6 +218,11 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   int op;
   int i;
 
+  /* Submit the requests that were queued on the io_uring since the last time
+   * the loop polled for I/O.
+   */
+  uv__iou_flush(loop);
+
   if (loop->nfds == 0) {
     assert(QUEUE_EMPTY(&loop->watcher_queue));
     return;
@@ -0,0 +1,547 @@
+/* Copyright libuv contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* Asynchronous filesystem requests of the most common types are submitted to
+ * an io_uring instead of the threadpool. This saves the handoff to a thread
+ * and the wakeup of the event loop for every request, and the number of
+ * requests in flight is not limited by the size of the threadpool.
+ *
+ * The ring is created lazily, on the first request that can use it. Requests
+ * are queued in the submission queue and submitted with a single
+ * io_uring_enter() call before the event loop blocks for I/O. Completions are
+ * reaped when the ring's file descriptor becomes readable.
+ *
+ * Writes are always complete, like on the threadpool: the rest of a short
+ * write, e.g. to a pipe, is queued again until everything is written.
+ *
+ * Requests fall back to the threadpool when the kernel is older than
+ * 5.10.186, which has known io_uring bugs, when UV_USE_IO_URING=0 is set in
+ * the environment, when the ring can't be created, for example because a
+ * seccomp filter rejects io_uring_setup(), and when the ring is full. Closes
+ * stay on the threadpool before 5.15.90, where IORING_OP_CLOSE can make a
+ * later execve() of the file fail with ETXTBSY.
+ */
+
+#include "uv.h"
+#include "internal.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/utsname.h>
+
+#define UV__IOU_ENTRIES 256
+
+#ifndef AT_EMPTY_PATH
+# define AT_EMPTY_PATH 0x1000
+#endif
+
+struct uv__iou {
+  int ringfd;  /* -1 if io_uring can't be used with this loop. */
+  uv__io_t watcher;
+  uint32_t* sqtail;
+  uint32_t* sqflags;
+  uint32_t sqmask;
+  uint32_t sqentries;
+  uint32_t* cqhead;
+  uint32_t* cqtail;
+  uint32_t cqmask;
+  uint32_t cqentries;
+  struct uv__io_uring_sqe* sqe;
+  struct uv__io_uring_cqe* cqe;
+  void* ring;
+  size_t ringlen;
+  size_t sqelen;
+  uint32_t unsubmitted;  /* Queued but not yet passed to io_uring_enter(). */
+  uint32_t in_flight;    /* Queued or submitted, not yet completed. */
+};
+
+static uv_once_t once = UV_ONCE_INIT;
+static int uv__iou_supported;
+static int uv__iou_close_supported;
+
+
+static void uv__iou_check(void) {
+  struct utsname u;
+  const char* val;
+  unsigned int major;
+  unsigned int minor;
+  unsigned int patch;
+  unsigned int version;
+
+  val = getenv("UV_USE_IO_URING");
+  if (val != NULL && atoi(val) == 0)
+    return;
+
+  if (uname(&u))
+    return;
+
+  patch = 0;
+  if (sscanf(u.release, "%u.%u.%u", &major, &minor, &patch) < 2)
+    return;
+
+  if (minor > 255)
+    minor = 255;
+  if (patch > 255)
+    patch = 255;
+  version = major << 16 | minor << 8 | patch;
+
+  uv__iou_supported = version >= 0x050ABA;  /* 5.10.186 */
+  uv__iou_close_supported = version >= 0x050F5A;  /* 5.15.90 */
+}
+
+
+static void uv__iou_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
+
+
+static int uv__iou_init(struct uv__iou* iou) {
+  struct uv__io_uring_params params;
+  uint32_t required;
+  uint32_t* sqarray;
+  size_t sqlen;
+  size_t cqlen;
+  char* ring;
+  void* sqe;
+  uint32_t i;
+  int ringfd;
+
+  memset(&params, 0, sizeof(params));
+  ringfd = uv__io_uring_setup(UV__IOU_ENTRIES, &params);
+  if (ringfd == -1)
+    return UV__ERR(errno);
+
+  required = UV__IORING_FEAT_SINGLE_MMAP |
+             UV__IORING_FEAT_NODROP |
+             UV__IORING_FEAT_RW_CUR_POS;
+  if ((params.features & required) != required) {
+    uv__close(ringfd);
+    return UV_ENOSYS;
+  }
+
+  sqlen = params.sq_off.array + params.sq_entries * sizeof(*sqarray);
+  cqlen = params.cq_off.cqes + params.cq_entries * sizeof(*iou->cqe);
+  iou->ringlen = sqlen > cqlen ? sqlen : cqlen;
+  iou->sqelen = params.sq_entries * sizeof(*iou->sqe);
+
+  ring = mmap(NULL,
+              iou->ringlen,
+              PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_POPULATE,
+              ringfd,
+              UV__IORING_OFF_SQ_RING);
+  if (ring == MAP_FAILED) {
+    uv__close(ringfd);
+    return UV_ENOMEM;
+  }
+
+  sqe = mmap(NULL,
+             iou->sqelen,
+             PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE,
+             ringfd,
+             UV__IORING_OFF_SQES);
+  if (sqe == MAP_FAILED) {
+    munmap(ring, iou->ringlen);
+    uv__close(ringfd);
+    return UV_ENOMEM;
+  }
+
+  iou->ring = ring;
+  iou->sqe = sqe;
+  iou->sqtail = (uint32_t*) (ring + params.sq_off.tail);
+  iou->sqflags = (uint32_t*) (ring + params.sq_off.flags);
+  iou->sqmask = *(uint32_t*) (ring + params.sq_off.ring_mask);
+  iou->sqentries = params.sq_entries;
+  iou->cqhead = (uint32_t*) (ring + params.cq_off.head);
+  iou->cqtail = (uint32_t*) (ring + params.cq_off.tail);
+  iou->cqmask = *(uint32_t*) (ring + params.cq_off.ring_mask);
+  iou->cqentries = params.cq_entries;
+  iou->cqe = (struct uv__io_uring_cqe*) (ring + params.cq_off.cqes);
+
+  /* Entries in the submission queue map 1:1 to SQEs. */
+  sqarray = (uint32_t*) (ring + params.sq_off.array);
+  for (i = 0; i < params.sq_entries; i++)
+    sqarray[i] = i;
+
+  iou->ringfd = ringfd;
+  return 0;
+}
+
+
+static struct uv__iou* uv__iou_get(uv_loop_t* loop) {
+  struct uv__iou* iou;
+
+  iou = uv__get_internal_fields(loop)->io_uring;
+  if (iou != NULL)
+    return iou->ringfd == -1 ? NULL : iou;
+
+  uv_once(&once, uv__iou_check);
+
+  iou = uv__malloc(sizeof(*iou));
+  if (iou == NULL)
+    return NULL;
+
+  memset(iou, 0, sizeof(*iou));
+  iou->ringfd = -1;
+  uv__get_internal_fields(loop)->io_uring = iou;
+
+  /* Don't retry on failure, keep using the threadpool for this loop. */
+  if (!uv__iou_supported || uv__iou_init(iou))
+    return NULL;
+
+  uv__io_init(&iou->watcher, uv__iou_io, iou->ringfd);
+  uv__io_start(loop, &iou->watcher, POLLIN);
+
+  return iou;
+}
+
+
+void uv__iou_delete(uv_loop_t* loop) {
+  struct uv__iou* iou;
+
+  iou = uv__get_internal_fields(loop)->io_uring;
+  if (iou == NULL)
+    return;
+
+  if (iou->ringfd != -1) {
+    uv__io_stop(loop, &iou->watcher, POLLIN);
+    munmap(iou->sqe, iou->sqelen);
+    munmap(iou->ring, iou->ringlen);
+    uv__close(iou->ringfd);
+  }
+
+  uv__free(iou);
+  uv__get_internal_fields(loop)->io_uring = NULL;
+}
+
+
+void uv__iou_flush(uv_loop_t* loop) {
+  struct uv__iou* iou;
+  int rc;
+
+  iou = uv__get_internal_fields(loop)->io_uring;
+  if (iou == NULL || iou->unsubmitted == 0)
+    return;
+
+  do
+    rc = uv__io_uring_enter(iou->ringfd, iou->unsubmitted, 0, 0);
+  while (rc == -1 && errno == EINTR);
+
+  if (rc == -1) {
+    /* Out of kernel resources. The requests stay queued and are submitted
+     * with the next batch.
+     */
+    if (errno == EAGAIN || errno == EBUSY)
+      return;
+    abort();
+  }
+
+  assert((uint32_t) rc <= iou->unsubmitted);
+  iou->unsubmitted -= rc;
+}
+
+
+/* Whether another request can be queued without overflowing either queue. */
+static int uv__iou_has_room(uv_loop_t* loop, struct uv__iou* iou) {
+  /* The completion queue must not overflow. */
+  if (iou->in_flight == iou->cqentries)
+    return 0;
+
+  if (iou->unsubmitted == iou->sqentries) {
+    uv__iou_flush(loop);
+    if (iou->unsubmitted == iou->sqentries)
+      return 0;
+  }
+
+  return 1;
+}
+
+
+static struct uv__io_uring_sqe* uv__iou_get_sqe(struct uv__iou* iou,
+                                                uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+
+  sqe = &iou->sqe[*iou->sqtail & iou->sqmask];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->user_data = (uintptr_t) req;
+  return sqe;
+}
+
+
+static void uv__iou_queue_sqe(struct uv__iou* iou) {
+  __atomic_store_n(iou->sqtail, *iou->sqtail + 1, __ATOMIC_RELEASE);
+  iou->unsubmitted++;
+  iou->in_flight++;
+}
+
+
+static void uv__iou_prep_rw(struct uv__io_uring_sqe* sqe, uv_fs_t* req) {
+  sqe->opcode = req->fs_type == UV_FS_READ ? UV__IORING_OP_READV
+                                            : UV__IORING_OP_WRITEV;
+  sqe->fd = req->file;
+  sqe->addr = (uintptr_t) req->bufs;
+  sqe->len = req->nbufs;
+  /* -1 reads from or writes to the current file position. */
+  sqe->off = req->off < 0 ? (uint64_t) -1 : (uint64_t) req->off;
+}
+
+
+int uv__iou_fs_submit(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__statx* statxbuf;
+  struct uv__iou* iou;
+
+  switch (req->fs_type) {
+    case UV_FS_READ:
+    case UV_FS_WRITE:
+      if (req->nbufs > (unsigned int) uv__getiovmax())
+        return 0;
+      break;
+    case UV_FS_CLOSE:
+    case UV_FS_FDATASYNC:
+    case UV_FS_FSTAT:
+    case UV_FS_FSYNC:
+    case UV_FS_LSTAT:
+    case UV_FS_OPEN:
+    case UV_FS_STAT:
+      break;
+    default:
+      return 0;
+  }
+
+  iou = uv__iou_get(loop);
+  if (iou == NULL)
+    return 0;
+
+  if (req->fs_type == UV_FS_CLOSE && !uv__iou_close_supported)
+    return 0;
+
+  if (!uv__iou_has_room(loop, iou))
+    return 0;
+
+  statxbuf = NULL;
+  if (req->fs_type == UV_FS_FSTAT ||
+      req->fs_type == UV_FS_LSTAT ||
+      req->fs_type == UV_FS_STAT) {
+    statxbuf = uv__malloc(sizeof(*statxbuf));
+    if (statxbuf == NULL)
+      return 0;
+    req->ptr = statxbuf;
+  }
+
+  sqe = uv__iou_get_sqe(iou, req);
+
+  switch (req->fs_type) {
+    case UV_FS_CLOSE:
+      sqe->opcode = UV__IORING_OP_CLOSE;
+      sqe->fd = req->file;
+      break;
+    case UV_FS_FDATASYNC:
+    case UV_FS_FSYNC:
+      sqe->opcode = UV__IORING_OP_FSYNC;
+      sqe->fd = req->file;
+      if (req->fs_type == UV_FS_FDATASYNC)
+        sqe->op_flags = UV__IORING_FSYNC_DATASYNC;
+      break;
+    case UV_FS_OPEN:
+      sqe->opcode = UV__IORING_OP_OPENAT;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = (uintptr_t) req->path;
+      sqe->len = req->mode;
+      sqe->op_flags = req->flags | O_CLOEXEC;
+      break;
+    case UV_FS_READ:
+    case UV_FS_WRITE:
+      uv__iou_prep_rw(sqe, req);
+      /* Counts the bytes of a write that were written by earlier parts. */
+      req->result = 0;
+      break;
+    default:
+      sqe->opcode = UV__IORING_OP_STATX;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = (uintptr_t) req->path;
+      sqe->len = 0xFFF;  /* STATX_BASIC_STATS + STATX_BTIME */
+      sqe->off = (uintptr_t) statxbuf;
+      if (req->fs_type == UV_FS_FSTAT) {
+        sqe->fd = req->file;
+        sqe->addr = (uintptr_t) "";
+        sqe->op_flags = AT_EMPTY_PATH;
+      } else if (req->fs_type == UV_FS_LSTAT) {
+        sqe->op_flags = AT_SYMLINK_NOFOLLOW;
+      }
+      break;
+  }
+
+  uv__iou_queue_sqe(iou);
+
+  /* The request is not on the threadpool's queue, make uv_cancel() fail
+   * with UV_EBUSY like it does for requests that are being executed.
+   */
+  req->work_req.loop = loop;
+  req->work_req.work = NULL;
+  req->work_req.wq[0] = NULL;
+
+  return 1;
+}
+
+
+/* Queues the rest of a short write, like uv__fs_write_all() loops on the
+ * threadpool. Returns 1 if it did, or 0 with the final result of the request
+ * in `*result`.
+ */
+static int uv__iou_fs_write_more(uv_loop_t* loop,
+                                 struct uv__iou* iou,
+                                 uv_fs_t* req,
+                                 ssize_t* result) {
+  struct uv__io_uring_sqe* sqe;
+  unsigned int n;
+  size_t size;
+
+  if (*result <= 0) {
+    /* Report what was written before the error. */
+    if (req->result > 0)
+      *result = req->result;
+    return 0;
+  }
+
+  req->result += *result;
+  if (req->off >= 0)
+    req->off += *result;
+
+  /* Drop the buffers that were written in full, and the written part of the
+   * first one that wasn't. The array is shifted rather than advanced, so that
+   * uv__iou_fs_done() can still free it.
+   */
+  size = *result;
+  for (n = 0; n < req->nbufs && req->bufs[n].len <= size; n++)
+    size -= req->bufs[n].len;
+  if (n < req->nbufs) {
+    req->bufs[n].base += size;
+    req->bufs[n].len -= size;
+  }
+  req->nbufs -= n;
+  memmove(req->bufs, req->bufs + n, req->nbufs * sizeof(*req->bufs));
+
+  *result = req->result;
+  if (req->nbufs == 0 || !uv__iou_has_room(loop, iou))
+    return 0;
+
+  sqe = uv__iou_get_sqe(iou, req);
+  uv__iou_prep_rw(sqe, req);
+  uv__iou_queue_sqe(iou);
+  return 1;
+}
+
+
+static void uv__iou_fs_done(uv_fs_t* req, ssize_t result) {
+  struct uv__statx* statxbuf;
+
+  req->result = result;
+
+  switch (req->fs_type) {
+    case UV_FS_READ:
+    case UV_FS_WRITE:
+      if (req->bufs != req->bufsml)
+        uv__free(req->bufs);
+      req->bufs = NULL;
+      req->nbufs = 0;
+      break;
+    case UV_FS_FSTAT:
+    case UV_FS_LSTAT:
+    case UV_FS_STAT:
+      statxbuf = req->ptr;
+      req->ptr = NULL;
+      if (result == 0) {
+        uv__statx_to_stat(statxbuf, &req->statbuf);
+        req->ptr = &req->statbuf;
+      }
+      uv__free(statxbuf);
+      break;
+    default:
+      break;
+  }
+
+  uv__req_unregister(req->loop, req);
+  req->cb(req);
+}
+
+
+static void uv__iou_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
+  struct uv__io_uring_cqe* cqe;
+  struct uv__iou* iou;
+  uv_fs_t* req;
+  uint32_t head;
+  uint32_t tail;
+  ssize_t result;
+  int rc;
+
+  iou = container_of(w, struct uv__iou, watcher);
+
+  for (;;) {
+    head = *iou->cqhead;
+    tail = __atomic_load_n(iou->cqtail, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+      /* Completions that didn't fit into the completion queue are kept by the
+       * kernel until they are flushed to it. Shouldn't happen because
+       * in_flight is bounded by the size of the completion queue.
+       */
+      if (!(__atomic_load_n(iou->sqflags, __ATOMIC_ACQUIRE) &
+            UV__IORING_SQ_CQ_OVERFLOW)) {
+        break;
+      }
+
+      do
+        rc = uv__io_uring_enter(iou->ringfd, 0, 0, UV__IORING_ENTER_GETEVENTS);
+      while (rc == -1 && errno == EINTR);
+
+      if (rc == -1)
+        abort();
+
+      continue;
+    }
+
+    for (; head != tail; head++) {
+      cqe = &iou->cqe[head & iou->cqmask];
+      req = (uv_fs_t*) (uintptr_t) cqe->user_data;
+      result = cqe->res;
+
+      /* Hand the entry back to the kernel before running the callback, which
+       * can submit new requests.
+       */
+      __atomic_store_n(iou->cqhead, head + 1, __ATOMIC_RELEASE);
+      assert(iou->in_flight > 0);
+      iou->in_flight--;
+
+      if (req->fs_type == UV_FS_WRITE &&
+          uv__iou_fs_write_more(loop, iou, req, &result)) {
+        continue;
+      }
+
+      uv__iou_fs_done(req, result);
+    }
+  }
+}
@@ -203,6 +203,43 @@
 # endif
 #endif /* __NR_statx */
 
+#ifndef __NR_copy_file_range
+# if defined(__x86_64__)
+#  define __NR_copy_file_range 326
+# elif defined(__i386__)
+#  define __NR_copy_file_range 377
+# elif defined(__aarch64__)
+#  define __NR_copy_file_range 285
+# elif defined(__arm__)
+#  define __NR_copy_file_range (UV_SYSCALL_BASE + 391)
+# elif defined(__ppc__)
+#  define __NR_copy_file_range 379
+# elif defined(__s390__)
+#  define __NR_copy_file_range 375
+# endif
+#endif /* __NR_copy_file_range */
+
+/* The io_uring system calls have the same number on all architectures that
+ * use the generic system call table, and on the older ones listed here.
+ */
+#ifndef __NR_io_uring_setup
+# if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__) || \
+     defined(__ppc__) || defined(__s390__)
+#  define __NR_io_uring_setup 425
+# elif defined(__arm__)
+#  define __NR_io_uring_setup (UV_SYSCALL_BASE + 425)
+# endif
+#endif /* __NR_io_uring_setup */
+
+#ifndef __NR_io_uring_enter
+# if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__) || \
+     defined(__ppc__) || defined(__s390__)
+#  define __NR_io_uring_enter 426
+# elif defined(__arm__)
+#  define __NR_io_uring_enter (UV_SYSCALL_BASE + 426)
+# endif
+#endif /* __NR_io_uring_enter */
+
 int uv__accept4(int fd, struct sockaddr* addr, socklen_t* addrlen, int flags) {
 #if defined(__i386__)
   unsigned long args[4];
@@ -364,3 +401,52 @@ int uv__statx(int dirfd,
   return errno = ENOSYS, -1;
 #endif
 }
+
+
+ssize_t uv__copy_file_range(int fd_in,
+                            int64_t* off_in,
+                            int fd_out,
+                            int64_t* off_out,
+                            size_t len,
+                            unsigned int flags) {
+#if defined(__NR_copy_file_range)
+  return syscall(__NR_copy_file_range,
+                 fd_in,
+                 off_in,
+                 fd_out,
+                 off_out,
+                 len,
+                 flags);
+#else
+  return errno = ENOSYS, -1;
+#endif
+}
+
+
+int uv__io_uring_setup(unsigned int entries,
+                       struct uv__io_uring_params* params) {
+#if defined(__NR_io_uring_setup)
+  return syscall(__NR_io_uring_setup, entries, params);
+#else
+  return errno = ENOSYS, -1;
+#endif
+}
+
+
+int uv__io_uring_enter(int fd,
+                       unsigned int to_submit,
+                       unsigned int min_complete,
+                       unsigned int flags) {
+#if defined(__NR_io_uring_enter)
+  /* io_uring_enter() used to take a sigset_t but it's unused in libuv. */
+  return syscall(__NR_io_uring_enter,
+                 fd,
+                 to_submit,
+                 min_complete,
+                 flags,
+                 NULL,
+                 0L);
+#else
+  return errno = ENOSYS, -1;
+#endif
+}
@@ -110,6 +110,80 @@ struct uv__statx {
   uint64_t unused1[14];
 };
 
+#define UV__IORING_OP_READV     1
+#define UV__IORING_OP_WRITEV    2
+#define UV__IORING_OP_FSYNC     3
+#define UV__IORING_OP_OPENAT    18
+#define UV__IORING_OP_CLOSE     19
+#define UV__IORING_OP_STATX     21
+
+#define UV__IORING_FSYNC_DATASYNC   1u
+
+#define UV__IORING_ENTER_GETEVENTS  1u
+
+#define UV__IORING_SQ_CQ_OVERFLOW   2u
+
+#define UV__IORING_FEAT_SINGLE_MMAP 1u
+#define UV__IORING_FEAT_NODROP      2u
+#define UV__IORING_FEAT_RW_CUR_POS  8u
+
+#define UV__IORING_OFF_SQ_RING      0x00000000
+#define UV__IORING_OFF_SQES         0x10000000
+
+struct uv__io_uring_sqe {
+  uint8_t opcode;
+  uint8_t flags;
+  uint16_t ioprio;
+  int32_t fd;
+  uint64_t off;  /* Also the second address for some operations. */
+  uint64_t addr;
+  uint32_t len;
+  uint32_t op_flags;  /* rw_flags, fsync_flags, open_flags, statx_flags... */
+  uint64_t user_data;
+  uint64_t unused0[3];
+};
+
+struct uv__io_uring_cqe {
+  uint64_t user_data;
+  int32_t res;
+  uint32_t flags;
+};
+
+struct uv__io_sqring_offsets {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t ring_mask;
+  uint32_t ring_entries;
+  uint32_t flags;
+  uint32_t dropped;
+  uint32_t array;
+  uint32_t reserved0;
+  uint64_t reserved1;
+};
+
+struct uv__io_cqring_offsets {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t ring_mask;
+  uint32_t ring_entries;
+  uint32_t overflow;
+  uint32_t cqes;
+  uint64_t reserved0;
+  uint64_t reserved1;
+};
+
+struct uv__io_uring_params {
+  uint32_t sq_entries;
+  uint32_t cq_entries;
+  uint32_t flags;
+  uint32_t sq_thread_cpu;
+  uint32_t sq_thread_idle;
+  uint32_t features;
+  uint32_t reserved[4];
+  struct uv__io_sqring_offsets sq_off;
+  struct uv__io_cqring_offsets cq_off;
+};
+
 struct uv__inotify_event {
   int32_t wd;
   uint32_t mask;
@@ -148,5 +222,17 @@ int uv__statx(int dirfd,
               int flags,
               unsigned int mask,
               struct uv__statx* statxbuf);
+ssize_t uv__copy_file_range(int fd_in,
+                            int64_t* off_in,
+                            int fd_out,
+                            int64_t* off_out,
+                            size_t len,
+                            unsigned int flags);
+int uv__io_uring_setup(unsigned int entries,
+                       struct uv__io_uring_params* params);
+int uv__io_uring_enter(int fd,
+                       unsigned int to_submit,
+                       unsigned int min_complete,
+                       unsigned int flags);
 
 #endif /* UV_LINUX_SYSCALL_H_ */
@@ -39,6 +39,24 @@
 # define IPV6_DROP_MEMBERSHIP IPV6_LEAVE_GROUP
 #endif
 
+#if defined(__linux__)
+# define HAVE_MMSG 1
+#endif
+
+#define UV__UDP_DGRAM_MAXSIZE (64 * 1024)
+#define UV__MMSG_MAXWIDTH 64
+
+#if HAVE_MMSG
+# include <netinet/udp.h>
+# ifndef UDP_SEGMENT
+#  define UDP_SEGMENT 103
+# endif
+/* Kernel limit on the number of segments in one UDP_SEGMENT send. */
+# define UV__UDP_MAX_SEGMENTS 64
+/* Largest IPv4 UDP payload, the GSO super-datagram must not exceed it. */
+# define UV__UDP_MAX_PAYLOAD 65507
+#endif
+
 
 static void uv__udp_run_completed(uv_udp_t* handle);
 static void uv__udp_io(uv_loop_t* loop, uv__io_t* w, unsigned int revents);
@@ -148,6 +166,75 @@ static void uv__udp_io(uv_loop_t* loop, uv__io_t* w, unsigned int revents) {
 }
 
 
+#if HAVE_MMSG
+static ssize_t uv__udp_recvmmsg(uv_udp_t* handle, uv_buf_t* buf) {
+  struct sockaddr_storage peers[UV__MMSG_MAXWIDTH];
+  struct iovec iov[UV__MMSG_MAXWIDTH];
+  struct uv__mmsghdr msgs[UV__MMSG_MAXWIDTH];
+  uv_udp_recv_cb recv_cb;
+  uv_buf_t chunk_buf;
+  ssize_t nread;
+  size_t chunks;
+  size_t k;
+  int flags;
+
+  /* Carve the buffer into datagram sized chunks, one per message. */
+  chunks = buf->len / UV__UDP_DGRAM_MAXSIZE;
+  if (chunks > ARRAY_SIZE(iov))
+    chunks = ARRAY_SIZE(iov);
+
+  for (k = 0; k < chunks; k++) {
+    iov[k].iov_base = buf->base + k * UV__UDP_DGRAM_MAXSIZE;
+    iov[k].iov_len = UV__UDP_DGRAM_MAXSIZE;
+    memset(&msgs[k].msg_hdr, 0, sizeof(msgs[k].msg_hdr));
+    msgs[k].msg_hdr.msg_iov = iov + k;
+    msgs[k].msg_hdr.msg_iovlen = 1;
+    msgs[k].msg_hdr.msg_name = peers + k;
+    msgs[k].msg_hdr.msg_namelen = sizeof(peers[0]);
+  }
+
+  do
+    nread = uv__recvmmsg(handle->io_watcher.fd, msgs, chunks, 0, NULL);
+  while (nread == -1 && errno == EINTR);
+
+  if (nread == -1 && errno == ENOSYS)
+    return nread;
+
+  if (nread < 1) {
+    if (nread == 0 || errno == EAGAIN || errno == EWOULDBLOCK)
+      handle->recv_cb(handle, 0, buf, NULL, 0);
+    else
+      handle->recv_cb(handle, UV__ERR(errno), buf, NULL, 0);
+    return nread;
+  }
+
+  /* recv_cb may stop or close the handle, remember it so the buffer can still
+   * be handed back afterwards.
+   */
+  recv_cb = handle->recv_cb;
+
+  for (k = 0; k < (size_t) nread && handle->recv_cb != NULL; k++) {
+    flags = UV_UDP_MMSG_CHUNK;
+    if (msgs[k].msg_hdr.msg_flags & MSG_TRUNC)
+      flags |= UV_UDP_PARTIAL;
+
+    chunk_buf = uv_buf_init(iov[k].iov_base, msgs[k].msg_len);
+    handle->recv_cb(handle,
+                    msgs[k].msg_len,
+                    &chunk_buf,
+                    msgs[k].msg_hdr.msg_namelen == 0 ?
+                      NULL : (const struct sockaddr*) (peers + k),
+                    flags);
+  }
+
+  /* One last callback so the original buffer is freed. */
+  recv_cb(handle, 0, buf, NULL, UV_UDP_MMSG_FREE);
+
+  return nread;
+}
+#endif
+
+
 static void uv__udp_recvmsg(uv_udp_t* handle) {
   struct sockaddr_storage peer;
   struct msghdr h;
@@ -176,6 +263,22 @@ static void uv__udp_recvmsg(uv_udp_t* handle) {
     }
     assert(buf.base != NULL);
 
+#if HAVE_MMSG
+    if ((handle->flags & UV_HANDLE_UDP_RECVMMSG) &&
+        buf.len >= 2 * UV__UDP_DGRAM_MAXSIZE) {
+      nread = uv__udp_recvmmsg(handle, &buf);
+      if (nread > 0) {
+        count -= nread;
+        continue;
+      }
+      if (nread == -1 && errno == ENOSYS)
+        /* Old kernel, use recvmsg() from now on. */
+        handle->flags &= ~UV_HANDLE_UDP_RECVMMSG;
+      else
+        return;
+    }
+#endif
+
     h.msg_namelen = sizeof(peer);
     h.msg_iov = (void*) &buf;
     h.msg_iovlen = 1;
@@ -542,6 +645,224 @@ int uv__udp_try_send(uv_udp_t* handle,
 }
 
 
+static unsigned int uv__udp_addrlen(const struct sockaddr* addr) {
+  if (addr == NULL)
+    return 0;
+  if (addr->sa_family == AF_INET6)
+    return sizeof(struct sockaddr_in6);
+  return sizeof(struct sockaddr_in);
+}
+
+
+static int uv__udp_try_send_each(uv_udp_t* handle,
+                                 unsigned int count,
+                                 uv_buf_t* bufs[],
+                                 unsigned int nbufs[],
+                                 struct sockaddr* addrs[]) {
+  unsigned int i;
+  int err;
+
+  for (i = 0; i < count; i++) {
+    err = uv__udp_try_send(handle,
+                           bufs[i],
+                           nbufs[i],
+                           addrs[i],
+                           uv__udp_addrlen(addrs[i]));
+    if (err < 0)
+      return i > 0 ? (int) i : err;
+  }
+
+  return count;
+}
+
+
+#if HAVE_MMSG
+/* Sends all datagrams with a single sendmsg() and a UDP_SEGMENT control
+ * message, letting the kernel (or the NIC) split the payload. Returns
+ * UV_ENOTSUP when the batch is not eligible or the kernel lacks support.
+ */
+static int uv__udp_try_send_gso(uv_udp_t* handle,
+                                unsigned int count,
+                                uv_buf_t* bufs[],
+                                unsigned int nbufs[],
+                                struct sockaddr* addrs[]) {
+  union {
+    char buf[CMSG_SPACE(sizeof(uint16_t))];
+    struct cmsghdr align;
+  } control;
+  struct iovec iov[UV__MMSG_MAXWIDTH];
+  struct cmsghdr* cmsg;
+  struct msghdr h;
+  unsigned int addrlen;
+  unsigned int niov;
+  unsigned int i;
+  unsigned int k;
+  size_t segment;
+  size_t total;
+  size_t len;
+  ssize_t size;
+
+  if (handle->flags & UV_HANDLE_UDP_NO_GSO)
+    return UV_ENOTSUP;
+
+  if (count < 2 || count > UV__UDP_MAX_SEGMENTS)
+    return UV_ENOTSUP;
+
+  addrlen = uv__udp_addrlen(addrs[0]);
+  segment = 0;
+  total = 0;
+  niov = 0;
+
+  for (i = 0; i < count; i++) {
+    if (uv__udp_addrlen(addrs[i]) != addrlen ||
+        (addrlen > 0 && memcmp(addrs[i], addrs[0], addrlen) != 0)) {
+      return UV_ENOTSUP;
+    }
+
+    len = uv__count_bufs(bufs[i], nbufs[i]);
+    if (i == 0)
+      segment = len;
+    /* Every segment but the last must be exactly segment bytes long. */
+    if (len == 0 || len > segment || (len < segment && i != count - 1))
+      return UV_ENOTSUP;
+    total += len;
+
+    if (niov + nbufs[i] > ARRAY_SIZE(iov))
+      return UV_ENOTSUP;
+    for (k = 0; k < nbufs[i]; k++) {
+      iov[niov].iov_base = bufs[i][k].base;
+      iov[niov].iov_len = bufs[i][k].len;
+      niov++;
+    }
+  }
+
+  if (total > UV__UDP_MAX_PAYLOAD)
+    return UV_ENOTSUP;
+
+  memset(&h, 0, sizeof(h));
+  memset(&control, 0, sizeof(control));
+  h.msg_name = addrs[0];
+  h.msg_namelen = addrlen;
+  h.msg_iov = iov;
+  h.msg_iovlen = niov;
+  h.msg_control = control.buf;
+  h.msg_controllen = sizeof(control.buf);
+
+  cmsg = CMSG_FIRSTHDR(&h);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  *(uint16_t*) CMSG_DATA(cmsg) = segment;
+
+  do
+    size = sendmsg(handle->io_watcher.fd, &h, 0);
+  while (size == -1 && errno == EINTR);
+
+  if (size == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+      return UV_EAGAIN;
+    /* Kernels before 4.18 reject the control message, EIO means the route's
+     * device cannot checksum the segments.
+     */
+    if (errno == EINVAL || errno == ENOPROTOOPT || errno == EIO) {
+      handle->flags |= UV_HANDLE_UDP_NO_GSO;
+      return UV_ENOTSUP;
+    }
+    return UV__ERR(errno);
+  }
+
+  return count;
+}
+
+
+static int uv__udp_try_sendmmsg(uv_udp_t* handle,
+                                unsigned int count,
+                                uv_buf_t* bufs[],
+                                unsigned int nbufs[],
+                                struct sockaddr* addrs[]) {
+  struct uv__mmsghdr mmsg[UV__MMSG_MAXWIDTH];
+  unsigned int sent;
+  unsigned int width;
+  unsigned int i;
+  int r;
+
+  sent = 0;
+  while (sent < count) {
+    width = count - sent;
+    if (width > ARRAY_SIZE(mmsg))
+      width = ARRAY_SIZE(mmsg);
+
+    for (i = 0; i < width; i++) {
+      memset(&mmsg[i], 0, sizeof(mmsg[i]));
+      mmsg[i].msg_hdr.msg_name = addrs[sent + i];
+      mmsg[i].msg_hdr.msg_namelen = uv__udp_addrlen(addrs[sent + i]);
+      mmsg[i].msg_hdr.msg_iov = (struct iovec*) bufs[sent + i];
+      mmsg[i].msg_hdr.msg_iovlen = nbufs[sent + i];
+    }
+
+    do
+      r = uv__sendmmsg(handle->io_watcher.fd, mmsg, width, 0);
+    while (r == -1 && errno == EINTR);
+
+    if (r == -1) {
+      if (errno == ENOSYS)
+        return sent + uv__udp_try_send_each(handle,
+                                            count - sent,
+                                            bufs + sent,
+                                            nbufs + sent,
+                                            addrs + sent);
+      if (sent > 0)
+        break;
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+        return UV_EAGAIN;
+      return UV__ERR(errno);
+    }
+
+    sent += r;
+    /* A short count means the socket buffer is full or a datagram failed. */
+    if ((unsigned int) r < width)
+      break;
+  }
+
+  return sent;
+}
+#endif
+
+
+int uv__udp_try_send2(uv_udp_t* handle,
+                      unsigned int count,
+                      uv_buf_t* bufs[],
+                      unsigned int nbufs[],
+                      struct sockaddr* addrs[],
+                      unsigned int flags) {
+  int err;
+
+  /* already sending a message */
+  if (handle->send_queue_count != 0)
+    return UV_EAGAIN;
+
+  if (addrs[0] != NULL) {
+    err = uv__udp_maybe_deferred_bind(handle, addrs[0]->sa_family, 0);
+    if (err)
+      return err;
+  } else {
+    assert(handle->flags & UV_HANDLE_UDP_CONNECTED);
+  }
+
+#if HAVE_MMSG
+  if (flags & UV_UDP_SEGMENT) {
+    err = uv__udp_try_send_gso(handle, count, bufs, nbufs, addrs);
+    if (err != UV_ENOTSUP)
+      return err;
+  }
+
+  return uv__udp_try_sendmmsg(handle, count, bufs, nbufs, addrs);
+#else
+  return uv__udp_try_send_each(handle, count, bufs, nbufs, addrs);
+#endif
+}
+
+
 static int uv__udp_set_membership4(uv_udp_t* handle,
                                    const struct sockaddr_in* multicast_addr,
                                    const char* interface_addr,
@@ -646,7 +967,7 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
     return UV_EINVAL;
 
-  if (flags & ~0xFF)
+  if (flags & ~0xFF & ~UV_UDP_RECVMMSG)
     return UV_EINVAL;
 
   if (domain != AF_UNSPEC) {
@@ -659,6 +980,10 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   }
 
   uv__handle_init(loop, (uv_handle_t*)handle, UV_UDP);
+#if HAVE_MMSG
+  if (flags & UV_UDP_RECVMMSG)
+    handle->flags |= UV_HANDLE_UDP_RECVMMSG;
+#endif
   handle->alloc_cb = NULL;
   handle->recv_cb = NULL;
   handle->send_queue_size = 0;
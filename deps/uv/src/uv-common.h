@@ -104,6 +104,8 @@ enum {
   /* Only used by uv_udp_t handles. */
   UV_HANDLE_UDP_PROCESSING              = 0x01000000,
   UV_HANDLE_UDP_CONNECTED               = 0x02000000,
+  UV_HANDLE_UDP_RECVMMSG                = 0x04000000,
+  UV_HANDLE_UDP_NO_GSO                  = 0x08000000,
 
   /* Only used by uv_pipe_t handles. */
   UV_HANDLE_NON_OVERLAPPED_PIPE         = 0x01000000,
@@ -165,6 +167,13 @@ int uv__udp_try_send(uv_udp_t* handle,
                      const struct sockaddr* addr,
                      unsigned int addrlen);
 
+int uv__udp_try_send2(uv_udp_t* handle,
+                      unsigned int count,
+                      uv_buf_t* bufs[],
+                      unsigned int nbufs[],
+                      struct sockaddr* addrs[],
+                      unsigned int flags);
+
 int uv__udp_recv_start(uv_udp_t* handle, uv_alloc_cb alloccb,
                        uv_udp_recv_cb recv_cb);
 
@@ -174,10 +183,26 @@ void uv__fs_poll_close(uv_fs_poll_t* handle);
 
 int uv__getaddrinfo_translate_error(int sys_err);    /* EAI_* error. */
 
+/* Loop state that is private to libuv. It lives behind the `internal_fields`
+ * pointer, so that adding to it doesn't change the size of uv_loop_t.
+ */
+typedef struct uv__loop_internal_fields_s uv__loop_internal_fields_t;
+
+struct uv__loop_internal_fields_s {
+  uv_work_timing_cb work_timing_cb;
+  void* work_timing_arg;
+#ifdef __linux__
+  void* io_uring;  /* struct uv__iou, see linux-iouring.c. */
+#endif
+};
+
+#define uv__get_internal_fields(loop)                                         \
+  ((uv__loop_internal_fields_t*) (loop)->internal_fields)
+
 enum uv__work_kind {
-  UV__WORK_CPU,
-  UV__WORK_FAST_IO,
-  UV__WORK_SLOW_IO
+  UV__WORK_CPU = UV_WORK_CPU,
+  UV__WORK_FAST_IO = UV_WORK_FAST_IO,
+  UV__WORK_SLOW_IO = UV_WORK_SLOW_IO
 };
 
 void uv__work_submit(uv_loop_t* loop,
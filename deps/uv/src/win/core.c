@@ -222,16 +222,24 @@ static void uv_init(void) {
 
 
 int uv_loop_init(uv_loop_t* loop) {
+  uv__loop_internal_fields_t* lfields;
   struct heap* timer_heap;
   int err;
 
   /* Initialize libuv itself first */
   uv__once_init();
 
+  lfields = uv__calloc(1, sizeof(*lfields));
+  if (lfields == NULL)
+    return UV_ENOMEM;
+  loop->internal_fields = lfields;
+
   /* Create an I/O completion port */
   loop->iocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
-  if (loop->iocp == NULL)
-    return uv_translate_sys_error(GetLastError());
+  if (loop->iocp == NULL) {
+    err = uv_translate_sys_error(GetLastError());
+    goto fail_iocp;
+  }
 
   /* To prevent uninitialized memory access, loop->time must be initialized
    * to zero before calling uv_update_time for the first time.
@@ -300,6 +308,10 @@ fail_timers_alloc:
   CloseHandle(loop->iocp);
   loop->iocp = INVALID_HANDLE_VALUE;
 
+fail_iocp:
+  uv__free(lfields);
+  loop->internal_fields = NULL;
+
   return err;
 }
 
@@ -343,6 +355,9 @@ void uv__loop_close(uv_loop_t* loop) {
   loop->timer_heap = NULL;
 
   CloseHandle(loop->iocp);
+
+  uv__free(loop->internal_fields);
+  loop->internal_fields = NULL;
 }
 
 
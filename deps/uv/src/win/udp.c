@@ -133,7 +133,8 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
     return UV_EINVAL;
 
-  if (flags & ~0xFF)
+  /* UV_UDP_RECVMMSG is accepted but ignored, recvmmsg is not available. */
+  if (flags & ~0xFF & ~UV_UDP_RECVMMSG)
     return UV_EINVAL;
 
   uv__handle_init(loop, (uv_handle_t*) handle, UV_UDP);
@@ -1033,3 +1034,31 @@ int uv__udp_try_send(uv_udp_t* handle,
 
   return bytes;
 }
+
+
+int uv__udp_try_send2(uv_udp_t* handle,
+                      unsigned int count,
+                      uv_buf_t* bufs[],
+                      unsigned int nbufs[],
+                      struct sockaddr* addrs[],
+                      unsigned int flags) {
+  unsigned int addrlen;
+  unsigned int i;
+  int err;
+
+  /* There is no sendmmsg() or UDP_SEGMENT, send the datagrams one by one. */
+  for (i = 0; i < count; i++) {
+    if (addrs[i] == NULL)
+      addrlen = 0;
+    else if (addrs[i]->sa_family == AF_INET6)
+      addrlen = sizeof(struct sockaddr_in6);
+    else
+      addrlen = sizeof(struct sockaddr_in);
+
+    err = uv__udp_try_send(handle, bufs[i], nbufs[i], addrs[i], addrlen);
+    if (err < 0)
+      return i > 0 ? (int) i : err;
+  }
+
+  return count;
+}
@@ -0,0 +1,315 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* Tests for the io_uring path of the fs requests on Linux. The requests must
+ * behave the same whether they run on the ring or on the threadpool.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#ifndef __NR_io_uring_setup
+# define __NR_io_uring_setup 425
+#endif
+
+#define WRITE_SIZE (1024 * 1024)
+
+static const char fixture[] = "test_file_io_uring";
+static char write_buf[WRITE_SIZE];
+static char read_buf[64];
+static size_t bytes_read;
+static int pipe_fds[2];
+static int cb_count;
+
+
+/* Whether the fs requests can run on the ring, like uv__iou_check() and
+ * uv__iou_init() decide it.
+ */
+static int can_use_io_uring(void) {
+  struct utsname u;
+  unsigned int major;
+  unsigned int minor;
+  unsigned int patch;
+  uint32_t params[30];  /* struct io_uring_params */
+  int fd;
+
+  if (uname(&u))
+    return 0;
+
+  patch = 0;
+  if (sscanf(u.release, "%u.%u.%u", &major, &minor, &patch) < 2)
+    return 0;
+
+  if (major < 5 ||
+      (major == 5 && minor < 10) ||
+      (major == 5 && minor == 10 && patch < 186)) {
+    return 0;
+  }
+
+  memset(params, 0, sizeof(params));
+  fd = syscall(__NR_io_uring_setup, 1, params);
+  if (fd == -1)
+    return 0;
+
+  close(fd);
+  return 1;
+}
+
+
+static uint64_t fast_io_submitted(void) {
+  uv_threadpool_stats_t stats;
+
+  ASSERT(0 == uv_threadpool_stats(UV_WORK_FAST_IO, &stats));
+  return stats.submitted;
+}
+
+
+static void reader(void* arg) {
+  ssize_t n;
+  char buf[4096];
+  size_t i;
+
+  for (;;) {
+    /* Slow reads make the pipe fill up, and the writes short. */
+    uv_sleep(1);
+    n = read(pipe_fds[0], buf, sizeof(buf));
+    if (n <= 0)
+      break;
+
+    for (i = 0; i < (size_t) n; i++)
+      ASSERT(buf[i] == write_buf[bytes_read + i]);
+    bytes_read += n;
+  }
+}
+
+
+static void write_cb(uv_fs_t* req) {
+  ASSERT(req->fs_type == UV_FS_WRITE);
+  ASSERT(req->result == WRITE_SIZE);
+  cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void read_cb(uv_fs_t* req) {
+  ASSERT(req->fs_type == UV_FS_READ);
+  if (cb_count++ == 0)
+    ASSERT(req->result == 5);
+  else
+    ASSERT(req->result == 0);  /* EOF */
+  uv_fs_req_cleanup(req);
+}
+
+
+static void stat_cb(uv_fs_t* req) {
+  ASSERT(req->fs_type == UV_FS_STAT);
+  ASSERT(req->result == 0);
+  ASSERT(req->statbuf.st_size == 5);
+  cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void create_fixture(void) {
+  uv_fs_t req;
+  uv_buf_t buf;
+  uv_file file;
+
+  unlink(fixture);
+  file = uv_fs_open(NULL, &req, fixture, O_WRONLY | O_CREAT, 0644, NULL);
+  ASSERT(file >= 0);
+  uv_fs_req_cleanup(&req);
+
+  buf = uv_buf_init("hello", 5);
+  ASSERT(5 == uv_fs_write(NULL, &req, file, &buf, 1, -1, NULL));
+  uv_fs_req_cleanup(&req);
+
+  ASSERT(0 == uv_fs_close(NULL, &req, file, NULL));
+  uv_fs_req_cleanup(&req);
+}
+
+
+/* Returns whether the request went to the threadpool. */
+static int stat_fixture(void) {
+  uv_fs_t req;
+  uint64_t submitted;
+
+  submitted = fast_io_submitted();
+  cb_count = 0;
+  ASSERT(0 == uv_fs_stat(uv_default_loop(), &req, fixture, stat_cb));
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(cb_count == 1);
+
+  unlink(fixture);
+  return fast_io_submitted() != submitted;
+}
+
+
+TEST_IMPL(fs_io_uring_short_write) {
+  uv_thread_t thread;
+  uv_fs_t req;
+  uv_buf_t bufs[2];
+  size_t i;
+
+  for (i = 0; i < sizeof(write_buf); i++)
+    write_buf[i] = i % 251;
+
+  ASSERT(0 == pipe(pipe_fds));
+  ASSERT(0 == uv_thread_create(&thread, reader, NULL));
+
+  /* A pipe takes much less than that at once. */
+  bufs[0] = uv_buf_init(write_buf, 4096 + 7);
+  bufs[1] = uv_buf_init(write_buf + bufs[0].len, WRITE_SIZE - bufs[0].len);
+  ASSERT(0 == uv_fs_write(uv_default_loop(),
+                          &req,
+                          pipe_fds[1],
+                          bufs,
+                          2,
+                          -1,
+                          write_cb));
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(cb_count == 1);
+
+  ASSERT(0 == close(pipe_fds[1]));
+  ASSERT(0 == uv_thread_join(&thread));
+  ASSERT(bytes_read == WRITE_SIZE);
+  ASSERT(0 == close(pipe_fds[0]));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(fs_io_uring_short_read) {
+  uv_fs_t open_req;
+  uv_fs_t req;
+  uv_buf_t buf;
+  uv_file file;
+
+  create_fixture();
+  file = uv_fs_open(NULL, &open_req, fixture, O_RDONLY, 0, NULL);
+  ASSERT(file >= 0);
+  uv_fs_req_cleanup(&open_req);
+
+  /* Reads, unlike writes, return what there is. */
+  buf = uv_buf_init(read_buf, sizeof(read_buf));
+  ASSERT(0 == uv_fs_read(uv_default_loop(), &req, file, &buf, 1, 0, read_cb));
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(cb_count == 1);
+  ASSERT(0 == memcmp(read_buf, "hello", 5));
+
+  ASSERT(0 == uv_fs_read(uv_default_loop(), &req, file, &buf, 1, 5, read_cb));
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(cb_count == 2);
+
+  ASSERT(0 == uv_fs_close(NULL, &req, file, NULL));
+  uv_fs_req_cleanup(&req);
+  unlink(fixture);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(fs_io_uring_disabled) {
+  /* Read once, before the first request. */
+  ASSERT(0 == setenv("UV_USE_IO_URING", "0", 1));
+
+  create_fixture();
+  ASSERT(1 == stat_fixture());
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(fs_io_uring_enabled) {
+  ASSERT(0 == setenv("UV_USE_IO_URING", "1", 1));
+  if (!can_use_io_uring())
+    RETURN_SKIP("io_uring is not available.");
+
+  create_fixture();
+  ASSERT(0 == stat_fixture());
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(fs_io_uring_setup_fail) {
+  struct rlimit lim;
+  int fd;
+
+  ASSERT(0 == setenv("UV_USE_IO_URING", "1", 1));
+  if (!can_use_io_uring())
+    RETURN_SKIP("io_uring is not available.");
+
+  /* Nothing has created the ring yet. Without a free file descriptor,
+   * io_uring_setup() fails with EMFILE and the requests go to the threadpool.
+   */
+  create_fixture();
+  uv_default_loop();
+  fd = dup(0);
+  ASSERT(fd >= 0);
+  ASSERT(0 == close(fd));
+  ASSERT(0 == getrlimit(RLIMIT_NOFILE, &lim));
+  lim.rlim_cur = fd;
+  ASSERT(0 == setrlimit(RLIMIT_NOFILE, &lim));
+
+  ASSERT(1 == stat_fixture());
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#else
+
+TEST_IMPL(fs_io_uring_short_write) {
+  RETURN_SKIP("io_uring is Linux-only.");
+}
+
+TEST_IMPL(fs_io_uring_short_read) {
+  RETURN_SKIP("io_uring is Linux-only.");
+}
+
+TEST_IMPL(fs_io_uring_disabled) {
+  RETURN_SKIP("io_uring is Linux-only.");
+}
+
+TEST_IMPL(fs_io_uring_enabled) {
+  RETURN_SKIP("io_uring is Linux-only.");
+}
+
+TEST_IMPL(fs_io_uring_setup_fail) {
+  RETURN_SKIP("io_uring is Linux-only.");
+}
+
+#endif  /* __linux__ */
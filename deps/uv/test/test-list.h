@@ -156,6 +156,8 @@ TEST_DECLARE   (udp_open_twice)
 TEST_DECLARE   (udp_open_bound)
 TEST_DECLARE   (udp_open_connect)
 TEST_DECLARE   (udp_try_send)
+TEST_DECLARE   (udp_try_send2)
+TEST_DECLARE   (udp_mmsg)
 TEST_DECLARE   (pipe_bind_error_addrinuse)
 TEST_DECLARE   (pipe_bind_error_addrnotavail)
 TEST_DECLARE   (pipe_bind_error_inval)
@@ -301,6 +303,11 @@ TEST_DECLARE   (fs_fstat)
 TEST_DECLARE   (fs_access)
 TEST_DECLARE   (fs_chmod)
 TEST_DECLARE   (fs_copyfile)
+TEST_DECLARE   (fs_io_uring_short_write)
+TEST_DECLARE   (fs_io_uring_short_read)
+TEST_DECLARE   (fs_io_uring_disabled)
+TEST_DECLARE   (fs_io_uring_enabled)
+TEST_DECLARE   (fs_io_uring_setup_fail)
 TEST_DECLARE   (fs_unlink_readonly)
 #ifdef _WIN32
 TEST_DECLARE   (fs_unlink_archive_readonly)
@@ -366,6 +373,7 @@ TEST_DECLARE   (fs_fchmod_archive_readonly)
 TEST_DECLARE   (strscpy)
 TEST_DECLARE   (threadpool_queue_work_simple)
 TEST_DECLARE   (threadpool_queue_work_einval)
+TEST_DECLARE   (threadpool_queue_work_kind)
 TEST_DECLARE   (threadpool_multiple_event_loops)
 TEST_DECLARE   (threadpool_cancel_getaddrinfo)
 TEST_DECLARE   (threadpool_cancel_getnameinfo)
@@ -645,6 +653,8 @@ TASK_LIST_START
   TEST_ENTRY  (udp_multicast_join6)
   TEST_ENTRY  (udp_multicast_ttl)
   TEST_ENTRY  (udp_try_send)
+  TEST_ENTRY  (udp_try_send2)
+  TEST_ENTRY  (udp_mmsg)
 
   TEST_ENTRY  (udp_open)
   TEST_HELPER (udp_open, udp4_echo_server)
@@ -878,6 +888,11 @@ TASK_LIST_START
   TEST_ENTRY  (fs_access)
   TEST_ENTRY  (fs_chmod)
   TEST_ENTRY  (fs_copyfile)
+  TEST_ENTRY  (fs_io_uring_short_write)
+  TEST_ENTRY  (fs_io_uring_short_read)
+  TEST_ENTRY  (fs_io_uring_disabled)
+  TEST_ENTRY  (fs_io_uring_enabled)
+  TEST_ENTRY  (fs_io_uring_setup_fail)
   TEST_ENTRY  (fs_unlink_readonly)
 #ifdef _WIN32
   TEST_ENTRY  (fs_unlink_archive_readonly)
@@ -942,6 +957,7 @@ TASK_LIST_START
   TEST_ENTRY  (strscpy)
   TEST_ENTRY  (threadpool_queue_work_simple)
   TEST_ENTRY  (threadpool_queue_work_einval)
+  TEST_ENTRY  (threadpool_queue_work_kind)
   TEST_ENTRY  (threadpool_multiple_event_loops)
   TEST_ENTRY  (threadpool_cancel_getaddrinfo)
   TEST_ENTRY  (threadpool_cancel_getnameinfo)
@@ -41,7 +41,7 @@ static unsigned fs_cb_called;
 static unsigned done_cb_called;
 static unsigned done2_cb_called;
 static unsigned timer_cb_called;
-static uv_work_t pause_reqs[4];
+static uv_work_t pause_reqs[12];
 static uv_sem_t pause_sems[ARRAY_SIZE(pause_reqs)];
 
 
@@ -55,21 +55,25 @@ static void done_cb(uv_work_t* req, int status) {
 }
 
 
+/* Every kind of work has a pool of its own, occupy all threads of each. */
 static void saturate_threadpool(void) {
   uv_loop_t* loop;
   char buf[64];
+  size_t n;
   size_t i;
 
-  snprintf(buf,
-           sizeof(buf),
-           "UV_THREADPOOL_SIZE=%lu",
-           (unsigned long)ARRAY_SIZE(pause_reqs));
+  n = ARRAY_SIZE(pause_reqs) / UV_WORK_KIND_MAX;
+  snprintf(buf, sizeof(buf), "UV_THREADPOOL_SIZE=%lu", (unsigned long) n);
   putenv(buf);
 
   loop = uv_default_loop();
   for (i = 0; i < ARRAY_SIZE(pause_reqs); i += 1) {
     ASSERT(0 == uv_sem_init(pause_sems + i, 0));
-    ASSERT(0 == uv_queue_work(loop, pause_reqs + i, work_cb, done_cb));
+    ASSERT(0 == uv_queue_work_kind(loop,
+                                   pause_reqs + i,
+                                   (uv_work_kind) (i / n),
+                                   work_cb,
+                                   done_cb));
   }
 }
 
@@ -243,6 +247,9 @@ TEST_IMPL(threadpool_cancel_fs) {
   unsigned n;
   uv_buf_t iov;
 
+  /* Requests that run on an io_uring can't be cancelled. */
+  ASSERT(0 == uv_os_setenv("UV_USE_IO_URING", "0"));
+
   INIT_CANCEL_INFO(&ci, reqs);
   loop = uv_default_loop();
   saturate_threadpool();
@@ -26,6 +26,7 @@ static int work_cb_count;
 static int after_work_cb_count;
 static uv_work_t work_req;
 static char data;
+static int timing_cb_count;
 
 
 static void work_cb(uv_work_t* req) {
@@ -74,3 +75,64 @@ TEST_IMPL(threadpool_queue_work_einval) {
   MAKE_VALGRIND_HAPPY();
   return 0;
 }
+
+
+static void timing_cb(uv_loop_t* loop,
+                      void* arg,
+                      uv_work_kind kind,
+                      uint64_t wait_time,
+                      uint64_t run_time) {
+  ASSERT(loop == uv_default_loop());
+  ASSERT(arg == &data);
+  ASSERT(kind == UV_WORK_SLOW_IO);
+  ASSERT(work_cb_count == 1);
+  ASSERT(after_work_cb_count == 0);
+  timing_cb_count++;
+}
+
+
+TEST_IMPL(threadpool_queue_work_kind) {
+  uv_threadpool_stats_t before;
+  uv_threadpool_stats_t after;
+  int r;
+
+  ASSERT(0 == uv_threadpool_stats(UV_WORK_SLOW_IO, &before));
+  ASSERT(before.threads > 0);
+
+  uv_loop_set_work_timing_cb(uv_default_loop(), timing_cb, &data);
+  work_req.data = &data;
+  r = uv_queue_work_kind(uv_default_loop(),
+                         &work_req,
+                         UV_WORK_SLOW_IO,
+                         work_cb,
+                         after_work_cb);
+  ASSERT(r == 0);
+  uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+  uv_loop_set_work_timing_cb(uv_default_loop(), NULL, NULL);
+
+  ASSERT(work_cb_count == 1);
+  ASSERT(after_work_cb_count == 1);
+  ASSERT(timing_cb_count == 1);
+
+  ASSERT(0 == uv_threadpool_stats(UV_WORK_SLOW_IO, &after));
+  ASSERT(after.threads == before.threads);
+  ASSERT(after.submitted == before.submitted + 1);
+  ASSERT(after.completed == before.completed + 1);
+  ASSERT(after.queued == 0);
+  ASSERT(after.running == 0);
+  ASSERT(after.run_time >= before.run_time);
+  ASSERT(after.max_queued >= 1);
+  ASSERT(after.wait_time >= before.wait_time);
+  ASSERT(after.max_wait_time <= after.wait_time);
+
+  r = uv_queue_work_kind(uv_default_loop(),
+                         &work_req,
+                         UV_WORK_KIND_MAX,
+                         work_cb,
+                         after_work_cb);
+  ASSERT(r == UV_EINVAL);
+  ASSERT(UV_EINVAL == uv_threadpool_stats(UV_WORK_KIND_MAX, &after));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -119,3 +119,88 @@ TEST_IMPL(udp_try_send) {
   MAKE_VALGRIND_HAPPY();
   return 0;
 }
+
+
+static int try_send2_recv_cb_called;
+
+
+static void try_send2_recv_cb(uv_udp_t* handle,
+                              ssize_t nread,
+                              const uv_buf_t* rcvbuf,
+                              const struct sockaddr* addr,
+                              unsigned flags) {
+  if (nread == 0) {
+    ASSERT(addr == NULL);
+    return;
+  }
+
+  ASSERT(addr != NULL);
+  ASSERT(nread == 4 || nread == 2);
+  ASSERT(memcmp("PING", rcvbuf->base, nread) == 0);
+
+  /* With UV_UDP_SEGMENT the last datagram carries the short tail. */
+  if (++try_send2_recv_cb_called == 8) {
+    uv_close((uv_handle_t*) handle, close_cb);
+    uv_close((uv_handle_t*) &client, close_cb);
+  }
+}
+
+
+TEST_IMPL(udp_try_send2) {
+  struct sockaddr_in addr;
+  struct sockaddr* addrs[4];
+  unsigned int nbufs[4];
+  uv_buf_t* bufs[4];
+  uv_buf_t ping[2];
+  uv_buf_t tail;
+  int i;
+  int r;
+
+  ASSERT(0 == uv_ip4_addr("0.0.0.0", TEST_PORT, &addr));
+
+  r = uv_udp_init(uv_default_loop(), &server);
+  ASSERT(r == 0);
+
+  r = uv_udp_bind(&server, (const struct sockaddr*) &addr, 0);
+  ASSERT(r == 0);
+
+  r = uv_udp_recv_start(&server, alloc_cb, try_send2_recv_cb);
+  ASSERT(r == 0);
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  r = uv_udp_init(uv_default_loop(), &client);
+  ASSERT(r == 0);
+
+  /* Each datagram is "PING" split over two buffers, the last one is "PI". */
+  ping[0] = uv_buf_init("PI", 2);
+  ping[1] = uv_buf_init("NG", 2);
+  tail = uv_buf_init("PI", 2);
+  for (i = 0; i < 4; i++) {
+    bufs[i] = ping;
+    nbufs[i] = 2;
+    addrs[i] = (struct sockaddr*) &addr;
+  }
+
+  ASSERT(UV_EINVAL == uv_udp_try_send2(&client, 0, bufs, nbufs, addrs, 0));
+  ASSERT(UV_EINVAL == uv_udp_try_send2(&client, 4, bufs, nbufs, addrs, 1024));
+
+  r = uv_udp_try_send2(&client, 4, bufs, nbufs, addrs, 0);
+  ASSERT(r == 4);
+
+  bufs[3] = &tail;
+  nbufs[3] = 1;
+  r = uv_udp_try_send2(&client, 4, bufs, nbufs, addrs, UV_UDP_SEGMENT);
+  ASSERT(r == 4);
+
+  uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+  ASSERT(close_cb_called == 2);
+  ASSERT(try_send2_recv_cb_called == 8);
+
+  ASSERT(client.send_queue_size == 0);
+  ASSERT(server.send_queue_size == 0);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -33,6 +33,7 @@
         'test-fork.c',
         'test-fs.c',
         'test-fs-copyfile.c',
+        'test-fs-io-uring.c',
         'test-fs-event.c',
         'test-fs-poll.c',
         'test-getters-setters.c',
@@ -155,6 +156,7 @@
         'test-ip6-addr.c',
         'test-udp-multicast-interface.c',
         'test-udp-multicast-interface6.c',
+        'test-udp-mmsg.c',
         'test-udp-try-send.c',
         'test-uname.c',
       ],
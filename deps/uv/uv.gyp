@@ -237,6 +237,7 @@
           'sources': [
             'src/unix/linux-core.c',
             'src/unix/linux-inotify.c',
+            'src/unix/linux-iouring.c',
             'src/unix/linux-syscalls.c',
             'src/unix/linux-syscalls.h',
             'src/unix/procfs-exepath.c',
@@ -251,6 +252,7 @@
           'sources': [
             'src/unix/linux-core.c',
             'src/unix/linux-inotify.c',
+            'src/unix/linux-iouring.c',
             'src/unix/linux-syscalls.c',
             'src/unix/linux-syscalls.h',
             'src/unix/pthread-fixes.c',
@@ -23,7 +23,7 @@
 
 const { getOptionValue } = require('internal/options');
 
-const { methods, HTTPParser } =
+const { methods, HTTPParser, serializeHeaders } =
   getOptionValue('--http-parser') === 'legacy' ?
     internalBinding('http_parser') : internalBinding('http_parser_llhttp');
 
@@ -47,11 +47,8 @@ const kOnExecute = HTTPParser.kOnExecute | 0;
 
 const MAX_HEADER_PAIRS = 2000;
 
-// Only called in the slow case where slow means
-// that the request headers were either fragmented
-// across multiple TCP packets or too large to be
-// processed in a single run. This method is also
-// called to process trailing HTTP headers.
+// Only called to process trailing HTTP headers. The request and response
+// headers are always passed to .onHeadersComplete() in one piece.
 function parserOnHeaders(headers, url) {
   // Once we exceeded headers limit - stop collecting them
   if (this.maxHeaderPairs <= 0 ||
@@ -61,10 +58,7 @@ function parserOnHeaders(headers, url) {
   this._url += url;
 }
 
-// `headers` and `url` are set only if .onHeaders() has not been called for
-// this request.
-// `url` is not set for response parsers but that's not applicable here since
-// all our parsers are request parsers.
+// `url` is not set for response parsers.
 function parserOnHeadersComplete(versionMajor, versionMinor, headers, method,
                                  url, statusCode, statusMessage, upgrade,
                                  shouldKeepAlive) {
@@ -248,5 +242,6 @@ module.exports = {
   methods,
   parsers,
   kIncomingMessage,
-  HTTPParser
+  HTTPParser,
+  serializeHeaders
 };
@@ -49,9 +49,16 @@ const {
 } = require('internal/errors');
 const { validateString } = require('internal/validators');
 
-const { CRLF, debug } = common;
+const { CRLF, debug, serializeHeaders } = common;
 
 const kIsCorked = Symbol('isCorked');
+const kHeader = Symbol('header');
+
+// Header blocks are serialized into slices of a shared pool, the same way
+// small Buffers are allocated.
+const kHeaderPoolSize = 16 * 1024;
+var headerPool;
+var headerPoolOffset = 0;
 
 const hasOwnProperty = Function.call.bind(Object.prototype.hasOwnProperty);
 
@@ -101,7 +108,7 @@ function OutgoingMessage() {
 
   this.socket = null;
   this.connection = null;
-  this._header = null;
+  this[kHeader] = null;
   this[outHeadersKey] = null;
 
   this._onPendingData = noopPendingOutput;
@@ -110,6 +117,22 @@ Object.setPrototypeOf(OutgoingMessage.prototype, Stream.prototype);
 Object.setPrototypeOf(OutgoingMessage, Stream);
 
 
+// The header block is a Buffer unless it had to be built in JS, see
+// serializeHeader().
+Object.defineProperty(OutgoingMessage.prototype, '_header', {
+  configurable: true,
+  get: function() {
+    const header = this[kHeader];
+    if (header instanceof Buffer)
+      return header.latin1Slice(0, header.length);
+    return header;
+  },
+  set: function(val) {
+    this[kHeader] = val;
+  }
+});
+
+
 Object.defineProperty(OutgoingMessage.prototype, '_headers', {
   get: internalUtil.deprecate(function() {
     return this.getHeaders();
@@ -160,7 +183,7 @@ Object.defineProperty(OutgoingMessage.prototype, '_headerNames', {
 
 
 OutgoingMessage.prototype._renderHeaders = function _renderHeaders() {
-  if (this._header) {
+  if (this[kHeader]) {
     throw new ERR_HTTP_HEADERS_SENT('render');
   }
 
@@ -211,15 +234,22 @@ OutgoingMessage.prototype.destroy = function destroy(error) {
 
 // This abstract either writing directly to the socket or buffering it.
 OutgoingMessage.prototype._send = function _send(data, encoding, callback) {
-  // This is a shameful hack to get the headers and first body chunk onto
-  // the same packet. Future versions of Node are going to take care of
-  // this at a lower level and in a more general way.
+  // Get the headers and first body chunk onto the same packet.
   if (!this._headerSent) {
-    if (typeof data === 'string' &&
+    var header = this[kHeader];
+    const conn = this.connection;
+    if (typeof header !== 'string') {
+      if (this.outputData.length === 0 && conn &&
+          conn._httpMessage === this && conn.writable && !conn.destroyed) {
+        this._headerSent = true;
+        return writeHeader(conn, header, data, encoding, callback);
+      }
+    } else if (typeof data === 'string' &&
         (encoding === 'utf8' || encoding === 'latin1' || !encoding)) {
-      data = this._header + data;
-    } else {
-      var header = this._header;
+      data = header + data;
+      header = null;
+    }
+    if (header !== null) {
       if (this.outputData.length === 0) {
         this.outputData = [{
           data: header,
@@ -242,6 +272,26 @@ OutgoingMessage.prototype._send = function _send(data, encoding, callback) {
 };
 
 
+// Writes a natively serialized header block together with the first chunk
+// of the body. The socket is corked so that both are passed to a single
+// writev() call.
+function writeHeader(conn, header, data, encoding, callback) {
+  if (typeof encoding === 'function') {
+    callback = encoding;
+    encoding = null;
+  }
+
+  if (!data.length)
+    return conn.write(header, callback);
+
+  conn.cork();
+  conn.write(header);
+  const ret = conn.write(data, encoding, callback);
+  conn.uncork();
+  return ret;
+}
+
+
 OutgoingMessage.prototype._writeRaw = _writeRaw;
 function _writeRaw(data, encoding, callback) {
   const conn = this.connection;
@@ -295,29 +345,34 @@ function _storeHeader(firstLine, headers) {
     date: false,
     expect: false,
     trailer: false,
-    header: firstLine
+    // Header names and values, alternating
+    fields: []
   };
+  let validate = false;
 
   if (headers) {
     if (headers === this[outHeadersKey]) {
       for (const key in headers) {
         const entry = headers[key];
-        processHeader(this, state, entry[0], entry[1], false);
+        processHeader(this, state, entry[0], entry[1]);
       }
     } else if (Array.isArray(headers)) {
+      validate = true;
       for (const entry of headers) {
-        processHeader(this, state, entry[0], entry[1], true);
+        processHeader(this, state, entry[0], entry[1]);
       }
     } else {
+      validate = true;
       for (const key in headers) {
         if (hasOwnProperty(headers, key)) {
-          processHeader(this, state, key, headers[key], true);
+          processHeader(this, state, key, headers[key]);
         }
       }
     }
   }
 
-  let { header } = state;
+  // The headers that are added here are known to be valid.
+  let header = '';
 
   // Date header
   if (this.sendDate && !state.date) {
@@ -387,7 +442,7 @@ function _storeHeader(firstLine, headers) {
     throw new ERR_HTTP_TRAILER_INVALID();
   }
 
-  this._header = header + CRLF;
+  this[kHeader] = serializeHeader(firstLine, state.fields, header, validate);
   this._headerSent = false;
 
   // Wait until the first body chunk, or close(), is sent to flush,
@@ -395,27 +450,68 @@ function _storeHeader(firstLine, headers) {
   if (state.expect) this._send('');
 }
 
-function processHeader(self, state, key, value, validate) {
-  if (validate)
-    validateHeaderName(key);
+function processHeader(self, state, key, value) {
   if (Array.isArray(value)) {
     if (value.length < 2 || !isCookieField(key)) {
       for (var i = 0; i < value.length; i++)
-        storeHeader(self, state, key, value[i], validate);
+        storeHeader(self, state, key, value[i]);
       return;
     }
     value = value.join('; ');
   }
-  storeHeader(self, state, key, value, validate);
+  storeHeader(self, state, key, value);
 }
 
-function storeHeader(self, state, key, value, validate) {
-  if (validate)
-    validateHeaderValue(key, value);
-  state.header += key + ': ' + value + CRLF;
+// The header names and values are validated when the header block is
+// serialized. `undefined` is kept as is so that it is rejected then.
+function storeHeader(self, state, key, value) {
+  state.fields.push(key,
+                    typeof value === 'string' || value === undefined ?
+                      value : '' + value);
   matchHeader(self, state, key, value);
 }
 
+function createHeaderPool(size) {
+  headerPool = Buffer.allocUnsafeSlow(size);
+  headerPoolOffset = 0;
+}
+
+// Returns the header block as a slice of the header pool, serialized by
+// serializeHeaders() in src/node_http_parser_impl.h. Falls back to building
+// it as a string when that is not possible, which also validates the header
+// names and values and throws the appropriate error.
+function serializeHeader(firstLine, fields, tail, validate) {
+  if (headerPool === undefined)
+    createHeaderPool(kHeaderPoolSize);
+
+  let length = serializeHeaders(headerPool, headerPoolOffset, firstLine,
+                                fields, tail, validate);
+  if (length > headerPool.length - headerPoolOffset) {
+    createHeaderPool(Math.max(length, kHeaderPoolSize));
+    length = serializeHeaders(headerPool, 0, firstLine, fields, tail,
+                              validate);
+  }
+
+  if (length === -1) {
+    let header = firstLine;
+    for (var i = 0; i < fields.length; i += 2) {
+      const key = fields[i];
+      const value = fields[i + 1];
+      if (validate) {
+        validateHeaderName(key);
+        validateHeaderValue(key, value);
+      }
+      header += key + ': ' + value + CRLF;
+    }
+    return header + tail + CRLF;
+  }
+
+  const header = headerPool.slice(headerPoolOffset,
+                                  headerPoolOffset + length);
+  headerPoolOffset += length;
+  return header;
+}
+
 function matchHeader(self, state, field, value) {
   if (field.length < 4 || field.length > 17)
     return;
@@ -463,7 +559,7 @@ const validateHeaderValue = hideStackFrames((name, value) => {
 });
 
 OutgoingMessage.prototype.setHeader = function setHeader(name, value) {
-  if (this._header) {
+  if (this[kHeader]) {
     throw new ERR_HTTP_HEADERS_SENT('set');
   }
   validateHeaderName(name);
@@ -521,7 +617,7 @@ OutgoingMessage.prototype.hasHeader = function hasHeader(name) {
 OutgoingMessage.prototype.removeHeader = function removeHeader(name) {
   validateString(name, 'name');
 
-  if (this._header) {
+  if (this[kHeader]) {
     throw new ERR_HTTP_HEADERS_SENT('remove');
   }
 
@@ -555,7 +651,7 @@ OutgoingMessage.prototype._implicitHeader = function _implicitHeader() {
 Object.defineProperty(OutgoingMessage.prototype, 'headersSent', {
   configurable: true,
   enumerable: true,
-  get: function() { return !!this._header; }
+  get: function() { return !!this[kHeader]; }
 });
 
 
@@ -578,7 +674,7 @@ function write_(msg, chunk, encoding, callback, fromEnd) {
     return true;
   }
 
-  if (!msg._header) {
+  if (!msg[kHeader]) {
     msg._implicitHeader();
   }
 
@@ -686,7 +782,7 @@ OutgoingMessage.prototype.end = function end(chunk, encoding, callback) {
     if (typeof chunk !== 'string' && !(chunk instanceof Buffer)) {
       throw new ERR_INVALID_ARG_TYPE('chunk', ['string', 'Buffer'], chunk);
     }
-    if (!this._header) {
+    if (!this[kHeader]) {
       if (typeof chunk === 'string')
         this._contentLength = Buffer.byteLength(chunk, encoding);
       else
@@ -697,7 +793,7 @@ OutgoingMessage.prototype.end = function end(chunk, encoding, callback) {
       uncork = true;
     }
     write_(this, chunk, encoding, null, true);
-  } else if (!this._header) {
+  } else if (!this[kHeader]) {
     this._contentLength = 0;
     this._implicitHeader();
   }
@@ -798,7 +894,7 @@ OutgoingMessage.prototype._flushOutput = function _flushOutput(socket) {
 
 
 OutgoingMessage.prototype.flushHeaders = function flushHeaders() {
-  if (!this._header) {
+  if (!this[kHeader]) {
     this._implicitHeader();
   }
 
@@ -59,8 +59,11 @@ const kConnectOptions = Symbol('connect-options');
 const kDisableRenegotiation = Symbol('disable-renegotiation');
 const kErrorEmitted = Symbol('error-emitted');
 const kHandshakeTimeout = Symbol('handshake-timeout');
+const kAsyncHandshake = Symbol('async-handshake');
+const kKTLS = Symbol('ktls');
 const kRes = Symbol('res');
 const kSNICallback = Symbol('snicallback');
+const kSharedSessionCache = Symbol('shared-session-cache');
 
 const noop = () => {};
 
@@ -378,6 +381,7 @@ function TLSSocket(socket, opts) {
   net.Socket.call(this, {
     handle: this._wrapHandle(wrap),
     allowHalfOpen: socket && socket.allowHalfOpen,
+    onread: tlsOptions.onread,
     readable: false,
     writable: false
   });
@@ -610,6 +614,12 @@ TLSSocket.prototype._init = function(socket, wrap) {
   if (options.handshakeTimeout > 0)
     this.setTimeout(options.handshakeTimeout, this._handleTimeout);
 
+  if (options.ktls)
+    ssl.requestKTLS();
+
+  if (options.isServer && options.asyncHandshake)
+    ssl.enableAsyncHandshake();
+
   if (socket instanceof net.Socket) {
     this._parent = socket;
 
@@ -806,6 +816,7 @@ function makeSocketMethodProxy(name) {
   'getProtocol',
   'getSession',
   'getTLSTicket',
+  'isKTLSEnabled',
   'isSessionReused',
 ].forEach((method) => {
   TLSSocket.prototype[method] = makeSocketMethodProxy(method);
@@ -866,7 +877,9 @@ function tlsConnectionListener(rawSocket) {
     rejectUnauthorized: this.rejectUnauthorized,
     handshakeTimeout: this[kHandshakeTimeout],
     ALPNProtocols: this.ALPNProtocols,
-    SNICallback: this[kSNICallback] || SNICallback
+    SNICallback: this[kSNICallback] || SNICallback,
+    ktls: this[kKTLS],
+    asyncHandshake: this[kAsyncHandshake]
   });
 
   socket.on('secure', onServerSocketSecure);
@@ -967,10 +980,19 @@ function Server(options, listener) {
   if (options.ALPNProtocols)
     tls.convertALPNProtocols(options.ALPNProtocols, this);
 
+  this[kSharedSessionCache] = options.sharedSessionCache;
+  if (this[kSharedSessionCache] !== undefined &&
+      typeof this[kSharedSessionCache] !== 'boolean') {
+    throw new ERR_INVALID_ARG_TYPE(
+      'options.sharedSessionCache', 'boolean', options.sharedSessionCache);
+  }
+
   this.setSecureContext(options);
 
   this[kHandshakeTimeout] = options.handshakeTimeout || (120 * 1000);
   this[kSNICallback] = options.SNICallback;
+  this[kKTLS] = options.ktls;
+  this[kAsyncHandshake] = options.asyncHandshake;
 
   if (typeof this[kHandshakeTimeout] !== 'number') {
     throw new ERR_INVALID_ARG_TYPE(
@@ -982,6 +1004,15 @@ function Server(options, listener) {
       'options.SNICallback', 'function', options.SNICallback);
   }
 
+  if (this[kKTLS] !== undefined && typeof this[kKTLS] !== 'boolean')
+    throw new ERR_INVALID_ARG_TYPE('options.ktls', 'boolean', options.ktls);
+
+  if (this[kAsyncHandshake] !== undefined &&
+      typeof this[kAsyncHandshake] !== 'boolean') {
+    throw new ERR_INVALID_ARG_TYPE(
+      'options.asyncHandshake', 'boolean', options.asyncHandshake);
+  }
+
   // constructor call
   net.Server.call(this, tlsConnectionListener);
 
@@ -1110,6 +1141,9 @@ Server.prototype.setSecureContext = function(options) {
   if (this.sessionTimeout)
     this._sharedCreds.context.setSessionTimeout(this.sessionTimeout);
 
+  if (this[kSharedSessionCache])
+    this._sharedCreds.context.enableSharedSessionCache();
+
   if (options.ticketKeys) {
     this.ticketKeys = options.ticketKeys;
     this.setTicketKeys(this.ticketKeys);
@@ -1348,7 +1382,9 @@ exports.connect = function connect(...args) {
     rejectUnauthorized: options.rejectUnauthorized !== false,
     session: options.session,
     ALPNProtocols: options.ALPNProtocols,
-    requestOCSP: options.requestOCSP
+    requestOCSP: options.requestOCSP,
+    ktls: options.ktls,
+    onread: options.onread
   });
 
   tlssock[kConnectOptions] = options;
@@ -30,6 +30,7 @@ const {
 } = require('internal/dgram');
 const {
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_OPT_VALUE,
   ERR_MISSING_ARGS,
   ERR_SOCKET_ALREADY_BOUND,
   ERR_SOCKET_BAD_BUFFER_SIZE,
@@ -41,6 +42,7 @@ const {
 } = errors.codes;
 const {
   isInt32,
+  validateInt32,
   validateString,
   validateNumber
 } = require('internal/validators');
@@ -55,7 +57,7 @@ const {
 const { UV_UDP_REUSEADDR } = internalBinding('constants').os;
 
 const {
-  constants: { UV_UDP_IPV6ONLY },
+  constants: { UV_UDP_IPV6ONLY, kMaxRecvBatch },
   UDP,
   SendWrap
 } = internalBinding('udp_wrap');
@@ -79,6 +81,7 @@ function Socket(type, listener) {
   var lookup;
   let recvBufferSize;
   let sendBufferSize;
+  let recvBatch;
 
   if (type !== null && typeof type === 'object') {
     var options = type;
@@ -86,9 +89,12 @@ function Socket(type, listener) {
     lookup = options.lookup;
     recvBufferSize = options.recvBufferSize;
     sendBufferSize = options.sendBufferSize;
+    recvBatch = options.recvBatch;
+    if (recvBatch !== undefined)
+      validateInt32(recvBatch, 'options.recvBatch', 1, kMaxRecvBatch);
   }
 
-  var handle = newHandle(type, lookup);
+  var handle = newHandle(type, lookup, recvBatch);
   handle[owner_symbol] = this;
 
   this[async_id_symbol] = handle.getAsyncId();
@@ -121,6 +127,7 @@ function startListening(socket) {
   const state = socket[kStateSymbol];
 
   state.handle.onmessage = onMessage;
+  state.handle.onmessagebatch = onMessageBatch;
   // Todo: handle errors
   state.handle.recvStart();
   state.receiving = true;
@@ -143,6 +150,7 @@ function replaceHandle(self, newHandle) {
   newHandle.lookup = oldHandle.lookup;
   newHandle.bind = oldHandle.bind;
   newHandle.send = oldHandle.send;
+  newHandle.sendBatch = oldHandle.sendBatch;
   newHandle[owner_symbol] = self;
 
   // Replace the existing handle by the handle we got from master.
@@ -521,6 +529,155 @@ function doSend(ex, self, ip, list, address, port, callback) {
   }
 }
 
+// sendBatch(messages[, options][, callback])
+// where messages is an array of { msg, port[, address] } objects.
+Socket.prototype.sendBatch = function(messages, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = undefined;
+  }
+
+  if (!Array.isArray(messages))
+    throw new ERR_INVALID_ARG_TYPE('messages', 'Array', messages);
+  if (messages.length === 0)
+    throw new ERR_MISSING_ARGS('messages');
+
+  if (options !== undefined &&
+      (options === null || typeof options !== 'object')) {
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+  }
+  const gso = options !== undefined ? options.gso : undefined;
+  if (gso !== undefined && typeof gso !== 'boolean')
+    throw new ERR_INVALID_OPT_VALUE('gso', gso);
+
+  if (typeof callback !== 'function')
+    callback = undefined;
+
+  const count = messages.length;
+  const list = new Array(count);
+  const ports = new Array(count);
+  const addresses = new Array(count);
+
+  for (var i = 0; i < count; i++) {
+    const message = messages[i];
+    if (message === null || typeof message !== 'object')
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}]`, 'Object', message);
+
+    const { msg, address } = message;
+    if (typeof msg === 'string') {
+      list[i] = Buffer.from(msg);
+    } else if (isUint8Array(msg)) {
+      list[i] = msg;
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}].msg`,
+                                     ['Buffer', 'Uint8Array', 'string'],
+                                     msg);
+    }
+
+    const port = message.port >>> 0;
+    if (port === 0 || port > 65535)
+      throw new ERR_SOCKET_BAD_PORT(message.port);
+    ports[i] = port;
+
+    if (address && typeof address !== 'string') {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}].address`,
+                                     ['string', 'falsy'], address);
+    }
+    // Resolved to the loopback address like in send(). If sockets ever get
+    // a connect(), this has to turn into the peer, as it would for send().
+    addresses[i] = address || undefined;
+  }
+
+  healthCheck(this);
+
+  const state = this[kStateSymbol];
+
+  if (state.bindState === BIND_STATE_UNBOUND)
+    this.bind({ port: 0, exclusive: true }, null);
+
+  // If the socket hasn't been bound yet, push the batch onto the send queue
+  // and send after binding is complete.
+  if (state.bindState !== BIND_STATE_BOUND) {
+    enqueue(this, this.sendBatch.bind(this, messages, options, callback));
+    return;
+  }
+
+  // Batches usually go to a handful of peers, resolve each of them once.
+  const ips = new Map();
+  let pending = 0;
+  let failed = false;
+
+  const afterDns = (address, ex, ip) => {
+    if (failed)
+      return;
+    if (ex) {
+      failed = true;
+    } else {
+      ips.set(address, ip);
+      if (--pending !== 0)
+        return;
+    }
+
+    defaultTriggerAsyncIdScope(
+      this[async_id_symbol],
+      doSendBatch,
+      ex, this, list, ports, addresses.map((address) => ips.get(address)),
+      !!gso, callback
+    );
+  };
+
+  for (i = 0; i < count; i++) {
+    if (!ips.has(addresses[i])) {
+      ips.set(addresses[i], undefined);
+      pending++;
+    }
+  }
+  for (const address of ips.keys())
+    state.handle.lookup(address, afterDns.bind(null, address));
+};
+
+function doSendBatch(ex, self, list, ports, ips, gso, callback) {
+  const state = self[kStateSymbol];
+
+  if (ex) {
+    if (typeof callback === 'function') {
+      process.nextTick(callback, ex);
+      return;
+    }
+
+    process.nextTick(() => self.emit('error', ex));
+    return;
+  } else if (!state.handle) {
+    return;
+  }
+
+  const req = new SendWrap();
+  req.list = list;  // Keep reference alive.
+  if (callback) {
+    req.callback = callback;
+    req.oncomplete = afterSendBatch;
+  }
+
+  const inFlight = state.handle.sendBatch(req, list, ports, ips,
+                                          !!callback, gso);
+
+  if (inFlight < 0) {
+    // Don't emit as error, like send().
+    if (callback)
+      process.nextTick(callback, errnoException(inFlight, 'sendBatch'));
+  } else if (inFlight === 0 && callback) {
+    // Every datagram was written synchronously.
+    let sent = 0;
+    for (var i = 0; i < list.length; i++)
+      sent += list[i].length;
+    process.nextTick(callback, null, sent);
+  }
+}
+
+function afterSendBatch(err, sent) {
+  this.callback(err ? errnoException(err, 'sendBatch') : null, sent);
+}
+
 function afterSend(err, sent) {
   if (err) {
     err = exceptionWithHostPort(err, 'send', this.address, this.port);
@@ -687,6 +844,28 @@ function onMessage(nread, handle, buf, rinfo) {
 }
 
 
+// Called once per recvmmsg() batch when the socket was created with the
+// `recvBatch` option. All messages share `buf`, `info` holds an
+// (offset, length, address, family, port) tuple for each of them.
+function onMessageBatch(count, handle, buf, info) {
+  const self = handle[owner_symbol];
+  const state = self[kStateSymbol];
+  for (var i = 0; i < info.length; i += 5) {
+    // A 'message' listener may have closed the socket.
+    if (!state.receiving)
+      return;
+    const offset = info[i];
+    const length = info[i + 1];
+    self.emit('message', buf.slice(offset, offset + length), {
+      address: info[i + 2],
+      family: info[i + 3],
+      port: info[i + 4],
+      size: length
+    });
+  }
+}
+
+
 Socket.prototype.ref = function() {
   const handle = this[kStateSymbol].handle;
 
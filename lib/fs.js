@@ -95,6 +95,7 @@ let watchers;
 let ReadFileContext;
 let ReadStream;
 let WriteStream;
+let Walker;
 
 // These have to be separate because of how graceful-fs happens to do it's
 // monkeypatching.
@@ -1779,6 +1780,55 @@ function copyFileSync(src, dest, flags) {
   handleErrorFromBinding(ctx);
 }
 
+
+function copyDir(src, dest, flags, callback) {
+  if (typeof flags === 'function') {
+    callback = flags;
+    flags = 0;
+  } else if (typeof callback !== 'function') {
+    throw new ERR_INVALID_CALLBACK();
+  }
+
+  src = toPathIfFileURL(src);
+  dest = toPathIfFileURL(dest);
+  validatePath(src, 'src');
+  validatePath(dest, 'dest');
+
+  // The error paths are those of the entry that failed, so resolve both
+  // roots up front for them to be meaningful.
+  src = pathModule.toNamespacedPath(pathModule.resolve(src));
+  dest = pathModule.toNamespacedPath(pathModule.resolve(dest));
+  flags = flags | 0;
+  const req = new FSReqCallback();
+  req.oncomplete = makeCallback(callback);
+  binding.copyDir(src, dest, flags, req);
+}
+
+
+function copyDirSync(src, dest, flags) {
+  src = toPathIfFileURL(src);
+  dest = toPathIfFileURL(dest);
+  validatePath(src, 'src');
+  validatePath(dest, 'dest');
+
+  const ctx = {};
+  src = pathModule.toNamespacedPath(pathModule.resolve(src));
+  dest = pathModule.toNamespacedPath(pathModule.resolve(dest));
+  flags = flags | 0;
+  binding.copyDir(src, dest, flags, undefined, ctx);
+  handleErrorFromBinding(ctx);
+}
+
+function lazyLoadWalker() {
+  if (Walker === undefined)
+    ({ Walker } = require('internal/fs/walk'));
+}
+
+function walk(root, options) {
+  lazyLoadWalker();
+  return new Walker(root, options);
+}
+
 function lazyLoadStreams() {
   if (!ReadStream) {
     ({ ReadStream, WriteStream } = require('internal/fs/streams'));
@@ -1810,6 +1860,8 @@ module.exports = fs = {
   closeSync,
   copyFile,
   copyFileSync,
+  copyDir,
+  copyDirSync,
   createReadStream,
   createWriteStream,
   exists,
@@ -1867,6 +1919,7 @@ module.exports = fs = {
   unlinkSync,
   utimes,
   utimesSync,
+  walk,
   watch,
   watchFile,
   writeFile,
@@ -1894,6 +1947,11 @@ module.exports = fs = {
     WriteStream = val;
   },
 
+  get Walker() {
+    lazyLoadWalker();
+    return Walker;
+  },
+
   // Legacy names... these have to be separate because of how graceful-fs
   // (and possibly other) modules monkey patch the values.
   get FileReadStream() {
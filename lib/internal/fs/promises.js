@@ -191,6 +191,17 @@ async function copyFile(src, dest, flags) {
                           flags, kUsePromises);
 }
 
+async function copyDir(src, dest, flags) {
+  src = toPathIfFileURL(src);
+  dest = toPathIfFileURL(dest);
+  validatePath(src, 'src');
+  validatePath(dest, 'dest');
+  flags = flags | 0;
+  return binding.copyDir(pathModule.toNamespacedPath(pathModule.resolve(src)),
+                         pathModule.toNamespacedPath(pathModule.resolve(dest)),
+                         flags, kUsePromises);
+}
+
 // Note that unlike fs.open() which uses numeric file descriptors,
 // fsPromises.open() uses the fs.FileHandle class.
 async function open(path, flags, mode) {
@@ -494,6 +505,7 @@ async function readFile(path, options) {
 module.exports = {
   access,
   copyFile,
+  copyDir,
   open,
   rename,
   truncate,
@@ -0,0 +1,210 @@
+'use strict';
+
+const { DirWalker, kFsStatsFieldsNumber } = internalBinding('fs');
+const { UV_DIRENT_DIR } = internalBinding('constants').fs;
+const { ERR_INVALID_ARG_TYPE } = require('internal/errors').codes;
+const {
+  Dirent,
+  getStatsFromBinding,
+  validatePath
+} = require('internal/fs/utils');
+const { toPathIfFileURL } = require('internal/url');
+const { validateInt32 } = require('internal/validators');
+const pathModule = require('path');
+
+const kHandle = Symbol('kHandle');
+const kOwner = Symbol('kOwner');
+const kRoot = Symbol('kRoot');
+const kDirs = Symbol('kDirs');
+const kExcluded = Symbol('kExcluded');
+const kNewlyExcluded = Symbol('kNewlyExcluded');
+const kRequests = Symbol('kRequests');
+const kDone = Symbol('kDone');
+const kWithFileTypes = Symbol('kWithFileTypes');
+const kStat = Symbol('kStat');
+const kFilter = Symbol('kFilter');
+const kReadBatch = Symbol('kReadBatch');
+const kProcessBatch = Symbol('kProcessBatch');
+
+class WalkDirent extends Dirent {
+  constructor(name, type, path, ino) {
+    super(name, type);
+    this.path = path;
+    this.ino = ino;
+    this.stats = undefined;
+  }
+}
+
+// Called by the native walker with a whole batch of entries as flat arrays.
+// `parents` holds, for each entry, the number of the directory it is in;
+// directories are numbered in the order in which they are reported, with
+// the root being 0, so that their paths are only ever built once.
+function onBatch(err, names, types, inodes, parents, stats, done) {
+  const walker = this[kOwner];
+  if (err) {
+    walker[kDone] = true;
+    walker[kRequests].shift().reject(err);
+    walker.close();
+    return;
+  }
+
+  walker[kDone] = done;
+  let entries;
+  try {
+    entries = walker[kProcessBatch](names, types, inodes, parents, stats);
+  } catch (err) {
+    // The filter threw.
+    walker[kRequests].shift().reject(err);
+    walker.close();
+    return;
+  }
+  if (entries.length === 0 && !done) {
+    // Everything was filtered out; there is no point in waking up the reader.
+    walker[kReadBatch]();
+    return;
+  }
+
+  // The last batch can be empty, e.g. for an empty root; readers are
+  // told that the walk is over instead.
+  walker[kRequests].shift().resolve(entries.length > 0 ? entries : null);
+  if (walker[kRequests].length > 0) {
+    if (done) {
+      for (const request of walker[kRequests].splice(0))
+        request.resolve(null);
+    } else {
+      walker[kReadBatch]();
+    }
+  }
+}
+
+class Walker {
+  constructor(root, options = {}) {
+    root = toPathIfFileURL(root);
+    validatePath(root, 'root');
+    if (typeof root !== 'string')
+      root = root.toString();
+
+    if (options === null || typeof options !== 'object')
+      throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+    const { withFileTypes = false, stat = false, filter } = options;
+    let { maxDepth = Infinity } = options;
+    if (maxDepth === Infinity)
+      maxDepth = -1;
+    else
+      validateInt32(maxDepth, 'options.maxDepth', 0);
+    if (filter !== undefined && typeof filter !== 'function')
+      throw new ERR_INVALID_ARG_TYPE('options.filter', 'Function', filter);
+
+    const handle = new DirWalker(pathModule.toNamespacedPath(root), maxDepth,
+                                 !!stat);
+    handle[kOwner] = this;
+    handle.oncomplete = onBatch;
+
+    this[kHandle] = handle;
+    this[kRoot] = root;
+    this[kDirs] = [root.endsWith(pathModule.sep) ? root :
+      root + pathModule.sep];
+    this[kExcluded] = filter !== undefined ? new Set() : null;
+    this[kNewlyExcluded] = [];
+    this[kRequests] = [];
+    this[kDone] = false;
+    this[kWithFileTypes] = !!withFileTypes || !!stat;
+    this[kStat] = !!stat;
+    this[kFilter] = filter;
+  }
+
+  get path() {
+    return this[kRoot];
+  }
+
+  read() {
+    if (this[kDone] && this[kRequests].length === 0)
+      return Promise.resolve(null);
+    return new Promise((resolve, reject) => {
+      this[kRequests].push({ resolve, reject });
+      if (this[kRequests].length === 1)
+        this[kReadBatch]();
+    });
+  }
+
+  close() {
+    if (this[kHandle] === null)
+      return;
+    this[kHandle].close();
+    this[kHandle] = null;
+    this[kDone] = true;
+    for (const request of this[kRequests].splice(0))
+      request.resolve(null);
+  }
+
+  async* [Symbol.asyncIterator]() {
+    try {
+      let entries;
+      while ((entries = await this.read()) !== null) {
+        for (const entry of entries)
+          yield entry;
+      }
+    } finally {
+      this.close();
+    }
+  }
+
+  [kReadBatch]() {
+    const newlyExcluded = this[kNewlyExcluded];
+    if (newlyExcluded.length > 0) {
+      this[kNewlyExcluded] = [];
+      this[kHandle].read(new Uint32Array(newlyExcluded));
+    } else {
+      this[kHandle].read();
+    }
+  }
+
+  [kProcessBatch](names, types, inodes, parents, stats) {
+    const dirs = this[kDirs];
+    const excluded = this[kExcluded];
+    const withFileTypes = this[kWithFileTypes];
+    const stat = this[kStat];
+    const filter = this[kFilter];
+    const entries = [];
+
+    for (let i = 0; i < names.length; i++) {
+      const name = names[i];
+      const type = types[i];
+      const parent = parents[i];
+      const path = dirs[parent] + name;
+      // Every directory gets a number, whether it is reported or not.
+      const id = type === UV_DIRENT_DIR ?
+        dirs.push(path + pathModule.sep) - 1 : -1;
+
+      if (excluded !== null && excluded.has(parent)) {
+        if (id !== -1) {
+          excluded.add(id);
+          this[kNewlyExcluded].push(id);
+        }
+        continue;
+      }
+
+      let entry = path;
+      if (withFileTypes) {
+        entry = new WalkDirent(name, type, path, inodes[i]);
+        if (stat)
+          entry.stats = getStatsFromBinding(stats, i * kFsStatsFieldsNumber);
+      }
+
+      if (filter !== undefined && !filter(entry)) {
+        if (id !== -1) {
+          excluded.add(id);
+          this[kNewlyExcluded].push(id);
+        }
+        continue;
+      }
+      entries.push(entry);
+    }
+
+    return entries;
+  }
+}
+
+module.exports = {
+  Walker
+};
@@ -122,16 +122,9 @@ const { format } = require('internal/util/inspect');
 
 const hasOwnProperty = Object.prototype.hasOwnProperty;
 
-const { FileHandle } = internalBinding('fs');
 const binding = internalBinding('http2');
-const {
-  ShutdownWrap,
-  kReadBytesOrError,
-  streamBaseState
-} = internalBinding('stream_wrap');
-const { UV_EOF } = internalBinding('uv');
+const { ShutdownWrap } = internalBinding('stream_wrap');
 
-const { StreamPipe } = internalBinding('stream_pipe');
 const { _connectionListener: httpConnectionListener } = http;
 const debug = require('internal/util/debuglog').debuglog('http2');
 
@@ -835,6 +828,8 @@ function setupHandle(socket, type, options) {
   if (typeof options.selectPadding === 'function')
     this[kSelectPadding] = options.selectPadding;
   handle.consume(socket._handle);
+  if (this[kState].corked > 0)
+    handle.cork();
 
   this[kHandle] = handle;
 
@@ -947,6 +942,7 @@ class Http2Session extends EventEmitter {
       pendingStreams: new Set(),
       pendingAck: 0,
       writeQueueSize: 0,
+      corked: 0,
       originSet: undefined
     };
 
@@ -1292,6 +1288,23 @@ class Http2Session extends EventEmitter {
     this.emit('timeout');
   }
 
+  // Holds back frames until uncork() has been called as many times as cork(),
+  // so that those of several streams are written to the socket together.
+  cork() {
+    if (this.destroyed)
+      throw new ERR_HTTP2_INVALID_SESSION();
+    if (this[kState].corked++ === 0 && this[kHandle] !== undefined)
+      this[kHandle].cork();
+  }
+
+  uncork() {
+    const state = this[kState];
+    if (state.corked === 0)
+      return;
+    if (--state.corked === 0 && this[kHandle] !== undefined)
+      this[kHandle].uncork();
+  }
+
   ref() {
     if (this[kSocket]) {
       this[kSocket].ref();
@@ -2022,27 +2035,6 @@ function processHeaders(oldHeaders) {
   return headers;
 }
 
-function onFileCloseError(stream, err) {
-  stream.emit(err);
-}
-
-function onFileUnpipe() {
-  const stream = this.sink[kOwner];
-  if (stream.ownsFd)
-    this.source.close().catch(onFileCloseError.bind(stream));
-  else
-    this.source.releaseFD();
-}
-
-// This is only called once the pipe has returned back control, so
-// it only has to handle errors and End-of-File.
-function onPipedFileHandleRead() {
-  const err = streamBaseState[kReadBytesOrError];
-  if (err < 0 && err !== UV_EOF) {
-    this.stream.close(NGHTTP2_INTERNAL_ERROR);
-  }
-}
-
 function processRespondWithFD(self, fd, headers, offset = 0, length = -1,
                               streamOptions = 0) {
   const state = self[kState];
@@ -2073,14 +2065,10 @@ function processRespondWithFD(self, fd, headers, offset = 0, length = -1,
                              self, fd, offset, length);
 }
 
+// The file is read on the threadpool and its contents are queued for the
+// stream natively, read errors reset the stream with NGHTTP2_INTERNAL_ERROR.
 function startFilePipe(self, fd, offset, length) {
-  const handle = new FileHandle(fd, offset, length);
-  handle.onread = onPipedFileHandleRead;
-  handle.stream = self;
-
-  const pipe = new StreamPipe(handle, self[kHandle]);
-  pipe.onunpipe = onFileUnpipe;
-  pipe.start();
+  self[kHandle].sendFileData(fd, offset, length, self.ownsFd);
 
   // Exact length of the file doesn't matter here, since the
   // stream is closing anyway - just use 1 to signify that
@@ -192,7 +192,8 @@ const IDX_OPTIONS_MAX_HEADER_LIST_PAIRS = 5;
 const IDX_OPTIONS_MAX_OUTSTANDING_PINGS = 6;
 const IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS = 7;
 const IDX_OPTIONS_MAX_SESSION_MEMORY = 8;
-const IDX_OPTIONS_FLAGS = 9;
+const IDX_OPTIONS_WRITE_COALESCING_THRESHOLD = 9;
+const IDX_OPTIONS_FLAGS = 10;
 
 function updateOptionsBuffer(options) {
   var flags = 0;
@@ -241,6 +242,11 @@ function updateOptionsBuffer(options) {
     optionsBuffer[IDX_OPTIONS_MAX_SESSION_MEMORY] =
       Math.max(1, options.maxSessionMemory);
   }
+  if (typeof options.writeCoalescingThreshold === 'number') {
+    flags |= (1 << IDX_OPTIONS_WRITE_COALESCING_THRESHOLD);
+    optionsBuffer[IDX_OPTIONS_WRITE_COALESCING_THRESHOLD] =
+      Math.max(0, options.writeCoalescingThreshold);
+  }
   optionsBuffer[IDX_OPTIONS_FLAGS] = flags;
 }
 
@@ -31,6 +31,9 @@ const internalFS = require('internal/fs/utils');
 const path = require('path');
 const {
   internalModuleReadJSON,
+  internalModuleReadPackageJSON,
+  internalModuleResolutionCacheLookup,
+  internalModuleResolutionCacheRecord,
   internalModuleStat
 } = internalBinding('fs');
 const { safeGetenv } = internalBinding('credentials');
@@ -44,10 +47,16 @@ const { getOptionValue } = require('internal/options');
 const preserveSymlinks = getOptionValue('--preserve-symlinks');
 const preserveSymlinksMain = getOptionValue('--preserve-symlinks-main');
 const experimentalModules = getOptionValue('--experimental-modules');
+const useResolutionCache = getOptionValue('--module-resolution-cache') !== '';
 const manifest = getOptionValue('--experimental-policy') ?
   require('internal/process/policy').manifest :
   null;
-const { compileFunction } = internalBinding('contextify');
+const {
+  compileFunction,
+  getCompileCache,
+  storeCompileCache
+} = internalBinding('contextify');
+const useCompileCache = getOptionValue('--code-cache-dir') !== '';
 
 const {
   ERR_INVALID_ARG_VALUE,
@@ -205,6 +214,19 @@ function readPackage(requestPath) {
     return entry;
 
   const jsonPath = path.resolve(requestPath, 'package.json');
+
+  // Policy integrity checks need the full source text, so only take the
+  // native fast path when there is no manifest. It returns undefined for a
+  // missing file and null when the file has to be parsed in full.
+  if (!manifest) {
+    const fields =
+      internalModuleReadPackageJSON(path.toNamespacedPath(jsonPath));
+    if (fields === undefined)
+      return false;
+    if (fields !== null)
+      return packageMainCache[requestPath] = fields[0];
+  }
+
   const json = internalModuleReadJSON(path.toNamespacedPath(jsonPath));
 
   if (json === undefined) {
@@ -332,6 +354,22 @@ Module._findPath = function(request, paths, isMain) {
   if (entry)
     return entry;
 
+  // The persistent cache is not used for the main module, which follows its
+  // own symlink rules. --preserve-symlinks changes the result, so it is part
+  // of the key.
+  var persistentKey;
+  // The directories and package.json files that the search looks at. A
+  // change to any of them, e.g. a new file or a different "main", can change
+  // the result, so the persistent cache validates them along with it.
+  var dependencies;
+  if (useResolutionCache && !isMain) {
+    persistentKey = (preserveSymlinks ? '1' : '0') + cacheKey;
+    entry = internalModuleResolutionCacheLookup(persistentKey);
+    if (entry !== undefined)
+      return Module._pathCache[cacheKey] = entry;
+    dependencies = [];
+  }
+
   var exts;
   var trailingSlash = request.length > 0 &&
     request.charCodeAt(request.length - 1) === CHAR_FORWARD_SLASH;
@@ -343,11 +381,23 @@ Module._findPath = function(request, paths, isMain) {
   for (var i = 0; i < paths.length; i++) {
     // Don't search further if path doesn't exist
     const curPath = paths[i];
+    if (dependencies !== undefined && curPath)
+      dependencies.push(path.toNamespacedPath(curPath));
     if (curPath && stat(curPath) < 1) continue;
     var basePath = path.resolve(curPath, request);
     var filename;
 
     var rc = stat(basePath);
+    if (dependencies !== undefined) {
+      const baseDir = path.dirname(basePath);
+      if (baseDir !== curPath)
+        dependencies.push(path.toNamespacedPath(baseDir));
+      if (rc === 1) {
+        dependencies.push(path.toNamespacedPath(basePath),
+                          path.toNamespacedPath(
+                            path.resolve(basePath, 'package.json')));
+      }
+    }
     if (!trailingSlash) {
       if (rc === 0) {  // File.
         if (!isMain) {
@@ -400,6 +450,9 @@ Module._findPath = function(request, paths, isMain) {
       }
 
       Module._pathCache[cacheKey] = filename;
+      if (persistentKey !== undefined && !(request === '.' && i > 0))
+        internalModuleResolutionCacheRecord(persistentKey, filename,
+                                            dependencies);
       return filename;
     }
   }
@@ -775,6 +828,7 @@ Module.prototype._compile = function(content, filename) {
   content = stripShebang(content);
 
   let compiledWrapper;
+  let compileCacheKey;
   if (patched) {
     const wrapper = Module.wrap(content);
     compiledWrapper = vm.runInThisContext(wrapper, {
@@ -788,12 +842,15 @@ Module.prototype._compile = function(content, filename) {
       } : undefined,
     });
   } else {
+    let cachedData;
+    if (useCompileCache)
+      [compileCacheKey, cachedData] = getCompileCache(content);
     compiledWrapper = compileFunction(
       content,
       filename,
       0,
       0,
-      undefined,
+      cachedData,
       false,
       undefined,
       [],
@@ -805,6 +862,9 @@ Module.prototype._compile = function(content, filename) {
         '__dirname',
       ]
     );
+    // A cache that was accepted does not need to be written again.
+    if (cachedData !== undefined && !compiledWrapper.cachedDataRejected)
+      compileCacheKey = undefined;
     if (experimentalModules) {
       const { callbackMap } = internalBinding('module_wrap');
       callbackMap.set(compiledWrapper, {
@@ -847,6 +907,10 @@ Module.prototype._compile = function(content, filename) {
     result = compiledWrapper.call(thisValue, exports, require, module,
                                   filename, dirname);
   }
+  // Produce the cache after the module body has run, so that it includes the
+  // functions that were compiled lazily along the way.
+  if (compileCacheKey !== undefined)
+    storeCompileCache(compileCacheKey, compiledWrapper);
   if (requireDepth === 0) statCache = null;
   return result;
 };
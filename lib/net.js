@@ -64,7 +64,10 @@ const {
   kAfterAsyncWrite,
   kHandle,
   kUpdateTimer,
-  setStreamTimeout
+  setStreamTimeout,
+  kBuffer,
+  kBufferCb,
+  kBufferGen
 } = require('internal/stream_base_commons');
 const {
   codes: {
@@ -74,6 +77,7 @@ const {
     ERR_INVALID_FD_TYPE,
     ERR_INVALID_IP_ADDRESS,
     ERR_INVALID_OPT_VALUE,
+    ERR_INVALID_RETURN_VALUE,
     ERR_SERVER_ALREADY_LISTEN,
     ERR_SERVER_NOT_RUNNING,
     ERR_SOCKET_BAD_PORT,
@@ -83,8 +87,10 @@ const {
   exceptionWithHostPort,
   uvExceptionWithHostPort
 } = require('internal/errors');
+const { isUint8Array } = require('internal/util/types');
 const { validateInt32, validateString } = require('internal/validators');
 const kLastWriteQueueSize = Symbol('lastWriteQueueSize');
+const kReceiveSlab = Symbol('kReceiveSlab');
 const {
   DTRACE_NET_SERVER_CONNECTION,
   DTRACE_NET_STREAM_END
@@ -223,6 +229,22 @@ function initSocketHandle(self) {
     self._handle[owner_symbol] = self;
     self._handle.onread = onStreamRead;
     self[async_id_symbol] = getNewAsyncId(self._handle);
+    if (self[kReceiveSlab] && typeof self._handle.useReceiveSlab === 'function')
+      self._handle.useReceiveSlab();
+
+    let userBuf = self[kBuffer];
+    if (userBuf) {
+      const bufGen = self[kBufferGen];
+      if (bufGen !== null) {
+        userBuf = bufGen();
+        if (!isUint8Array(userBuf)) {
+          throw new ERR_INVALID_RETURN_VALUE('a Buffer or Uint8Array',
+                                             'onread.buffer', userBuf);
+        }
+        self[kBuffer] = userBuf;
+      }
+      self._handle.useUserBuffer(userBuf);
+    }
   }
 }
 
@@ -265,6 +287,26 @@ function Socket(options) {
 
   // Default to *not* allowing half open sockets.
   this.allowHalfOpen = Boolean(allowHalfOpen);
+  this[kReceiveSlab] = Boolean(options.receiveSlab);
+
+  // Read into a buffer supplied by the user instead of allocating a new one
+  // for each read. The data is passed to `onread.callback` instead of being
+  // emitted through 'data' events.
+  this[kBuffer] = null;
+  this[kBufferCb] = null;
+  this[kBufferGen] = null;
+  const { onread } = options;
+  if (onread !== null && typeof onread === 'object' &&
+      (isUint8Array(onread.buffer) || typeof onread.buffer === 'function') &&
+      typeof onread.callback === 'function') {
+    if (typeof onread.buffer === 'function') {
+      this[kBuffer] = true;
+      this[kBufferGen] = onread.buffer;
+    } else {
+      this[kBuffer] = onread.buffer;
+    }
+    this[kBufferCb] = onread.callback;
+  }
 
   if (options.handle) {
     this._handle = options.handle; // private
@@ -1116,6 +1158,7 @@ function Server(options, connectionListener) {
 
   this.allowHalfOpen = options.allowHalfOpen || false;
   this.pauseOnConnect = !!options.pauseOnConnect;
+  this.receiveSlab = !!options.receiveSlab;
 }
 Object.setPrototypeOf(Server.prototype, EventEmitter.prototype);
 Object.setPrototypeOf(Server, EventEmitter);
@@ -1465,6 +1508,7 @@ function onconnection(err, clientHandle) {
     handle: clientHandle,
     allowHalfOpen: self.allowHalfOpen,
     pauseOnCreate: self.pauseOnConnect,
+    receiveSlab: self.receiveSlab,
     readable: true,
     writable: true
   });
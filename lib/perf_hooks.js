@@ -2,6 +2,7 @@
 
 const {
   ELDHistogram: _ELDHistogram,
+  ThreadpoolMonitor: _ThreadpoolMonitor,
   PerformanceEntry,
   mark: _mark,
   clearMark: _clearMark,
@@ -13,7 +14,8 @@ const {
   timeOriginTimestamp,
   timerify,
   constants,
-  setupGarbageCollectionTracking
+  setupGarbageCollectionTracking,
+  getThreadpoolStats: _getThreadpoolStats
 } = internalBinding('performance');
 
 const {
@@ -47,6 +49,7 @@ const {
 
 const kHandle = Symbol('handle');
 const kMap = Symbol('map');
+const kHistogramIndex = Symbol('histogram-index');
 const kCallback = Symbol('callback');
 const kTypes = Symbol('types');
 const kEntries = Symbol('entries');
@@ -86,6 +89,8 @@ const IDX_SESSION_STATS_STREAMAVERAGEDURATION = 5;
 const IDX_SESSION_STATS_DATA_SENT = 6;
 const IDX_SESSION_STATS_DATA_RECEIVED = 7;
 const IDX_SESSION_STATS_MAX_CONCURRENT_STREAMS = 8;
+const IDX_SESSION_STATS_WRITE_COUNT = 9;
+const IDX_SESSION_STATS_WRITE_BUFFER_COUNT = 10;
 
 let sessionStats;
 let streamStats;
@@ -130,6 +135,10 @@ function collectHttp2Stats(entry) {
         sessionStats[IDX_SESSION_STATS_DATA_RECEIVED];
       entry.maxConcurrentStreams =
         sessionStats[IDX_SESSION_STATS_MAX_CONCURRENT_STREAMS];
+      entry.writeCount =
+        sessionStats[IDX_SESSION_STATS_WRITE_COUNT];
+      entry.writeBufferCount =
+        sessionStats[IDX_SESSION_STATS_WRITE_BUFFER_COUNT];
       break;
   }
 }
@@ -588,6 +597,109 @@ class ELDHistogram {
   }
 }
 
+// Keep in sync with `ThreadpoolStatsFields` in src/node_perf.h, the pools are
+// in the order of libuv's `uv_work_kind`.
+const kThreadpoolStatsFieldsCount = 10;
+const threadpoolStatsValues = new Float64Array(3 * kThreadpoolStatsFieldsCount);
+
+function threadpoolStats(index) {
+  const offset = index * kThreadpoolStatsFieldsCount;
+  return {
+    threads: threadpoolStatsValues[offset],
+    idleThreads: threadpoolStatsValues[offset + 1],
+    queued: threadpoolStatsValues[offset + 2],
+    maxQueued: threadpoolStatsValues[offset + 3],
+    running: threadpoolStatsValues[offset + 4],
+    submitted: threadpoolStatsValues[offset + 5],
+    completed: threadpoolStatsValues[offset + 6],
+    waitTime: threadpoolStatsValues[offset + 7],
+    maxWaitTime: threadpoolStatsValues[offset + 8],
+    runTime: threadpoolStatsValues[offset + 9]
+  };
+}
+
+function getThreadpoolStats() {
+  _getThreadpoolStats(threadpoolStatsValues);
+  return {
+    cpu: threadpoolStats(0),
+    fastIO: threadpoolStats(1),
+    slowIO: threadpoolStats(2)
+  };
+}
+
+// One of the histograms of a ThreadpoolMonitor, which has the methods that
+// read them take the index of the histogram.
+class ThreadpoolHistogram {
+  constructor(handle, index) {
+    this[kHandle] = handle;
+    this[kHistogramIndex] = index;
+    this[kMap] = new Map();
+  }
+
+  get exceeds() { return this[kHandle].exceeds(this[kHistogramIndex]); }
+  get min() { return this[kHandle].min(this[kHistogramIndex]); }
+  get max() { return this[kHandle].max(this[kHistogramIndex]); }
+  get mean() { return this[kHandle].mean(this[kHistogramIndex]); }
+  get stddev() { return this[kHandle].stddev(this[kHistogramIndex]); }
+  percentile(percentile) {
+    if (typeof percentile !== 'number') {
+      throw new ERR_INVALID_ARG_TYPE('percentile', 'number', percentile);
+    }
+    if (percentile <= 0 || percentile > 100) {
+      throw new ERR_INVALID_ARG_VALUE.RangeError('percentile',
+                                                 percentile);
+    }
+    return this[kHandle].percentile(this[kHistogramIndex], percentile);
+  }
+  get percentiles() {
+    this[kMap].clear();
+    this[kHandle].percentiles(this[kHistogramIndex], this[kMap]);
+    return this[kMap];
+  }
+
+  [kInspect]() {
+    return {
+      min: this.min,
+      max: this.max,
+      mean: this.mean,
+      stddev: this.stddev,
+      percentiles: this.percentiles,
+      exceeds: this.exceeds
+    };
+  }
+}
+
+class ThreadpoolMonitor {
+  constructor(handle) {
+    this[kHandle] = handle;
+    // The histograms are laid out as in src/node_perf.h, a pair of wait and
+    // run times per kind of work.
+    const pools = ['cpu', 'fastIO', 'slowIO'];
+    for (var i = 0; i < pools.length; i++) {
+      this[pools[i]] = {
+        waitTime: new ThreadpoolHistogram(handle, 2 * i),
+        runTime: new ThreadpoolHistogram(handle, 2 * i + 1)
+      };
+    }
+  }
+
+  reset() { this[kHandle].reset(); }
+  enable() { return this[kHandle].enable(); }
+  disable() { return this[kHandle].disable(); }
+
+  [kInspect]() {
+    return {
+      cpu: this.cpu,
+      fastIO: this.fastIO,
+      slowIO: this.slowIO
+    };
+  }
+}
+
+function monitorThreadpool() {
+  return new ThreadpoolMonitor(new _ThreadpoolMonitor());
+}
+
 function monitorEventLoopDelay(options = {}) {
   if (typeof options !== 'object' || options === null) {
     throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
@@ -606,7 +718,9 @@ function monitorEventLoopDelay(options = {}) {
 module.exports = {
   performance,
   PerformanceObserver,
-  monitorEventLoopDelay
+  monitorEventLoopDelay,
+  monitorThreadpool,
+  getThreadpoolStats
 };
 
 Object.defineProperty(module.exports, 'constants', {
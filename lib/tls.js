@@ -77,6 +77,11 @@ exports.getCiphers = internalUtil.cachedResult(
   () => internalUtil.filterDuplicateStrings(binding.getSSLCiphers(), true)
 );
 
+exports.getSharedSessionCacheStats = function getSharedSessionCacheStats() {
+  const [hits, misses, size] = binding.getSharedSessionCacheStats();
+  return { hits, misses, size };
+};
+
 // Convert protocols array into valid OpenSSL protocols list
 // ("\x06spdy/2\x08http/1.1\x08http/1.0")
 function convertProtocols(protocols) {
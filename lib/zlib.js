@@ -62,6 +62,21 @@ const {
   BROTLI_OPERATION_PROCESS, BROTLI_OPERATION_FLUSH,
   BROTLI_OPERATION_FINISH
 } = constants;
+const { PARALLEL_DEFLATE_BLOCK_SIZE } = binding;
+
+// Upper bound for the `parallel` option.
+const kMaxParallel = 256;
+const kParallel = Symbol('kParallel');
+
+// Zlib handles of streams created with `pool: true` are reset and kept for
+// reuse by later streams with the same parameters, instead of being closed,
+// so that the window and hash state of zlib is not allocated and initialized
+// again for every stream. Idle handles remain ordinary ZlibStream objects, so
+// their memory stays accounted for in heap snapshots.
+const kMaxPooledHandles = 16;
+const kPoolKey = Symbol('kPoolKey');
+const kWriteState = Symbol('kWriteState');
+const handlePool = new Map();
 
 // Translation table for return codes.
 const codes = {
@@ -295,6 +310,8 @@ Object.defineProperty(ZlibBase.prototype, 'bytesRead', {
 ZlibBase.prototype.reset = function() {
   if (!this._handle)
     assert(false, 'zlib binding closed');
+  if (this[kParallel])
+    this[kParallel] = new ParallelState(this[kParallel].limit);
   return this._handle.reset();
 };
 
@@ -369,7 +386,10 @@ ZlibBase.prototype._transform = function(chunk, encoding, cb) {
   if ((ws.ending || ws.ended) && ws.length === chunk.byteLength) {
     flushFlag = maxFlush(flushFlag, this._finishFlushFlag);
   }
-  processChunk(this, chunk, flushFlag, cb);
+  if (this[kParallel])
+    processParallelChunk(this, chunk, flushFlag, cb);
+  else
+    processChunk(this, chunk, flushFlag, cb);
 };
 
 ZlibBase.prototype._processChunk = function(chunk, flushFlag, cb) {
@@ -381,6 +401,9 @@ ZlibBase.prototype._processChunk = function(chunk, flushFlag, cb) {
 };
 
 function processChunkSync(self, chunk, flushFlag) {
+  if (self[kParallel])
+    return processParallelChunkSync(self, chunk, flushFlag);
+
   var availInBefore = chunk.byteLength;
   var availOutBefore = self._chunkSize - self._outOffset;
   var inOff = 0;
@@ -560,6 +583,115 @@ function processCallback() {
   this.cb();
 }
 
+// Streams created with the `parallel` option cut their input into blocks of
+// PARALLEL_DEFLATE_BLOCK_SIZE bytes, which are compressed concurrently on the
+// threadpool. At most `parallel` blocks are in flight at any time. The
+// compressed blocks are passed back in order by processParallelCallback().
+function processParallelChunk(self, chunk, flushFlag, cb) {
+  assert(self._handle, 'zlib binding closed');
+  const state = self[kParallel];
+  if (chunk.byteLength > 0) {
+    state.buffered.push(chunk);
+    state.bufferedLength += chunk.byteLength;
+  }
+  state.flushFlag = flushFlag;
+  state.callback = cb;
+  writeParallelBlocks(self);
+}
+
+function writeParallelBlocks(self) {
+  const state = self[kParallel];
+  while (state.inFlight < state.limit &&
+         state.bufferedLength >= PARALLEL_DEFLATE_BLOCK_SIZE) {
+    writeParallelBlock(self, PARALLEL_DEFLATE_BLOCK_SIZE, Z_NO_FLUSH);
+  }
+  if (state.bufferedLength >= PARALLEL_DEFLATE_BLOCK_SIZE)
+    return;
+
+  const flushFlag = state.flushFlag;
+  if (flushFlag !== Z_NO_FLUSH) {
+    if (state.inFlight >= state.limit)
+      return;
+    // Every block ends on a byte boundary already, so flushing only means
+    // writing the buffered data as a block of its own and waiting for it.
+    if (flushFlag === Z_FINISH) {
+      if (!state.finished) {
+        writeParallelBlock(self, state.bufferedLength, Z_FINISH);
+        state.finished = true;
+      }
+    } else if (state.bufferedLength > 0) {
+      writeParallelBlock(self, state.bufferedLength, flushFlag);
+    }
+    state.flushFlag = Z_NO_FLUSH;
+    state.drain = true;
+  }
+  if (state.drain && state.inFlight > 0)
+    return;
+
+  state.drain = false;
+  const cb = state.callback;
+  state.callback = null;
+  cb();
+}
+
+function writeParallelBlock(self, length, flushFlag) {
+  const state = self[kParallel];
+  const first = state.buffered[0];
+  let block;
+  if (first !== undefined && first.byteLength >= length) {
+    block = first.slice(0, length);
+    if (first.byteLength === length)
+      state.buffered.shift();
+    else
+      state.buffered[0] = first.slice(length);
+  } else {
+    const buffered = Buffer.concat(state.buffered, state.bufferedLength);
+    block = buffered.slice(0, length);
+    state.buffered = length < buffered.byteLength ?
+      [buffered.slice(length)] : [];
+  }
+  state.bufferedLength -= length;
+  state.inFlight++;
+  self._handle.write(block, flushFlag);
+}
+
+function processParallelCallback(output, inputLength) {
+  // This callback's context (`this`) is the `_handle` (ParallelDeflate)
+  // object.
+  const self = this[owner_symbol];
+  const state = self[kParallel];
+  state.inFlight--;
+
+  if (self._hadError || self.destroyed)
+    return;
+
+  self.bytesWritten += inputLength;
+  if (output.byteLength > 0)
+    self.push(output);
+
+  if (state.callback !== null && !self.destroyed)
+    writeParallelBlocks(self);
+}
+
+function processParallelChunkSync(self, chunk, flushFlag) {
+  var error;
+  self.on('error', function onError(er) {
+    error = er;
+  });
+
+  const output = self._handle.writeSync(chunk, flushFlag);
+  if (error)
+    throw error;
+
+  self.bytesWritten = chunk.byteLength;
+  _close(self);
+
+  if (output.byteLength >= kMaxLength) {
+    throw new ERR_BUFFER_TOO_LARGE();
+  }
+  return output;
+}
+
 function _close(engine, callback) {
   if (callback)
     process.nextTick(callback);
@@ -568,10 +700,66 @@ function _close(engine, callback) {
   if (!engine._handle)
     return;
 
-  engine._handle.close();
+  if (engine[kPoolKey] !== undefined)
+    releasePooledHandle(engine);
+  else
+    engine._handle.close();
   engine._handle = null;
 }
 
+function takePooledHandle(key) {
+  const handles = handlePool.get(key);
+  if (handles === undefined)
+    return undefined;
+  const handle = handles.pop();
+  if (handles.length === 0)
+    handlePool.delete(key);
+  // Assign the handle a new asyncId and run any destroy()/init() hooks, so
+  // that every stream shows up as a resource of its own.
+  handle.asyncReset();
+  return handle;
+}
+
+function releasePooledHandle(engine) {
+  const handle = engine._handle;
+  const key = engine[kPoolKey];
+  let handles = handlePool.get(key);
+
+  // Handles that failed or are still in use by a write on the threadpool are
+  // not reused.
+  let reusable = !engine._hadError && !handle.buffer &&
+                 (handles === undefined || handles.length < kMaxPooledHandles);
+  if (reusable) {
+    handle.onerror = () => { reusable = false; };
+    handle.reset();
+  }
+  if (!reusable) {
+    handle.close();
+    return;
+  }
+
+  handle[owner_symbol] = null;
+  handle.onerror = null;
+  handle.buffer = null;
+  handle.cb = null;
+  if (handles === undefined) {
+    handles = [];
+    handlePool.set(key, handles);
+  }
+  handles.push(handle);
+}
+
+function ParallelState(limit) {
+  this.limit = limit;
+  this.inFlight = 0;
+  this.buffered = [];
+  this.bufferedLength = 0;
+  this.flushFlag = Z_NO_FLUSH;
+  this.callback = null;
+  this.drain = false;
+  this.finished = false;
+}
+
 const zlibDefaultOpts = {
   flush: Z_NO_FLUSH,
   finishFlush: Z_FINISH,
@@ -584,6 +772,8 @@ function Zlib(opts, mode) {
   var level = Z_DEFAULT_COMPRESSION;
   var memLevel = Z_DEFAULT_MEMLEVEL;
   var strategy = Z_DEFAULT_STRATEGY;
+  var parallel = 1;
+  var pool = false;
   var dictionary;
 
   if (opts) {
@@ -613,6 +803,16 @@ function Zlib(opts, mode) {
       opts.strategy, 'options.strategy',
       Z_DEFAULT_STRATEGY, Z_FIXED, Z_DEFAULT_STRATEGY);
 
+    parallel = checkRangesOrGetDefault(
+      opts.parallel, 'options.parallel',
+      1, kMaxParallel, 1);
+
+    if (opts.pool !== undefined) {
+      if (typeof opts.pool !== 'boolean')
+        throw new ERR_INVALID_ARG_TYPE('options.pool', 'boolean', opts.pool);
+      pool = opts.pool;
+    }
+
     dictionary = opts.dictionary;
     if (dictionary !== undefined && !isArrayBufferView(dictionary)) {
       if (isAnyArrayBuffer(dictionary)) {
@@ -627,25 +827,61 @@ function Zlib(opts, mode) {
     }
   }
 
-  const handle = new binding.Zlib(mode);
-  // Ideally, we could let ZlibBase() set up _writeState. I haven't been able
-  // to come up with a good solution that doesn't break our internal API,
-  // and with it all supported npm versions at the time of writing.
-  this._writeState = new Uint32Array(2);
-  if (!handle.init(windowBits,
-                   level,
-                   memLevel,
-                   strategy,
-                   this._writeState,
-                   processCallback,
-                   dictionary)) {
-    // TODO(addaleax): Sometimes we generate better error codes in C++ land,
-    // e.g. ERR_BROTLI_PARAM_SET_FAILED -- it's hard to access them with
-    // the current bindings setup, though.
-    throw new ERR_ZLIB_INITIALIZATION_FAILED();
+  // Blocks can only be compressed independently of each other when the whole
+  // window is available and there is no preset dictionary. Other streams
+  // ignore `parallel`.
+  const useParallel = parallel > 1 &&
+                      (mode === DEFLATE || mode === GZIP) &&
+                      windowBits === Z_MAX_WINDOWBITS &&
+                      dictionary === undefined;
+
+  let handle;
+  let poolKey;
+  if (useParallel) {
+    handle = new binding.ParallelDeflate(mode);
+    this._writeState = null;
+    if (!handle.init(level,
+                     memLevel,
+                     strategy,
+                     parallel,
+                     processParallelCallback)) {
+      throw new ERR_ZLIB_INITIALIZATION_FAILED();
+    }
+  } else {
+    // Unzip switches to either Gunzip or Inflate mode after reading the
+    // first bytes, so it cannot be reset for another stream.
+    if (pool && mode !== UNZIP && dictionary === undefined) {
+      poolKey = `${mode} ${windowBits} ${level} ${memLevel} ${strategy}`;
+      handle = takePooledHandle(poolKey);
+    }
+    if (handle !== undefined) {
+      this._writeState = handle[kWriteState];
+    } else {
+      handle = new binding.Zlib(mode);
+      // Ideally, we could let ZlibBase() set up _writeState. I haven't been
+      // able to come up with a good solution that doesn't break our internal
+      // API, and with it all supported npm versions at the time of writing.
+      this._writeState = new Uint32Array(2);
+      if (!handle.init(windowBits,
+                       level,
+                       memLevel,
+                       strategy,
+                       this._writeState,
+                       processCallback,
+                       dictionary)) {
+        // TODO(addaleax): Sometimes we generate better error codes in C++
+        // land, e.g. ERR_BROTLI_PARAM_SET_FAILED -- it's hard to access them
+        // with the current bindings setup, though.
+        throw new ERR_ZLIB_INITIALIZATION_FAILED();
+      }
+      if (poolKey !== undefined)
+        handle[kWriteState] = this._writeState;
+    }
   }
 
   ZlibBase.call(this, opts, mode, handle, zlibDefaultOpts);
+  this[kParallel] = useParallel ? new ParallelState(parallel) : null;
+  this[kPoolKey] = poolKey;
 
   this._level = level;
   this._strategy = strategy;
@@ -660,6 +896,8 @@ Object.setPrototypeOf(Zlib, ZlibBase);
 function paramsAfterFlushCallback(level, strategy, callback) {
   assert(this._handle, 'zlib binding closed');
   this._handle.params(level, strategy);
+  // The handle no longer matches the parameters it would be pooled under.
+  this[kPoolKey] = undefined;
   if (!this._hadError) {
     this._level = level;
     this._strategy = strategy;
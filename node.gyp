@@ -128,6 +128,7 @@
       'lib/internal/fs/streams.js',
       'lib/internal/fs/sync_write_stream.js',
       'lib/internal/fs/utils.js',
+      'lib/internal/fs/walk.js',
       'lib/internal/fs/watchers.js',
       'lib/internal/http.js',
       'lib/internal/idna.js',
@@ -432,10 +433,12 @@
         'src/node_api.cc',
         'src/node_binding.cc',
         'src/node_buffer.cc',
+        'src/node_compile_cache.cc',
         'src/node_config.cc',
         'src/node_constants.cc',
         'src/node_contextify.cc',
         'src/node_credentials.cc',
+        'src/node_dir_walker.cc',
         'src/node_domain.cc',
         'src/node_env_var.cc',
         'src/node_errors.cc',
@@ -445,10 +448,12 @@
         'src/node_http2.cc',
         'src/node_i18n.cc',
         'src/node_messaging.cc',
+        'src/node_module_resolution_cache.cc',
         'src/node_metadata.cc',
         'src/node_native_module.cc',
         'src/node_options.cc',
         'src/node_os.cc',
+        'src/node_package_json.cc',
         'src/node_perf.cc',
         'src/node_platform.cc',
         'src/node_postmortem_metadata.cc',
@@ -474,6 +479,7 @@
         'src/spawn_sync.cc',
         'src/stream_base.cc',
         'src/stream_pipe.cc',
+        'src/stream_receive_slab.cc',
         'src/stream_wrap.cc',
         'src/string_bytes.cc',
         'src/string_decoder.cc',
@@ -513,9 +519,11 @@
         'src/node_api_types.h',
         'src/node_binding.h',
         'src/node_buffer.h',
+        'src/node_compile_cache.h',
         'src/node_constants.h',
         'src/node_context_data.h',
         'src/node_contextify.h',
+        'src/node_dir_walker.h',
         'src/node_errors.h',
         'src/node_file.h',
         'src/node_http_parser_impl.h',
@@ -524,11 +532,13 @@
         'src/node_i18n.h',
         'src/node_internals.h',
         'src/node_messaging.h',
+        'src/node_module_resolution_cache.h',
         'src/node_metadata.h',
         'src/node_mutex.h',
         'src/node_native_module.h',
         'src/node_object_wrap.h',
         'src/node_options.h',
+        'src/node_package_json.h',
         'src/node_options-inl.h',
         'src/node_perf.h',
         'src/node_perf_common.h',
@@ -552,6 +562,7 @@
         'src/stream_base.h',
         'src/stream_base-inl.h',
         'src/stream_pipe.h',
+        'src/stream_receive_slab.h',
         'src/stream_wrap.h',
         'src/string_bytes.h',
         'src/string_decoder.h',
@@ -694,13 +705,19 @@
         [ 'node_use_openssl=="true"', {
           'sources': [
             'src/node_crypto.cc',
+            'src/node_crypto_async_key.cc',
             'src/node_crypto_bio.cc',
             'src/node_crypto_clienthello.cc',
+            'src/node_crypto_ktls.cc',
+            'src/node_crypto_session_cache.cc',
             'src/node_crypto.h',
+            'src/node_crypto_async_key.h',
             'src/node_crypto_bio.h',
             'src/node_crypto_clienthello.h',
             'src/node_crypto_clienthello-inl.h',
             'src/node_crypto_groups.h',
+            'src/node_crypto_ktls.h',
+            'src/node_crypto_session_cache.h',
             'src/tls_wrap.cc',
             'src/tls_wrap.h'
           ],
@@ -1037,6 +1054,7 @@
         'test/cctest/test_aliased_buffer.cc',
         'test/cctest/test_base64.cc',
         'test/cctest/test_node_postmortem_metadata.cc',
+        'test/cctest/test_package_json.cc',
         'test/cctest/test_environment.cc',
         'test/cctest/test_linked_binding.cc',
         'test/cctest/test_platform.cc',
@@ -33,6 +33,7 @@ namespace node {
 
 #define NODE_ASYNC_NON_CRYPTO_PROVIDER_TYPES(V)                               \
   V(NONE)                                                                     \
+  V(DIRWALKER)                                                                \
   V(DNSCHANNEL)                                                               \
   V(FILEHANDLE)                                                               \
   V(FILEHANDLECLOSEREQ)                                                       \
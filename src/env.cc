@@ -3,6 +3,9 @@
 #include "async_wrap.h"
 #include "node_buffer.h"
 #include "node_context_data.h"
+#if HAVE_OPENSSL
+#include "node_crypto_bio.h"
+#endif  // HAVE_OPENSSL
 #include "node_errors.h"
 #include "node_file.h"
 #include "node_internals.h"
@@ -12,6 +15,7 @@
 #include "node_process.h"
 #include "node_v8_platform-inl.h"
 #include "node_worker.h"
+#include "stream_receive_slab.h"
 #include "tracing/agent.h"
 #include "tracing/traced_value.h"
 #include "v8-profiler.h"
@@ -739,6 +743,20 @@ Local<Value> Environment::GetNow() {
     return Number::New(isolate(), static_cast<double>(now));
 }
 
+StreamReceiveSlab* Environment::receive_slab() {
+  if (!receive_slab_)
+    receive_slab_.reset(new StreamReceiveSlab(this));
+  return receive_slab_.get();
+}
+
+#if HAVE_OPENSSL
+crypto::NodeBIOBufferPool* Environment::bio_buffer_pool() {
+  if (!bio_buffer_pool_)
+    bio_buffer_pool_.reset(new crypto::NodeBIOBufferPool(this));
+  return bio_buffer_pool_.get();
+}
+#endif  // HAVE_OPENSSL
+
 
 void Environment::set_debug_categories(const std::string& cats, bool enabled) {
   std::string debug_categories = cats;
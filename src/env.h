@@ -70,6 +70,14 @@ namespace worker {
 class Worker;
 }
 
+class StreamReceiveSlab;
+
+#if HAVE_OPENSSL
+namespace crypto {
+class NodeBIOBufferPool;
+}
+#endif  // HAVE_OPENSSL
+
 namespace loader {
 class ModuleWrap;
 
@@ -105,7 +113,6 @@ constexpr size_t kFsStatsBufferLength = kFsStatsFieldsNumber * 2;
 // for the sake of convenience.  Strings should be ASCII-only and have a
 // "node:" prefix to avoid name clashes with third-party code.
 #define PER_ISOLATE_PRIVATE_SYMBOL_PROPERTIES(V)                              \
-  V(alpn_buffer_private_symbol, "node:alpnBuffer")                            \
   V(arrow_message_private_symbol, "node:arrowMessage")                        \
   V(contextify_context_private_symbol, "node:contextify:context")             \
   V(contextify_global_private_symbol, "node:contextify:global")               \
@@ -132,6 +139,7 @@ constexpr size_t kFsStatsBufferLength = kFsStatsFieldsNumber * 2;
   V(bits_string, "bits")                                                       \
   V(buffer_string, "buffer")                                                   \
   V(bytes_parsed_string, "bytesParsed")                                        \
+  V(bytes_copied_string, "bytesCopied")                                        \
   V(bytes_read_string, "bytesRead")                                            \
   V(bytes_written_string, "bytesWritten")                                      \
   V(cached_data_produced_string, "cachedDataProduced")                         \
@@ -239,6 +247,7 @@ constexpr size_t kFsStatsBufferLength = kFsStatsFieldsNumber * 2;
   V(onhandshakedone_string, "onhandshakedone")                                 \
   V(onhandshakestart_string, "onhandshakestart")                               \
   V(onmessage_string, "onmessage")                                             \
+  V(onmessagebatch_string, "onmessagebatch")                                   \
   V(onnewsession_string, "onnewsession")                                       \
   V(onocspresponse_string, "onocspresponse")                                   \
   V(onreadstart_string, "onreadstart")                                         \
@@ -860,6 +869,12 @@ class Environment {
   inline http2::Http2State* http2_state() const;
   inline void set_http2_state(std::unique_ptr<http2::Http2State> state);
 
+  // Created on first use.
+  StreamReceiveSlab* receive_slab();
+#if HAVE_OPENSSL
+  crypto::NodeBIOBufferPool* bio_buffer_pool();
+#endif  // HAVE_OPENSSL
+
   inline bool debug_enabled(DebugCategory category) const;
   inline void set_debug_enabled(DebugCategory category, bool enabled);
   void set_debug_categories(const std::string& cats, bool enabled);
@@ -1142,6 +1157,10 @@ class Environment {
   char* http_parser_buffer_ = nullptr;
   bool http_parser_buffer_in_use_ = false;
   std::unique_ptr<http2::Http2State> http2_state_;
+  std::unique_ptr<StreamReceiveSlab> receive_slab_;
+#if HAVE_OPENSSL
+  std::unique_ptr<crypto::NodeBIOBufferPool> bio_buffer_pool_;
+#endif  // HAVE_OPENSSL
 
   bool debug_enabled_[static_cast<int>(DebugCategory::CATEGORY_COUNT)] = {0};
 
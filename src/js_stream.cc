@@ -179,6 +179,7 @@ void JSStream::ReadBuffer(const FunctionCallbackInfo<Value>& args) {
       avail = buf.len;
 
     memcpy(buf.base, data, avail);
+    wrap->bytes_copied_ += avail;
     data += avail;
     len -= avail;
     wrap->EmitRead(avail, buf);
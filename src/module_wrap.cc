@@ -1,7 +1,9 @@
 #include "module_wrap.h"
 
 #include "env.h"
+#include "node_compile_cache.h"
 #include "node_errors.h"
+#include "node_package_json.h"
 #include "node_url.h"
 #include "util-inl.h"
 #include "node_contextify.h"
@@ -145,6 +147,16 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
   host_defined_options->Set(isolate, HostDefinedOptions::kType,
                             Number::New(isolate, ScriptType::kModule));
 
+  // Modules created by the loader, as opposed to vm.SourceTextModule, use the
+  // --code-cache-dir cache. The key is kept until the module has been
+  // evaluated and a cache has been produced, unless a cache was accepted.
+  std::string compile_cache_key;
+  MallocedBuffer<char> compile_cache_data;
+  if (argc != 5 && compile_cache::IsEnabled()) {
+    compile_cache_key = compile_cache::GetKey(isolate, source_text);
+    compile_cache_data = compile_cache::Read(compile_cache_key);
+  }
+
   // compile
   {
     ScriptOrigin origin(url,
@@ -158,8 +170,17 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
                         True(isolate),                        // is ES Module
                         host_defined_options);
     Context::Scope context_scope(context);
-    ScriptCompiler::Source source(source_text, origin);
-    if (!ScriptCompiler::CompileModule(isolate, &source).ToLocal(&module)) {
+    ScriptCompiler::CachedData* cached_data = nullptr;
+    ScriptCompiler::CompileOptions options = ScriptCompiler::kNoCompileOptions;
+    if (!compile_cache_data.is_empty()) {
+      cached_data = new ScriptCompiler::CachedData(
+          reinterpret_cast<const uint8_t*>(compile_cache_data.data),
+          compile_cache_data.size);
+      options = ScriptCompiler::kConsumeCodeCache;
+    }
+    ScriptCompiler::Source source(source_text, origin, cached_data);
+    if (!ScriptCompiler::CompileModule(isolate, &source, options)
+            .ToLocal(&module)) {
       if (try_catch.HasCaught() && !try_catch.HasTerminated()) {
         CHECK(!try_catch.Message().IsEmpty());
         CHECK(!try_catch.Exception().IsEmpty());
@@ -169,6 +190,8 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
       }
       return;
     }
+    if (cached_data != nullptr && !source.GetCachedData()->rejected)
+      compile_cache_key.clear();
   }
 
   if (!that->Set(context, env->url_string(), url).FromMaybe(false)) {
@@ -177,6 +200,7 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
 
   ModuleWrap* obj = new ModuleWrap(env, that, module, url);
   obj->context_.Reset(isolate, context);
+  obj->compile_cache_key_ = std::move(compile_cache_key);
 
   env->hash_to_module_map.emplace(module->GetIdentityHash(), obj);
 
@@ -321,6 +345,26 @@ void ModuleWrap::Evaluate(const FunctionCallbackInfo<Value>& args) {
     return;
   }
 
+  // Produce caches now rather than at compile time so that they include the
+  // functions that ran during evaluation. Only the root of a graph is
+  // evaluated explicitly, so this covers its dependencies as well.
+  if (compile_cache::IsEnabled()) {
+    for (const auto& entry : env->id_to_module_map) {
+      ModuleWrap* wrap = entry.second;
+      if (wrap->compile_cache_key_.empty())
+        continue;
+      Local<Module> evaluated = wrap->module_.Get(isolate);
+      if (evaluated->GetStatus() != Module::kEvaluated)
+        continue;
+      const std::unique_ptr<ScriptCompiler::CachedData> cached_data(
+          ScriptCompiler::CreateCodeCache(
+              evaluated->GetUnboundModuleScript()));
+      if (cached_data != nullptr)
+        compile_cache::Write(env, wrap->compile_cache_key_, *cached_data);
+      wrap->compile_cache_key_.clear();
+    }
+  }
+
   args.GetReturnValue().Set(result.ToLocalChecked());
 }
 
@@ -518,6 +562,26 @@ const PackageConfig& GetPackageConfig(Environment* env,
   if (existing != env->package_json_cache.end()) {
     return existing->second;
   }
+
+  std::shared_ptr<const package_json::PackageFields> fields;
+  switch (package_json::Read(path, &fields)) {
+    case package_json::ReadResult::kNotFound: {
+      auto entry = env->package_json_cache.emplace(path,
+          PackageConfig { Exists::No, IsValid::Yes, HasMain::No, "" });
+      return entry.first->second;
+    }
+    case package_json::ReadResult::kOk: {
+      auto entry = env->package_json_cache.emplace(path,
+          PackageConfig { Exists::Yes,
+                          IsValid::Yes,
+                          fields->has_main ? HasMain::Yes : HasMain::No,
+                          fields->main });
+      return entry.first->second;
+    }
+    case package_json::ReadResult::kNeedsFullParse:
+      break;
+  }
+
   Maybe<uv_file> check = CheckFile(path, LEAVE_OPEN_AFTER_CHECK);
   if (check.IsNothing()) {
     auto entry = env->package_json_cache.emplace(path,
@@ -90,6 +90,8 @@ class ModuleWrap : public BaseObject {
   bool linked_ = false;
   std::unordered_map<std::string, Persistent<v8::Promise>> resolve_cache_;
   Persistent<v8::Context> context_;
+  // Set while a --code-cache-dir cache should be produced for this module.
+  std::string compile_cache_key_;
   uint32_t id_;
 };
 
@@ -26,11 +26,13 @@
 #include "debug_utils.h"
 #include "node_binding.h"
 #include "node_buffer.h"
+#include "node_compile_cache.h"
 #include "node_constants.h"
 #include "node_context_data.h"
 #include "node_errors.h"
 #include "node_internals.h"
 #include "node_metadata.h"
+#include "node_module_resolution_cache.h"
 #include "node_native_module.h"
 #include "node_options-inl.h"
 #include "node_perf.h"
@@ -712,6 +714,21 @@ int InitializeNodeWithArgs(std::vector<std::string>* argv,
   if (!per_process::cli_options->title.empty())
     uv_set_process_title(per_process::cli_options->title.c_str());
 
+  // Map the resolution cache before any Environment starts loading modules.
+  if (!per_process::cli_options->module_resolution_cache.empty()) {
+    module_resolution_cache::Initialize(
+        per_process::cli_options->module_resolution_cache);
+  }
+
+  if (!per_process::cli_options->code_cache_dir.empty()) {
+    // V8 options may also come from NODE_OPTIONS.
+    std::vector<std::string> flags(*exec_argv);
+    std::string node_options;
+    if (credentials::SafeGetenv("NODE_OPTIONS", &node_options))
+      flags.push_back(node_options);
+    compile_cache::Initialize(per_process::cli_options->code_cache_dir, flags);
+  }
+
 #if defined(NODE_HAVE_I18N_SUPPORT)
   // If the parameter isn't given, use the env variable.
   if (per_process::cli_options->icu_data_dir.empty())
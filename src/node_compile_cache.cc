@@ -0,0 +1,186 @@
+#include "node_compile_cache.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "node_version.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <fcntl.h>
+#include <cstring>
+
+namespace node {
+namespace compile_cache {
+
+using v8::Isolate;
+using v8::Local;
+using v8::ScriptCompiler;
+using v8::String;
+
+namespace {
+
+// Both are set once during startup, before any Environment exists.
+std::string cache_directory;  // NOLINT(runtime/string)
+uint64_t flags_hash = 0;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Finalize(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Not cryptographic. Sources are hashed on every startup, so this consumes
+// eight bytes per step rather than one.
+uint64_t Hash(const char* data, size_t length, uint64_t seed) {
+  constexpr uint64_t kMul1 = 0x87c37b91114253d5ull;
+  constexpr uint64_t kMul2 = 0x4cf5ad432745937full;
+  uint64_t hash = seed ^ (length * kMul1);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    hash ^= RotateLeft(word * kMul1, 31) * kMul2;
+    hash = RotateLeft(hash, 27) * 5 + 0x52dce729;
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, data + i, length - i);
+  hash ^= RotateLeft(tail * kMul1, 31) * kMul2;
+  return Finalize(hash);
+}
+
+inline std::string CachePath(const std::string& key) {
+  return cache_directory + '/' + key + ".cache";
+}
+
+class WriteCacheWork : public ThreadPoolWork {
+ public:
+  WriteCacheWork(Environment* env,
+                 const std::string& key,
+                 const ScriptCompiler::CachedData& data)
+      : ThreadPoolWork(env, UV_WORK_FAST_IO),
+        path_(CachePath(key)),
+        data_(data.length) {
+    memcpy(data_.data, data.data, data.length);
+  }
+
+  void DoThreadPoolWork() override {
+    // Processes that start at the same time may write the same cache, write
+    // to a private file first so that readers never see a partial one.
+    const std::string temp_path =
+        path_ + "." + std::to_string(uv_os_getpid()) + ".tmp";
+    uv_fs_t req;
+    const int fd = uv_fs_open(nullptr, &req, temp_path.c_str(),
+                              O_WRONLY | O_CREAT | O_TRUNC, 0644, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (fd < 0)
+      return;
+
+    size_t offset = 0;
+    while (offset < data_.size) {
+      uv_buf_t buf = uv_buf_init(data_.data + offset, data_.size - offset);
+      const int r = uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (r <= 0)
+        break;
+      offset += r;
+    }
+    CHECK_EQ(0, uv_fs_close(nullptr, &req, fd, nullptr));
+    uv_fs_req_cleanup(&req);
+
+    if (offset != data_.size ||
+        uv_fs_rename(nullptr, &req, temp_path.c_str(), path_.c_str(),
+                     nullptr) != 0) {
+      uv_fs_req_cleanup(&req);
+      uv_fs_unlink(nullptr, &req, temp_path.c_str(), nullptr);
+    }
+    uv_fs_req_cleanup(&req);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    delete this;
+  }
+
+ private:
+  const std::string path_;
+  MallocedBuffer<char> data_;
+};
+
+}  // anonymous namespace
+
+void Initialize(const std::string& directory,
+                const std::vector<std::string>& flags) {
+  CHECK(!directory.empty());
+  cache_directory = directory;
+
+  uv_fs_t req;
+  uv_fs_mkdir(nullptr, &req, directory.c_str(), 0777, nullptr);
+  uv_fs_req_cleanup(&req);
+
+  std::string salt = std::string(NODE_VERSION) + '\0' +
+                     v8::V8::GetVersion() + '\0';
+  for (const std::string& flag : flags)
+    salt += flag + '\0';
+  flags_hash = Hash(salt.data(), salt.size(), 0);
+}
+
+bool IsEnabled() {
+  return !cache_directory.empty();
+}
+
+std::string GetKey(Isolate* isolate, Local<String> source) {
+  Utf8Value utf8(isolate, source);
+  const uint64_t hash = Hash(*utf8, utf8.length(), flags_hash);
+  char key[40];
+  snprintf(key, sizeof(key), "%016llx%08zx",
+           static_cast<unsigned long long>(hash),  // NOLINT(runtime/int)
+           utf8.length() & 0xffffffff);
+  return key;
+}
+
+MallocedBuffer<char> Read(const std::string& key) {
+  const std::string path = CachePath(key);
+  uv_fs_t req;
+  const int fd = uv_fs_open(nullptr, &req, path.c_str(), O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return MallocedBuffer<char>();
+
+  int rc = uv_fs_fstat(nullptr, &req, fd, nullptr);
+  const size_t size = req.statbuf.st_size;
+  uv_fs_req_cleanup(&req);
+
+  MallocedBuffer<char> data;
+  if (rc == 0 && size > 0) {
+    data = MallocedBuffer<char>(size);
+    size_t offset = 0;
+    while (offset < size) {
+      uv_buf_t buf = uv_buf_init(data.data + offset, size - offset);
+      rc = uv_fs_read(nullptr, &req, fd, &buf, 1, offset, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (rc <= 0)
+        break;
+      offset += rc;
+    }
+    if (offset != size)
+      data = MallocedBuffer<char>();
+  }
+
+  CHECK_EQ(0, uv_fs_close(nullptr, &req, fd, nullptr));
+  uv_fs_req_cleanup(&req);
+  return data;
+}
+
+void Write(Environment* env,
+           const std::string& key,
+           const ScriptCompiler::CachedData& data) {
+  (new WriteCacheWork(env, key, data))->ScheduleWork();
+}
+
+}  // namespace compile_cache
+}  // namespace node
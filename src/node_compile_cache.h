@@ -0,0 +1,47 @@
+#ifndef SRC_NODE_COMPILE_CACHE_H_
+#define SRC_NODE_COMPILE_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "util.h"
+#include "v8.h"
+
+#include <string>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+// V8 code cache for user-land CommonJS and ES modules, enabled with
+// --code-cache-dir=dir. Each module's cache lives in its own file, named
+// after a hash of the module source, its length and the V8 version and
+// command line flags that affect code generation. Caches are read
+// synchronously when a module is compiled, and produced after the module has
+// been evaluated so that they include functions that were compiled lazily.
+// Writes happen on the threadpool.
+namespace compile_cache {
+
+// Creates `directory` if needed. `flags` are mixed into every key, so that
+// caches produced with different V8 options do not evict each other.
+void Initialize(const std::string& directory,
+                const std::vector<std::string>& flags);
+
+bool IsEnabled();
+
+std::string GetKey(v8::Isolate* isolate, v8::Local<v8::String> source);
+
+// Returns an empty buffer if there is no cache for `key`.
+MallocedBuffer<char> Read(const std::string& key);
+
+// Copies `data` and writes it to the cache directory on the threadpool.
+void Write(Environment* env,
+           const std::string& key,
+           const v8::ScriptCompiler::CachedData& data);
+
+}  // namespace compile_cache
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_COMPILE_CACHE_H_
@@ -20,6 +20,7 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "node_contextify.h"
+#include "node_compile_cache.h"
 
 #include "node_internals.h"
 #include "node_watchdog.h"
@@ -67,6 +68,7 @@ using v8::String;
 using v8::Symbol;
 using v8::Uint32;
 using v8::UnboundScript;
+using v8::Undefined;
 using v8::Value;
 using v8::WeakCallbackInfo;
 using v8::WeakCallbackType;
@@ -1118,7 +1120,13 @@ void ContextifyContext::CompileFunction(
       WeakCallbackCompileFn,
       v8::WeakCallbackType::kParameter);
 
-  if (produce_cached_data) {
+  if (options == ScriptCompiler::kConsumeCodeCache) {
+    if (fn->Set(
+        parsing_context,
+        env->cached_data_rejected_string(),
+        Boolean::New(isolate, source.GetCachedData()->rejected)).IsNothing())
+      return;
+  } else if (produce_cached_data) {
     const std::unique_ptr<ScriptCompiler::CachedData> cached_data(
         ScriptCompiler::CreateCodeCacheForFunction(fn));
     bool cached_data_produced = cached_data != nullptr;
@@ -1142,6 +1150,49 @@ void ContextifyContext::CompileFunction(
 }
 
 
+// getCompileCache(source) returns the --code-cache-dir key for `source` and
+// the cached data for it, if any.
+static void GetCompileCache(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  CHECK(compile_cache::IsEnabled());
+  CHECK(args[0]->IsString());
+  const std::string key =
+      compile_cache::GetKey(isolate, args[0].As<String>());
+
+  Local<Value> result[] = {
+    OneByteString(isolate, key.c_str()),
+    Undefined(isolate)
+  };
+  MallocedBuffer<char> data = compile_cache::Read(key);
+  if (!data.is_empty()) {
+    const size_t size = data.size;
+    Local<Object> buf;
+    if (!Buffer::New(env, data.release(), size, true).ToLocal(&buf))
+      return;
+    result[1] = buf;
+  }
+  args.GetReturnValue().Set(Array::New(isolate, result, arraysize(result)));
+}
+
+// storeCompileCache(key, fn) serializes the code of `fn`, including the
+// functions that have been compiled since it was created, and writes it to
+// the --code-cache-dir in the background.
+static void StoreCompileCache(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(compile_cache::IsEnabled());
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsFunction());
+  Utf8Value key(env->isolate(), args[0]);
+
+  const std::unique_ptr<ScriptCompiler::CachedData> cached_data(
+      ScriptCompiler::CreateCodeCacheForFunction(args[1].As<Function>()));
+  if (cached_data != nullptr)
+    compile_cache::Write(env, *key, *cached_data);
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -1149,6 +1200,8 @@ void Initialize(Local<Object> target,
   Environment* env = Environment::GetCurrent(context);
   ContextifyContext::Init(env, target);
   ContextifyScript::Init(env, target);
+  env->SetMethod(target, "getCompileCache", GetCompileCache);
+  env->SetMethod(target, "storeCompileCache", StoreCompileCache);
 }
 
 }  // namespace contextify
@@ -23,9 +23,11 @@
 #include "node.h"
 #include "node_buffer.h"
 #include "node_constants.h"
+#include "node_crypto_async_key.h"
 #include "node_crypto_bio.h"
 #include "node_crypto_clienthello-inl.h"
 #include "node_crypto_groups.h"
+#include "node_crypto_session_cache.h"
 #include "node_errors.h"
 #include "node_mutex.h"
 #include "node_process.h"
@@ -81,6 +83,7 @@ using v8::MaybeLocal;
 using v8::NewStringType;
 using v8::Nothing;
 using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
@@ -360,6 +363,7 @@ void SecureContext::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t, "setTicketKeys", SetTicketKeys);
   env->SetProtoMethod(t, "setFreeListLength", SetFreeListLength);
   env->SetProtoMethod(t, "enableTicketKeyCallback", EnableTicketKeyCallback);
+  env->SetProtoMethod(t, "enableSharedSessionCache", EnableSharedSessionCache);
   env->SetProtoMethodNoSideEffect(t, "getCertificate", GetCertificate<true>);
   env->SetProtoMethodNoSideEffect(t, "getIssuer", GetCertificate<false>);
 
@@ -1145,8 +1149,10 @@ void SecureContext::SetSessionIdContext(
   unsigned int sid_ctx_len = sessionIdContext.length();
 
   int r = SSL_CTX_set_session_id_context(sc->ctx_.get(), sid_ctx, sid_ctx_len);
-  if (r == 1)
+  if (r == 1) {
+    sc->session_id_context_.assign(*sessionIdContext, sid_ctx_len);
     return;
+  }
 
   BUF_MEM* mem;
   Local<String> message;
@@ -1366,6 +1372,24 @@ void SecureContext::EnableTicketKeyCallback(
 }
 
 
+// Only affects connections that are created afterwards. Also switches to the
+// ticket keys that all servers with a shared session cache use, so that
+// ticket-based sessions are resumable on each of them, too.
+void SecureContext::EnableSharedSessionCache(
+    const FunctionCallbackInfo<Value>& args) {
+  SecureContext* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  wrap->shared_session_cache_ = true;
+
+  const unsigned char* keys =
+      SharedSessionCache::GetInstance()->ticket_keys();
+  memcpy(wrap->ticket_key_name_, keys, 16);
+  memcpy(wrap->ticket_key_hmac_, keys + 16, 16);
+  memcpy(wrap->ticket_key_aes_, keys + 32, 16);
+}
+
+
 int SecureContext::TicketKeyCallback(SSL* ssl,
                                      unsigned char* name,
                                      unsigned char* iv,
@@ -1573,6 +1597,13 @@ SSL_SESSION* SSLWrap<Base>::GetSessionCallback(SSL* s,
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
 
   *copy = 0;
+  if (!w->next_sess_ && w->shared_session_cache_) {
+    // The context may have been replaced by the SNICallback.
+    SecureContext* sc = static_cast<SecureContext*>(
+        SSL_CTX_get_app_data(SSL_get_SSL_CTX(s)));
+    return SharedSessionCache::GetInstance()->Get(
+        sc->session_id_context_, key, len);
+  }
   return w->next_sess_.release();
 }
 
@@ -1580,6 +1611,16 @@ SSL_SESSION* SSLWrap<Base>::GetSessionCallback(SSL* s,
 template <class Base>
 int SSLWrap<Base>::NewSessionCallback(SSL* s, SSL_SESSION* sess) {
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
+
+  if (w->is_server() && w->shared_session_cache_)
+    SharedSessionCache::GetInstance()->Add(sess);
+
+  if (w->session_callbacks_ && InAsyncKeyJob()) {
+    SSL_SESSION_up_ref(sess);
+    w->deferred_new_session_.reset(sess);
+    return 0;
+  }
+
   Environment* env = w->ssl_env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
@@ -2276,7 +2317,9 @@ void SSLWrap<Base>::SetOCSPResponse(const FunctionCallbackInfo<Value>& args) {
 
   THROW_AND_RETURN_IF_NOT_BUFFER(env, args[0], "OCSP response");
 
-  w->ocsp_response_.Reset(args.GetIsolate(), args[0].As<ArrayBufferView>());
+  ArrayBufferViewContents<unsigned char> response(args[0]);
+  w->ocsp_response_.assign(response.data(),
+                           response.data() + response.length());
 }
 
 
@@ -2472,17 +2515,9 @@ int SSLWrap<Base>::SelectALPNCallback(SSL* s,
                                       unsigned int inlen,
                                       void* arg) {
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
-  Environment* env = w->env();
-  HandleScope handle_scope(env->isolate());
-  Context::Scope context_scope(env->context());
-
-  Local<Value> alpn_buffer =
-      w->object()->GetPrivate(
-          env->context(),
-          env->alpn_buffer_private_symbol()).ToLocalChecked();
-  ArrayBufferViewContents<unsigned char> alpn_protos(alpn_buffer);
   int status = SSL_select_next_proto(const_cast<unsigned char**>(out), outlen,
-                                     alpn_protos.data(), alpn_protos.length(),
+                                     w->alpn_protos_.data(),
+                                     w->alpn_protos_.size(),
                                      in, inlen);
   // According to 3.2. Protocol Selection of RFC7301, fatal
   // no_application_protocol alert shall be sent but OpenSSL 1.0.2 does not
@@ -2535,11 +2570,9 @@ void SSLWrap<Base>::SetALPNProtocols(const FunctionCallbackInfo<Value>& args) {
         w->ssl_.get(), alpn_protos.data(), alpn_protos.length());
     CHECK_EQ(r, 0);
   } else {
-    CHECK(
-        w->object()->SetPrivate(
-            env->context(),
-            env->alpn_buffer_private_symbol(),
-            args[0]).FromJust());
+    ArrayBufferViewContents<unsigned char> alpn_protos(args[0]);
+    w->alpn_protos_.assign(alpn_protos.data(),
+                           alpn_protos.data() + alpn_protos.length());
     // Server should select ALPN protocol from list of advertised by client
     SSL_CTX_set_alpn_select_cb(SSL_get_SSL_CTX(w->ssl_.get()),
                                SelectALPNCallback,
@@ -2551,10 +2584,11 @@ void SSLWrap<Base>::SetALPNProtocols(const FunctionCallbackInfo<Value>& args) {
 template <class Base>
 int SSLWrap<Base>::TLSExtStatusCallback(SSL* s, void* arg) {
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
-  Environment* env = w->env();
-  HandleScope handle_scope(env->isolate());
 
   if (w->is_client()) {
+    Environment* env = w->env();
+    HandleScope handle_scope(env->isolate());
+
     // Incoming response
     const unsigned char* resp;
     int len = SSL_get_tlsext_status_ocsp_resp(s, &resp);
@@ -2576,20 +2610,18 @@ int SSLWrap<Base>::TLSExtStatusCallback(SSL* s, void* arg) {
     return 1;
   } else {
     // Outgoing response
-    if (w->ocsp_response_.IsEmpty())
+    if (w->ocsp_response_.empty())
       return SSL_TLSEXT_ERR_NOACK;
 
-    Local<ArrayBufferView> obj = PersistentToLocal::Default(env->isolate(),
-                                                            w->ocsp_response_);
-    size_t len = obj->ByteLength();
+    size_t len = w->ocsp_response_.size();
 
     // OpenSSL takes control of the pointer after accepting it
     unsigned char* data = MallocOpenSSL<unsigned char>(len);
-    obj->CopyContents(data, len);
+    memcpy(data, w->ocsp_response_.data(), len);
 
     if (!SSL_set_tlsext_status_ocsp_resp(s, data, len))
       OPENSSL_free(data);
-    w->ocsp_response_.Reset();
+    w->ocsp_response_.clear();
 
     return SSL_TLSEXT_ERR_OK;
   }
@@ -2618,6 +2650,12 @@ int SSLWrap<Base>::SSLCertCallback(SSL* s, void* arg) {
     // handshake will continue after certcb is done.
     return -1;
 
+  if (InAsyncKeyJob()) {
+    // Suspend the handshake, the callback is made after SSL_read() returned.
+    w->cert_cb_deferred_ = true;
+    return -1;
+  }
+
   Environment* env = w->env();
   Local<Context> context = env->context();
   HandleScope handle_scope(env->isolate());
@@ -5479,7 +5517,8 @@ bool ECDH::IsKeyPairValid() {
 struct CryptoJob : public ThreadPoolWork {
   Environment* const env;
   std::unique_ptr<AsyncWrap> async_wrap;
-  inline explicit CryptoJob(Environment* env) : ThreadPoolWork(env), env(env) {}
+  inline explicit CryptoJob(Environment* env)
+      : ThreadPoolWork(env, UV_WORK_CPU), env(env) {}
   inline void AfterThreadPoolWork(int status) final;
   virtual void AfterThreadPoolWork() = 0;
   static inline void Run(std::unique_ptr<CryptoJob> job, Local<Value> wrap);
@@ -6151,6 +6190,20 @@ bool VerifySpkac(const char* data, unsigned int len) {
 }
 
 
+// Returns [hits, misses, size] of the process-wide session cache.
+void GetSharedSessionCacheStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  SharedSessionCache* cache = SharedSessionCache::GetInstance();
+  Local<Value> stats[] = {
+    Number::New(env->isolate(), static_cast<double>(cache->hits())),
+    Number::New(env->isolate(), static_cast<double>(cache->misses())),
+    Number::New(env->isolate(), static_cast<double>(cache->size()))
+  };
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), stats, arraysize(stats)));
+}
+
+
 void VerifySpkac(const FunctionCallbackInfo<Value>& args) {
   bool verify_result = false;
 
@@ -6466,6 +6519,8 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "randomBytes", RandomBytes);
   env->SetMethodNoSideEffect(target, "timingSafeEqual", TimingSafeEqual);
   env->SetMethodNoSideEffect(target, "getSSLCiphers", GetSSLCiphers);
+  env->SetMethodNoSideEffect(target, "getSharedSessionCacheStats",
+                             GetSharedSessionCacheStats);
   env->SetMethodNoSideEffect(target, "getCiphers", GetCiphers);
   env->SetMethodNoSideEffect(target, "getHashes", GetHashes);
   env->SetMethodNoSideEffect(target, "getCurves", GetCurves);
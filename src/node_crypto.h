@@ -115,6 +115,10 @@ class SecureContext : public BaseObject {
 #ifndef OPENSSL_NO_ENGINE
   bool client_cert_engine_provided_ = false;
 #endif  // !OPENSSL_NO_ENGINE
+  // Whether server sessions are stored in the SharedSessionCache.
+  bool shared_session_cache_ = false;
+  // Part of the key of the sessions in the SharedSessionCache.
+  std::string session_id_context_;
 
   static const int kMaxSessionSize = 10 * 1024;
 
@@ -172,6 +176,8 @@ class SecureContext : public BaseObject {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableTicketKeyCallback(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableSharedSessionCache(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void CtxGetter(const v8::FunctionCallbackInfo<v8::Value>& info);
 
   template <bool primary>
@@ -224,10 +230,12 @@ class SSLWrap {
         kind_(kind),
         next_sess_(nullptr),
         session_callbacks_(false),
+        shared_session_cache_(sc->shared_session_cache_),
         awaiting_new_session_(false),
         cert_cb_(nullptr),
         cert_cb_arg_(nullptr),
-        cert_cb_running_(false) {
+        cert_cb_running_(false),
+        cert_cb_deferred_(false) {
     ssl_.reset(SSL_new(sc->ctx_.get()));
     CHECK(ssl_);
     env_->isolate()->AdjustAmountOfExternalAllocatedMemory(kExternalSize);
@@ -329,16 +337,24 @@ class SSLWrap {
   SSLSessionPointer next_sess_;
   SSLPointer ssl_;
   bool session_callbacks_;
+  bool shared_session_cache_;
   bool awaiting_new_session_;
 
   // SSL_set_cert_cb
   CertCb cert_cb_;
   void* cert_cb_arg_;
   bool cert_cb_running_;
+  // Callbacks that were due while an asynchronous handshake job was running,
+  // see crypto::InAsyncKeyJob(). The owner has to make them afterwards.
+  bool cert_cb_deferred_;
+  SSLSessionPointer deferred_new_session_;
 
   ClientHelloParser hello_parser_;
 
-  Persistent<v8::ArrayBufferView> ocsp_response_;
+  // Copied from the buffers passed in from JS, so that the callbacks that
+  // use them do not need V8 and can run within a handshake job.
+  std::vector<unsigned char> alpn_protos_;
+  std::vector<unsigned char> ocsp_response_;
   Persistent<v8::Value> sni_context_;
 
   friend class SecureContext;
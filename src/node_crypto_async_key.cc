@@ -0,0 +1,185 @@
+#include "node_crypto_async_key.h"
+
+#include <openssl/async.h>
+#include <openssl/ec.h>
+#include <openssl/rsa.h>
+
+namespace node {
+namespace crypto {
+
+namespace {
+
+// The operation that paused the current thread's ASYNC job most recently.
+thread_local AsyncKeyOperation* paused_operation = nullptr;
+
+template <typename Fn>
+class PausedOperation : public AsyncKeyOperation {
+ public:
+  PausedOperation(Fn fn, int failure)
+      : fn_(fn), result_(failure), failure_(failure) {}
+
+  void Run() override { result_ = fn_(); }
+  void Fail() override { result_ = failure_; }
+
+  int result() const { return result_; }
+
+ private:
+  Fn fn_;
+  int result_;
+  const int failure_;
+};
+
+// Pauses the current ASYNC job until `fn` has been run on the threadpool,
+// or runs it directly when not called from within a job. `failure` is the
+// value by which `fn` signals an error.
+template <typename Fn>
+int RunOffThread(Fn fn, int failure) {
+  if (ASYNC_get_current_job() == nullptr)
+    return fn();
+
+  // Lives on the stack of the paused job.
+  PausedOperation<Fn> operation(fn, failure);
+  paused_operation = &operation;
+  if (ASYNC_pause_job() == 0) {
+    paused_operation = nullptr;
+    return fn();
+  }
+  if (paused_operation == &operation)
+    paused_operation = nullptr;
+  return operation.result();
+}
+
+
+int RSAPrivateEncrypt(int flen,
+                      const unsigned char* from,
+                      unsigned char* to,
+                      RSA* rsa,
+                      int padding) {
+  auto priv_enc = RSA_meth_get_priv_enc(RSA_PKCS1_OpenSSL());
+  return RunOffThread([=]() {
+    return priv_enc(flen, from, to, rsa, padding);
+  }, -1);
+}
+
+
+int RSAPrivateDecrypt(int flen,
+                      const unsigned char* from,
+                      unsigned char* to,
+                      RSA* rsa,
+                      int padding) {
+  auto priv_dec = RSA_meth_get_priv_dec(RSA_PKCS1_OpenSSL());
+  return RunOffThread([=]() {
+    return priv_dec(flen, from, to, rsa, padding);
+  }, -1);
+}
+
+
+using ECDSASignFunction = int (*)(int type,
+                                  const unsigned char* dgst,
+                                  int dlen,
+                                  unsigned char* sig,
+                                  unsigned int* siglen,
+                                  const BIGNUM* kinv,
+                                  const BIGNUM* r,
+                                  EC_KEY* eckey);
+
+int ECDSASign(int type,
+              const unsigned char* dgst,
+              int dlen,
+              unsigned char* sig,
+              unsigned int* siglen,
+              const BIGNUM* kinv,
+              const BIGNUM* r,
+              EC_KEY* eckey) {
+  ECDSASignFunction sign;
+  EC_KEY_METHOD_get_sign(EC_KEY_OpenSSL(), &sign, nullptr, nullptr);
+  return RunOffThread([=]() {
+    return sign(type, dgst, dlen, sig, siglen, kinv, r, eckey);
+  }, 0);
+}
+
+
+const RSA_METHOD* GetAsyncRSAMethod() {
+  static const RSA_METHOD* method = []() {
+    RSA_METHOD* method = RSA_meth_dup(RSA_PKCS1_OpenSSL());
+    if (method != nullptr) {
+      RSA_meth_set_priv_enc(method, RSAPrivateEncrypt);
+      RSA_meth_set_priv_dec(method, RSAPrivateDecrypt);
+    }
+    return method;
+  }();
+  return method;
+}
+
+
+const EC_KEY_METHOD* GetAsyncECMethod() {
+  static const EC_KEY_METHOD* method = []() {
+    EC_KEY_METHOD* method = EC_KEY_METHOD_new(EC_KEY_OpenSSL());
+    if (method != nullptr) {
+      int (*sign_setup)(EC_KEY*, BN_CTX*, BIGNUM**, BIGNUM**);
+      ECDSA_SIG* (*sign_sig)(const unsigned char*, int,
+                             const BIGNUM*, const BIGNUM*, EC_KEY*);
+      EC_KEY_METHOD_get_sign(EC_KEY_OpenSSL(),
+                             nullptr,
+                             &sign_setup,
+                             &sign_sig);
+      EC_KEY_METHOD_set_sign(method, ECDSASign, sign_setup, sign_sig);
+    }
+    return method;
+  }();
+  return method;
+}
+
+}  // anonymous namespace
+
+
+bool InAsyncKeyJob() {
+  return ASYNC_get_current_job() != nullptr;
+}
+
+
+bool CanUseAsyncKeyOperations() {
+  return ASYNC_is_capable() == 1;
+}
+
+
+bool UseAsyncKeyOperations(EVP_PKEY* pkey) {
+  if (pkey == nullptr)
+    return false;
+
+  // Keys that come from an engine or use other custom methods are left alone.
+  switch (EVP_PKEY_id(pkey)) {
+    case EVP_PKEY_RSA: {
+      RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+      const RSA_METHOD* method = GetAsyncRSAMethod();
+      if (method == nullptr || rsa == nullptr)
+        return false;
+      if (RSA_get_method(rsa) == method)
+        return true;
+      return RSA_get_method(rsa) == RSA_PKCS1_OpenSSL() &&
+             RSA_set_method(rsa, method) == 1;
+    }
+    case EVP_PKEY_EC: {
+      EC_KEY* ec = EVP_PKEY_get0_EC_KEY(pkey);
+      const EC_KEY_METHOD* method = GetAsyncECMethod();
+      if (method == nullptr || ec == nullptr)
+        return false;
+      if (EC_KEY_get_method(ec) == method)
+        return true;
+      return EC_KEY_get_method(ec) == EC_KEY_OpenSSL() &&
+             EC_KEY_set_method(ec, method) == 1;
+    }
+    default:
+      return false;
+  }
+}
+
+
+AsyncKeyOperation* TakeAsyncKeyOperation() {
+  AsyncKeyOperation* operation = paused_operation;
+  paused_operation = nullptr;
+  return operation;
+}
+
+}  // namespace crypto
+}  // namespace node
@@ -0,0 +1,58 @@
+#ifndef SRC_NODE_CRYPTO_ASYNC_KEY_H_
+#define SRC_NODE_CRYPTO_ASYNC_KEY_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <openssl/evp.h>
+
+namespace node {
+namespace crypto {
+
+// Private key operations that run on the libuv threadpool during TLS
+// handshakes.
+//
+// OpenSSL 1.1.1 has no asynchronous private key API, but with SSL_MODE_ASYNC
+// every SSL_do_handshake() runs as an ASYNC job on a separate stack, which
+// can pause itself. Keys prepared with UseAsyncKeyOperations() get RSA and
+// ECDSA methods that, when called from within such a job, pause it instead
+// of computing the result. SSL_do_handshake() then fails with
+// SSL_ERROR_WANT_ASYNC, and the caller takes the operation with
+// TakeAsyncKeyOperation(), runs it on the threadpool and calls
+// SSL_do_handshake() again once it is done, which resumes the job with the
+// result. Outside of a job, the methods behave like the default ones.
+//
+// Nothing that can run JavaScript may be called from within a job, the stack
+// is far too small for it and is not known to V8.
+
+class AsyncKeyOperation {
+ public:
+  virtual ~AsyncKeyOperation() = default;
+
+  // Computes the result. Called on a threadpool thread.
+  virtual void Run() = 0;
+  // Makes the operation fail, e.g. when the connection went away while it
+  // was running, so that the job can be resumed and finished quickly.
+  virtual void Fail() = 0;
+};
+
+// Whether the calling code runs within an ASYNC job.
+bool InAsyncKeyJob();
+
+// Whether OpenSSL supports ASYNC jobs on this platform.
+bool CanUseAsyncKeyOperations();
+
+// Installs the offloading methods on `pkey`, if it is an RSA or EC key.
+// Returns whether they are installed.
+bool UseAsyncKeyOperations(EVP_PKEY* pkey);
+
+// Returns the operation that paused the job from which SSL_do_handshake() has
+// just returned SSL_ERROR_WANT_ASYNC on this thread, or nullptr. The operation
+// is owned by the paused job and remains valid until the job is resumed.
+AsyncKeyOperation* TakeAsyncKeyOperation();
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_ASYNC_KEY_H_
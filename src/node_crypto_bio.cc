@@ -106,16 +106,16 @@ char* NodeBIO::Peek(size_t* size) {
 }
 
 
-size_t NodeBIO::PeekMultiple(char** out, size_t* size, size_t* count) {
+size_t NodeBIO::PeekMultiple(uv_buf_t* bufs, size_t* count) {
   Buffer* pos = read_head_;
   size_t max = *count;
   size_t total = 0;
 
   size_t i;
   for (i = 0; i < max; i++) {
-    size[i] = pos->write_pos_ - pos->read_pos_;
-    total += size[i];
-    out[i] = pos->data_ + pos->read_pos_;
+    const size_t size = pos->write_pos_ - pos->read_pos_;
+    total += size;
+    bufs[i] = uv_buf_init(pos->data_ + pos->read_pos_, size);
 
     /* Don't get past write head */
     if (pos == write_head_)
@@ -511,6 +511,69 @@ NodeBIO::~NodeBIO() {
 }
 
 
+// Size classes are 1 KiB, 4 KiB and 16 KiB, matching the initial and
+// throughput buffer sizes used by NodeBIO and TLSWrap.
+static inline size_t BufferPoolClassSize(size_t size_class) {
+  return static_cast<size_t>(1024) << (2 * size_class);
+}
+
+
+NodeBIOBufferPool::NodeBIOBufferPool(Environment* env) : env_(env) {}
+
+
+NodeBIOBufferPool::~NodeBIOBufferPool() {
+  for (size_t i = 0; i < kSizeClassCount; i++) {
+    for (char* data : free_[i]) {
+      delete[] data;
+      env_->isolate()->AdjustAmountOfExternalAllocatedMemory(
+          -static_cast<int64_t>(BufferPoolClassSize(i)));
+    }
+  }
+}
+
+
+size_t NodeBIOBufferPool::SizeClassFor(size_t len) {
+  size_t i = 0;
+  while (i < kSizeClassCount && len > BufferPoolClassSize(i))
+    i++;
+  return i;
+}
+
+
+char* NodeBIOBufferPool::Allocate(size_t* len) {
+  const size_t size_class = SizeClassFor(*len);
+  if (size_class < kSizeClassCount) {
+    *len = BufferPoolClassSize(size_class);
+    std::vector<char*>& list = free_[size_class];
+    if (!list.empty()) {
+      char* data = list.back();
+      list.pop_back();
+      reused_++;
+      return data;
+    }
+  }
+
+  allocated_++;
+  env_->isolate()->AdjustAmountOfExternalAllocatedMemory(*len);
+  return new char[*len];
+}
+
+
+void NodeBIOBufferPool::Release(char* data, size_t len) {
+  const size_t size_class = SizeClassFor(len);
+  if (size_class < kSizeClassCount &&
+      len == BufferPoolClassSize(size_class) &&
+      free_[size_class].size() < kMaxFreeBuffers) {
+    free_[size_class].push_back(data);
+    return;
+  }
+
+  delete[] data;
+  env_->isolate()->AdjustAmountOfExternalAllocatedMemory(
+      -static_cast<int64_t>(len));
+}
+
+
 NodeBIO* NodeBIO::FromBIO(BIO* bio) {
   CHECK_NOT_NULL(BIO_get_data(bio));
   return static_cast<NodeBIO*>(BIO_get_data(bio));
@@ -30,9 +30,47 @@
 #include "util-inl.h"
 #include "v8.h"
 
+#include <vector>
+
 namespace node {
 namespace crypto {
 
+// Per-Environment free lists for the memory of NodeBIO buffers. TLS
+// connections fill and drain their BIOs in bursts, and without the pool
+// every burst would allocate and free the same few buffer sizes again.
+// Sizes are rounded up to one of a few size classes; larger buffers are not
+// pooled.
+class NodeBIOBufferPool {
+ public:
+  static constexpr size_t kSizeClassCount = 3;
+  // Maximum number of free buffers kept per size class.
+  static constexpr size_t kMaxFreeBuffers = 64;
+
+  explicit NodeBIOBufferPool(Environment* env);
+  ~NodeBIOBufferPool();
+
+  NodeBIOBufferPool(const NodeBIOBufferPool&) = delete;
+  NodeBIOBufferPool& operator=(const NodeBIOBufferPool&) = delete;
+
+  // Returns memory for at least `*len` bytes and stores its actual size in
+  // `*len`.
+  char* Allocate(size_t* len);
+  void Release(char* data, size_t len);
+
+  // Number of buffers that had to be allocated, and that came from the free
+  // lists instead.
+  inline uint64_t allocated() const { return allocated_; }
+  inline uint64_t reused() const { return reused_; }
+
+ private:
+  static size_t SizeClassFor(size_t len);
+
+  Environment* const env_;
+  std::vector<char*> free_[kSizeClassCount];
+  uint64_t allocated_ = 0;
+  uint64_t reused_ = 0;
+};
+
 // This class represents buffers for OpenSSL I/O, implemented as a singly-linked
 // list of chunks. It can be used either for writing data from Node to OpenSSL,
 // or for reading data back, but not both.
@@ -66,9 +104,11 @@ class NodeBIO : public MemoryRetainer {
   // contiguous data available to read
   char* Peek(size_t* size);
 
-  // Return pointers and sizes of multiple internal data chunks available for
-  // reading
-  size_t PeekMultiple(char** out, size_t* size, size_t* count);
+  // Fill `bufs` with up to `*count` internal data chunks available for
+  // reading, in order, so that they can be passed to a writev()-style call
+  // as they are. Stores the number of chunks in `*count` and returns their
+  // total size.
+  size_t PeekMultiple(uv_buf_t* bufs, size_t* count);
 
   // Find first appearance of `delim` in buffer or `limit` if `delim`
   // wasn't found.
@@ -138,17 +178,17 @@ class NodeBIO : public MemoryRetainer {
                                            write_pos_(0),
                                            len_(len),
                                            next_(nullptr) {
-      data_ = new char[len];
       if (env_ != nullptr)
-        env_->isolate()->AdjustAmountOfExternalAllocatedMemory(len);
+        data_ = env_->bio_buffer_pool()->Allocate(&len_);
+      else
+        data_ = new char[len];
     }
 
     ~Buffer() {
-      delete[] data_;
-      if (env_ != nullptr) {
-        const int64_t len = static_cast<int64_t>(len_);
-        env_->isolate()->AdjustAmountOfExternalAllocatedMemory(-len);
-      }
+      if (env_ != nullptr)
+        env_->bio_buffer_pool()->Release(data_, len_);
+      else
+        delete[] data_;
     }
 
     Environment* env_;
@@ -0,0 +1,331 @@
+#include "node_crypto_ktls.h"
+#include "node_crypto.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/tls.h>)
+#define NODE_HAVE_KTLS 1
+#endif
+#endif
+
+#ifdef NODE_HAVE_KTLS
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif  // NODE_HAVE_KTLS
+
+namespace node {
+namespace crypto {
+
+#ifdef NODE_HAVE_KTLS
+
+namespace {
+
+// TLS record content types.
+constexpr unsigned char kAlertRecord = 21;
+constexpr unsigned char kAlertLevelWarning = 1;
+constexpr unsigned char kAlertCloseNotify = 0;
+
+// Room for the one control message that carries a record type.
+constexpr size_t kControlSize = CMSG_SPACE(sizeof(unsigned char));
+
+struct KTLSCipher {
+  int nid;
+  uint16_t kernel_cipher;
+  size_t key_length;
+  // Length of the implicit part of the nonce that comes from the key block.
+  size_t fixed_iv_length;
+};
+
+const KTLSCipher kCiphers[] = {
+  { NID_aes_128_gcm, TLS_CIPHER_AES_GCM_128, 16, 4 },
+  { NID_aes_256_gcm, TLS_CIPHER_AES_GCM_256, 32, 4 },
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+  { NID_chacha20_poly1305, TLS_CIPHER_CHACHA20_POLY1305, 32, 12 },
+#endif
+};
+
+union KTLSCryptoInfo {
+  tls_crypto_info info;
+  tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+  tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+  tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#endif
+};
+
+const KTLSCipher* FindCipher(const SSL* ssl) {
+  if (SSL_version(ssl) != TLS1_2_VERSION)
+    return nullptr;
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr)
+    return nullptr;
+  const int nid = SSL_CIPHER_get_cipher_nid(cipher);
+  for (const KTLSCipher& c : kCiphers) {
+    if (c.nid == nid)
+      return &c;
+  }
+  return nullptr;
+}
+
+// key_block = PRF(master_secret, "key expansion",
+//                 server_random + client_random)
+// See RFC 5246, section 6.3.
+bool DeriveKeyBlock(SSL* ssl, unsigned char* out, size_t length) {
+  const EVP_MD* md =
+      SSL_CIPHER_get_handshake_digest(SSL_get_current_cipher(ssl));
+  SSL_SESSION* session = SSL_get_session(ssl);
+  if (md == nullptr || session == nullptr)
+    return false;
+
+  unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH];
+  const size_t master_key_length =
+      SSL_SESSION_get_master_key(session, master_key, sizeof(master_key));
+
+  unsigned char seed[2 * SSL3_RANDOM_SIZE];
+  SSL_get_server_random(ssl, seed, SSL3_RANDOM_SIZE);
+  SSL_get_client_random(ssl, seed + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+
+  static const unsigned char kLabel[] = "key expansion";
+  EVPKeyCtxPointer ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, nullptr));
+  const bool ok =
+      ctx &&
+      EVP_PKEY_derive_init(ctx.get()) > 0 &&
+      EVP_PKEY_CTX_set_tls1_prf_md(ctx.get(), md) > 0 &&
+      EVP_PKEY_CTX_set1_tls1_prf_secret(
+          ctx.get(), master_key, master_key_length) > 0 &&
+      EVP_PKEY_CTX_add1_tls1_prf_seed(
+          ctx.get(), kLabel, sizeof(kLabel) - 1) > 0 &&
+      EVP_PKEY_CTX_add1_tls1_prf_seed(ctx.get(), seed, sizeof(seed)) > 0 &&
+      EVP_PKEY_derive(ctx.get(), out, &length) > 0;
+
+  OPENSSL_cleanse(master_key, sizeof(master_key));
+  return ok;
+}
+
+template <typename T>
+void FillAEADInfo(T* info,
+                  uint16_t cipher_type,
+                  const unsigned char* key,
+                  const unsigned char* iv,
+                  const unsigned char* rec_seq) {
+  info->info.version = TLS_1_2_VERSION;
+  info->info.cipher_type = cipher_type;
+  memcpy(info->key, key, sizeof(info->key));
+  memcpy(info->salt, iv, sizeof(info->salt));
+  // The explicit part of the nonce only has to be unique per record, so the
+  // kernel may as well count it up from the sequence number.
+  memcpy(info->iv, rec_seq, sizeof(info->iv));
+  memcpy(info->rec_seq, rec_seq, sizeof(info->rec_seq));
+}
+
+size_t FillCryptoInfo(const KTLSCipher& cipher,
+                      const unsigned char* key,
+                      const unsigned char* iv,
+                      uint64_t seq,
+                      KTLSCryptoInfo* ci) {
+  unsigned char rec_seq[8];
+  for (int i = 7; i >= 0; i--) {
+    rec_seq[i] = seq & 0xff;
+    seq >>= 8;
+  }
+
+  memset(ci, 0, sizeof(*ci));
+  switch (cipher.kernel_cipher) {
+    case TLS_CIPHER_AES_GCM_128:
+      FillAEADInfo(&ci->aes_gcm_128, cipher.kernel_cipher, key, iv, rec_seq);
+      return sizeof(ci->aes_gcm_128);
+    case TLS_CIPHER_AES_GCM_256:
+      FillAEADInfo(&ci->aes_gcm_256, cipher.kernel_cipher, key, iv, rec_seq);
+      return sizeof(ci->aes_gcm_256);
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    case TLS_CIPHER_CHACHA20_POLY1305: {
+      tls12_crypto_info_chacha20_poly1305* info = &ci->chacha20_poly1305;
+      info->info.version = TLS_1_2_VERSION;
+      info->info.cipher_type = cipher.kernel_cipher;
+      memcpy(info->key, key, sizeof(info->key));
+      // The whole 96-bit nonce is implicit and XORed with the sequence number.
+      memcpy(info->iv, iv, sizeof(info->iv));
+      memcpy(info->rec_seq, rec_seq, sizeof(info->rec_seq));
+      return sizeof(*info);
+    }
+#endif
+    default:
+      UNREACHABLE();
+  }
+}
+
+int SetCryptoInfo(int fd, int direction, const KTLSCryptoInfo& ci,
+                  size_t size) {
+  if (setsockopt(fd, SOL_TLS, direction, &ci, size) != 0)
+    return uv_translate_sys_error(errno);
+  return 0;
+}
+
+}  // anonymous namespace
+
+bool CanUseKTLS(const SSL* ssl) {
+  return FindCipher(ssl) != nullptr;
+}
+
+int EnableKTLS(SSL* ssl,
+               int fd,
+               uint64_t write_seq,
+               uint64_t read_seq,
+               bool* partial) {
+  *partial = false;
+  const KTLSCipher* cipher = FindCipher(ssl);
+  if (cipher == nullptr)
+    return UV_ENOTSUP;
+
+  // client_write_key, server_write_key, client_write_IV, server_write_IV
+  // AEAD ciphers do not use MAC keys.
+  unsigned char key_block[2 * (32 + 12)];
+  const size_t key_length = cipher->key_length;
+  const size_t iv_length = cipher->fixed_iv_length;
+  if (!DeriveKeyBlock(ssl, key_block, 2 * (key_length + iv_length)))
+    return UV_EPROTO;
+
+  const unsigned char* client_key = key_block;
+  const unsigned char* server_key = client_key + key_length;
+  const unsigned char* client_iv = server_key + key_length;
+  const unsigned char* server_iv = client_iv + iv_length;
+  const bool is_server = SSL_is_server(ssl);
+
+  KTLSCryptoInfo tx;
+  KTLSCryptoInfo rx;
+  const size_t tx_size = FillCryptoInfo(*cipher,
+                                        is_server ? server_key : client_key,
+                                        is_server ? server_iv : client_iv,
+                                        write_seq,
+                                        &tx);
+  const size_t rx_size = FillCryptoInfo(*cipher,
+                                        is_server ? client_key : server_key,
+                                        is_server ? client_iv : server_iv,
+                                        read_seq,
+                                        &rx);
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+
+  int err = 0;
+  if (setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+    // ENOENT means that the `tls` module is not loaded.
+    err = errno == ENOENT ? UV_ENOTSUP : uv_translate_sys_error(errno);
+  }
+  // Without any keys, the `tls` ULP passes data through unchanged, so the
+  // connection can still fall back to OpenSSL if the transmit side fails.
+  if (err == 0)
+    err = SetCryptoInfo(fd, TLS_TX, tx, tx_size);
+  if (err == 0) {
+    err = SetCryptoInfo(fd, TLS_RX, rx, rx_size);
+    *partial = err != 0;
+  }
+
+  OPENSSL_cleanse(&tx, sizeof(tx));
+  OPENSSL_cleanse(&rx, sizeof(rx));
+  return err;
+}
+
+int SendKTLSCloseNotify(int fd) {
+  unsigned char alert[] = { kAlertLevelWarning, kAlertCloseNotify };
+  char control[kControlSize];
+  iovec iov = { alert, sizeof(alert) };
+
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+  *CMSG_DATA(cmsg) = kAlertRecord;
+
+  ssize_t r;
+  do {
+    r = sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+  } while (r == -1 && errno == EINTR);
+  return r == -1 ? uv_translate_sys_error(errno) : 0;
+}
+
+int ReadKTLSControlRecord(int fd) {
+  unsigned char data[64];
+  char control[kControlSize];
+  iovec iov = { data, sizeof(data) };
+
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t r;
+  do {
+    r = recvmsg(fd, &msg, MSG_DONTWAIT);
+  } while (r == -1 && errno == EINTR);
+  if (r == -1)
+    return uv_translate_sys_error(errno);
+  if (r == 0)
+    return UV_EOF;
+
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+       cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_TLS || cmsg->cmsg_type != TLS_GET_RECORD_TYPE)
+      continue;
+    if (*CMSG_DATA(cmsg) == kAlertRecord && r >= 2 &&
+        data[1] == kAlertCloseNotify) {
+      return UV_EOF;
+    }
+    break;
+  }
+  // Fatal alerts, and handshake messages that would need OpenSSL to process
+  // them, such as a renegotiation request.
+  return UV_EPROTO;
+}
+
+#else  // !NODE_HAVE_KTLS
+
+bool CanUseKTLS(const SSL* ssl) {
+  return false;
+}
+
+int EnableKTLS(SSL* ssl,
+               int fd,
+               uint64_t write_seq,
+               uint64_t read_seq,
+               bool* partial) {
+  *partial = false;
+  return UV_ENOTSUP;
+}
+
+int SendKTLSCloseNotify(int fd) {
+  return UV_ENOTSUP;
+}
+
+int ReadKTLSControlRecord(int fd) {
+  return UV_ENOTSUP;
+}
+
+#endif  // NODE_HAVE_KTLS
+
+}  // namespace crypto
+}  // namespace node
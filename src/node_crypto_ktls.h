@@ -0,0 +1,56 @@
+#ifndef SRC_NODE_CRYPTO_KTLS_H_
+#define SRC_NODE_CRYPTO_KTLS_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <openssl/ssl.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace node {
+namespace crypto {
+
+// Kernel TLS (kTLS) offload on Linux.
+//
+// Once a TLS 1.2 connection with an AES-GCM or ChaCha20-Poly1305 cipher has
+// completed its handshake, the record keys can be handed to the kernel, after
+// which the socket carries plaintext on the application side and the kernel
+// encrypts and decrypts records itself. OpenSSL 1.1.1 has no kTLS support and
+// does not expose its record sequence numbers, so the keys are re-derived from
+// the master secret here and the sequence numbers have to be tracked by the
+// caller, e.g. by counting records in an SSL message callback.
+//
+// TLS 1.3 is not supported: post-handshake messages (session tickets, key
+// updates) are common there and cannot be handled once OpenSSL is no longer in
+// the data path.
+
+// Whether this build can offload the connection's current cipher at all.
+bool CanUseKTLS(const SSL* ssl);
+
+// Installs the keys of `ssl` for both directions of the TCP socket `fd`.
+// `write_seq` and `read_seq` are the sequence numbers of the next records
+// that are going to be sent and received. Returns 0 or a libuv error code.
+// On failure, the socket is left as it was, unless `partial` is set: then the
+// transmit side has already been switched and the connection has to be
+// closed.
+int EnableKTLS(SSL* ssl,
+               int fd,
+               uint64_t write_seq,
+               uint64_t read_seq,
+               bool* partial);
+
+// Sends a close_notify alert through a socket that has kTLS enabled.
+int SendKTLSCloseNotify(int fd);
+
+// Reads a non-application-data record from a socket that has kTLS enabled,
+// after a read() on it failed with EIO. Returns UV_EOF for a close_notify
+// alert and an error code otherwise.
+int ReadKTLSControlRecord(int fd);
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_KTLS_H_
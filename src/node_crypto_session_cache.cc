@@ -0,0 +1,104 @@
+#include "node_crypto_session_cache.h"
+#include "node_crypto.h"
+#include "util.h"
+
+#include <openssl/rand.h>
+
+namespace node {
+namespace crypto {
+
+SharedSessionCache* SharedSessionCache::GetInstance() {
+  // Intentionally leaked, Worker threads may still use it during exit.
+  static SharedSessionCache* cache = new SharedSessionCache();
+  return cache;
+}
+
+
+SharedSessionCache::SharedSessionCache() {
+  CHECK_EQ(RAND_bytes(ticket_keys_, sizeof(ticket_keys_)), 1);
+}
+
+
+// The length prefix keeps a session ID context that ends like another one
+// starts from producing the same key.
+std::string SharedSessionCache::MakeKey(const unsigned char* sid_ctx,
+                                        size_t sid_ctx_length,
+                                        const unsigned char* id,
+                                        size_t id_length) {
+  std::string key(1, static_cast<char>(sid_ctx_length));
+  key.append(reinterpret_cast<const char*>(sid_ctx), sid_ctx_length);
+  key.append(reinterpret_cast<const char*>(id), id_length);
+  return key;
+}
+
+
+void SharedSessionCache::Add(SSL_SESSION* session) {
+  unsigned int id_length;
+  const unsigned char* id = SSL_SESSION_get_id(session, &id_length);
+  if (id_length == 0)
+    return;
+
+  int size = i2d_SSL_SESSION(session, nullptr);
+  if (size <= 0 || size > SecureContext::kMaxSessionSize)
+    return;
+
+  // Serialize outside of the lock.
+  std::vector<unsigned char> data(size);
+  unsigned char* p = data.data();
+  i2d_SSL_SESSION(session, &p);
+  unsigned int sid_ctx_length;
+  const unsigned char* sid_ctx =
+      SSL_SESSION_get0_id_context(session, &sid_ctx_length);
+  std::string key = MakeKey(sid_ctx, sid_ctx_length, id, id_length);
+
+  Mutex::ScopedLock lock(mutex_);
+  auto it = sessions_.find(key);
+  if (it != sessions_.end()) {
+    it->second = std::move(data);
+    return;
+  }
+
+  while (sessions_.size() >= kMaxEntries) {
+    sessions_.erase(order_.front());
+    order_.pop_front();
+  }
+  order_.push_back(key);
+  sessions_.emplace(std::move(key), std::move(data));
+}
+
+
+SSL_SESSION* SharedSessionCache::Get(const std::string& sid_ctx,
+                                     const unsigned char* id,
+                                     size_t id_length) {
+  std::string key =
+      MakeKey(reinterpret_cast<const unsigned char*>(sid_ctx.data()),
+              sid_ctx.size(), id, id_length);
+  std::vector<unsigned char> data;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = sessions_.find(key);
+    if (it != sessions_.end())
+      data = it->second;
+  }
+
+  SSL_SESSION* session = nullptr;
+  if (!data.empty()) {
+    const unsigned char* p = data.data();
+    session = d2i_SSL_SESSION(nullptr, &p, data.size());
+  }
+
+  if (session != nullptr)
+    hits_++;
+  else
+    misses_++;
+  return session;
+}
+
+
+size_t SharedSessionCache::size() {
+  Mutex::ScopedLock lock(mutex_);
+  return sessions_.size();
+}
+
+}  // namespace crypto
+}  // namespace node
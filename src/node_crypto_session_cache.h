@@ -0,0 +1,80 @@
+#ifndef SRC_NODE_CRYPTO_SESSION_CACHE_H_
+#define SRC_NODE_CRYPTO_SESSION_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+
+#include <openssl/ssl.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+namespace crypto {
+
+// A process-wide cache of TLS server sessions, keyed by session ID context
+// and session ID.
+//
+// Server SecureContexts that opt into it store new sessions here and look
+// sessions up here directly from OpenSSL's session callbacks, without a trip
+// to JavaScript. Because it is shared by all Environments in the process,
+// a client that reconnects to a server running in a different Worker thread
+// can still resume its session.
+//
+// Sessions are stored in their serialized form, so that no SSL_SESSION is
+// shared between threads. OpenSSL checks the timeout of a session itself
+// after it has been looked up.
+//
+// Sessions resumed from a ticket never reach the cache. For those to be
+// resumable on every server that opts in, the servers share one set of
+// ticket keys, which is generated once per process.
+class SharedSessionCache {
+ public:
+  // Same as OpenSSL's default session cache size.
+  static constexpr size_t kMaxEntries = 20 * 1024;
+  // Name, HMAC secret and AES key, in the layout of setTicketKeys().
+  static constexpr size_t kTicketKeysLength = 48;
+
+  static SharedSessionCache* GetInstance();
+
+  void Add(SSL_SESSION* session);
+  // Returns a new reference to the session, or nullptr.
+  SSL_SESSION* Get(const std::string& sid_ctx,
+                   const unsigned char* id,
+                   size_t id_length);
+
+  inline const unsigned char* ticket_keys() const { return ticket_keys_; }
+
+  inline uint64_t hits() const { return hits_; }
+  inline uint64_t misses() const { return misses_; }
+  size_t size();
+
+ private:
+  SharedSessionCache();
+
+  static std::string MakeKey(const unsigned char* sid_ctx,
+                             size_t sid_ctx_length,
+                             const unsigned char* id,
+                             size_t id_length);
+
+  unsigned char ticket_keys_[kTicketKeysLength];
+  Mutex mutex_;
+  std::unordered_map<std::string, std::vector<unsigned char>> sessions_;
+  // Insertion order, for evicting the oldest sessions first.
+  std::deque<std::string> order_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_SESSION_CACHE_H_
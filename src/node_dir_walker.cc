@@ -0,0 +1,491 @@
+#include "node_dir_walker.h"
+#include "async_wrap-inl.h"
+#include "env-inl.h"
+#include "node_errors.h"
+#include "node_file.h"
+#include "util-inl.h"
+
+#include <cstring>
+
+#ifdef __POSIX__
+# include <dirent.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#ifdef __linux__
+# include <sys/syscall.h>
+#endif
+
+namespace node {
+namespace fs {
+
+using v8::Array;
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::Float64Array;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Int32;
+using v8::Isolate;
+using v8::Local;
+using v8::Null;
+using v8::Object;
+using v8::String;
+using v8::Uint32Array;
+using v8::Uint8Array;
+using v8::Undefined;
+using v8::Value;
+
+namespace {
+
+#ifdef __POSIX__
+constexpr char kSeparator = '/';
+#else
+constexpr char kSeparator = '\\';
+#endif
+
+#if defined(__POSIX__) && defined(DT_DIR)
+uv_dirent_type_t DirentType(unsigned char type) {
+  switch (type) {
+    case DT_DIR: return UV_DIRENT_DIR;
+    case DT_REG: return UV_DIRENT_FILE;
+    case DT_LNK: return UV_DIRENT_LINK;
+    case DT_FIFO: return UV_DIRENT_FIFO;
+    case DT_SOCK: return UV_DIRENT_SOCKET;
+    case DT_CHR: return UV_DIRENT_CHAR;
+    case DT_BLK: return UV_DIRENT_BLOCK;
+    default: return UV_DIRENT_UNKNOWN;
+  }
+}
+#endif
+
+bool IsDotOrDotDot(const char* name) {
+  return name[0] == '.' &&
+         (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+}  // anonymous namespace
+
+// A directory that is being listed. The Linux version reads it in large
+// chunks with getdents64(2); other POSIX systems use readdir(3) and fall
+// back to uv_fs_scandir() elsewhere. Where there are file descriptors,
+// subdirectories are opened relative to the directory they were found in,
+// which keeps the kernel from resolving the whole path again.
+class DirWalker::Dir {
+ public:
+  struct Entry {
+    const char* name;
+    uv_dirent_type_t type;
+    uint64_t ino;
+  };
+
+  Dir() = default;
+  ~Dir();
+
+  Dir(const Dir&) = delete;
+  Dir& operator=(const Dir&) = delete;
+
+  int Open(uv_loop_t* loop, const PendingDir& dir);
+
+  // Returns 1 and fills `entry` if there is another entry, 0 at the end of
+  // the directory or a negative error code.
+  int Next(Entry* entry);
+
+ private:
+#ifdef __POSIX__
+  int fd_ = -1;
+#endif
+#ifdef __linux__
+  // Matches struct linux_dirent64, which glibc does not export.
+  struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    uint16_t d_reclen;
+    uint8_t d_type;
+    char d_name[1];
+  };
+
+  char buf_[32 * 1024];
+  size_t pos_ = 0;
+  size_t len_ = 0;
+#elif defined(__POSIX__)
+  DIR* dir_ = nullptr;
+#else
+  uv_fs_t req_;
+  bool req_used_ = false;
+#endif
+};
+
+DirWalker::Dir::~Dir() {
+#ifdef __linux__
+  if (fd_ != -1) close(fd_);
+#elif defined(__POSIX__)
+  if (dir_ != nullptr)
+    closedir(dir_);
+  else if (fd_ != -1)
+    close(fd_);
+#else
+  if (req_used_) uv_fs_req_cleanup(&req_);
+#endif
+}
+
+int DirWalker::Dir::Open(uv_loop_t* loop, const PendingDir& dir) {
+#ifdef __POSIX__
+  int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+  int fd;
+  do {
+    if (dir.parent) {
+      // Entries are listed as directories but never followed as links.
+      fd = openat(dir.parent->fd_, dir.name.c_str(), flags | O_NOFOLLOW);
+    } else {
+      fd = open(dir.path.c_str(), flags);
+    }
+  } while (fd == -1 && errno == EINTR);
+  if (fd == -1) return uv_translate_sys_error(errno);
+  fd_ = fd;
+#ifndef __linux__
+  dir_ = fdopendir(fd_);
+  if (dir_ == nullptr) return uv_translate_sys_error(errno);
+#endif
+  return 0;
+#else
+  req_used_ = true;
+  int err = uv_fs_scandir(loop, &req_, dir.path.c_str(), 0, nullptr);
+  return err < 0 ? err : 0;
+#endif
+}
+
+int DirWalker::Dir::Next(Entry* entry) {
+#ifdef __linux__
+  if (pos_ >= len_) {
+    ssize_t n;
+    do {
+      n = syscall(SYS_getdents64, fd_, buf_, sizeof(buf_));
+    } while (n == -1 && errno == EINTR);
+    if (n == -1) return uv_translate_sys_error(errno);
+    if (n == 0) return 0;
+    pos_ = 0;
+    len_ = static_cast<size_t>(n);
+  }
+  const LinuxDirent64* ent =
+      reinterpret_cast<const LinuxDirent64*>(buf_ + pos_);
+  pos_ += ent->d_reclen;
+  entry->name = ent->d_name;
+  entry->type = DirentType(ent->d_type);
+  entry->ino = ent->d_ino;
+  return 1;
+#elif defined(__POSIX__)
+  errno = 0;
+  struct dirent* ent = readdir(dir_);
+  if (ent == nullptr) return errno == 0 ? 0 : uv_translate_sys_error(errno);
+  entry->name = ent->d_name;
+#ifdef DT_DIR
+  entry->type = DirentType(ent->d_type);
+#else
+  entry->type = UV_DIRENT_UNKNOWN;
+#endif
+  entry->ino = ent->d_ino;
+  return 1;
+#else
+  uv_dirent_t ent;
+  int err = uv_fs_scandir_next(&req_, &ent);
+  if (err == UV_EOF) return 0;
+  if (err < 0) return err;
+  entry->name = ent.name;
+  entry->type = ent.type;
+  entry->ino = 0;
+  return 1;
+#endif
+}
+
+DirWalker::DirWalker(Environment* env,
+                     Local<Object> wrap,
+                     std::string&& root,
+                     int max_depth,
+                     bool stat)
+    : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_DIRWALKER),
+      ThreadPoolWork(env, UV_WORK_FAST_IO),
+      root_(std::move(root)),
+      max_depth_(max_depth),
+      stat_(stat),
+      loop_(env->event_loop()) {
+  MakeWeak();
+}
+
+DirWalker::~DirWalker() {
+  CHECK(!read_in_progress_);
+}
+
+void DirWalker::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("pending", pending_.size() * sizeof(PendingDir));
+  tracker->TrackFieldWithSize("names", names_.capacity());
+  tracker->TrackField("name_ends", name_ends_);
+  tracker->TrackField("types", types_);
+  tracker->TrackField("inodes", inodes_);
+  tracker->TrackField("parents", parents_);
+  tracker->TrackFieldWithSize("stats", stats_.capacity() * sizeof(uv_stat_t));
+}
+
+void DirWalker::Fail(int err, const char* syscall, const std::string& path) {
+  error_ = err;
+  error_syscall_ = syscall;
+  error_path_ = path;
+  done_ = true;
+  pending_.clear();
+  current_.reset();
+}
+
+// Lists entries until the batch is full or the whole tree has been walked.
+// This runs on the threadpool and must not touch any JS state.
+int DirWalker::ReadBatch() {
+  names_.clear();
+  name_ends_.clear();
+  types_.clear();
+  inodes_.clear();
+  parents_.clear();
+  stats_.clear();
+
+  if (!started_) {
+    started_ = true;
+    pending_.push_back({ nullptr, std::string(), root_, 0, 0 });
+  }
+
+  while (types_.size() < kBatchSize) {
+    if (!current_) {
+      if (pending_.empty()) {
+        done_ = true;
+        break;
+      }
+      PendingDir next = std::move(pending_.back());
+      pending_.pop_back();
+      if (IsExcluded(next.id)) continue;
+
+      std::shared_ptr<Dir> dir = std::make_shared<Dir>();
+      int err = dir->Open(loop_, next);
+      if (err < 0) {
+        Fail(err, "scandir", next.path);
+        return err;
+      }
+      current_ = std::move(dir);
+      current_path_ = std::move(next.path);
+      current_id_ = next.id;
+      current_depth_ = next.depth;
+    }
+
+    Dir::Entry entry;
+    int r = current_->Next(&entry);
+    if (r < 0) {
+      Fail(r, "scandir", current_path_);
+      return r;
+    }
+    if (r == 0) {
+      current_.reset();
+      continue;
+    }
+    if (IsDotOrDotDot(entry.name)) continue;
+
+    // Paths are only needed for some entries; most files never get one.
+    std::string path;
+    uv_stat_t statbuf;
+    if (stat_ || entry.type == UV_DIRENT_UNKNOWN) {
+      path = current_path_ + kSeparator + entry.name;
+      uv_fs_t req;
+      int err = uv_fs_lstat(loop_, &req, path.c_str(), nullptr);
+      if (err == 0) statbuf = req.statbuf;
+      uv_fs_req_cleanup(&req);
+      // The entry has been removed since the directory was listed.
+      if (err == UV_ENOENT) continue;
+      if (err < 0) {
+        Fail(err, "lstat", path);
+        return err;
+      }
+      if (entry.type == UV_DIRENT_UNKNOWN)
+        entry.type = DirentTypeFromMode(statbuf.st_mode);
+      if (entry.ino == 0)
+        entry.ino = statbuf.st_ino;
+    }
+
+    names_.append(entry.name);
+    name_ends_.push_back(names_.size());
+    types_.push_back(entry.type);
+    inodes_.push_back(static_cast<double>(entry.ino));
+    parents_.push_back(current_id_);
+    if (stat_) stats_.push_back(statbuf);
+
+    if (entry.type == UV_DIRENT_DIR) {
+      const uint32_t id = next_id_++;
+      if ((max_depth_ < 0 || current_depth_ < max_depth_) &&
+          !IsExcluded(current_id_)) {
+        if (path.empty()) path = current_path_ + kSeparator + entry.name;
+        pending_.push_back({ current_, entry.name, std::move(path), id,
+                             current_depth_ + 1 });
+      }
+    }
+  }
+
+  return 0;
+}
+
+void DirWalker::DoThreadPoolWork() {
+  ReadBatch();
+}
+
+void DirWalker::AfterThreadPoolWork(int status) {
+  read_in_progress_ = false;
+  MakeWeak();
+
+  if (status == UV_ECANCELED || closed_) {
+    pending_.clear();
+    current_.reset();
+    return;
+  }
+  CHECK_EQ(status, 0);
+
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+  Context::Scope context_scope(env()->context());
+
+  if (error_ < 0) {
+    Local<Value> argv[] = {
+      UVException(isolate, error_, error_syscall_, nullptr,
+                  error_path_.c_str(), nullptr)
+    };
+    MakeCallback(env()->oncomplete_string(), arraysize(argv), argv);
+    return;
+  }
+
+  const size_t count = types_.size();
+  std::vector<Local<Value>> names(count);
+  size_t start = 0;
+  for (size_t i = 0; i < count; i++) {
+    names[i] = String::NewFromUtf8(isolate,
+                                   names_.data() + start,
+                                   v8::NewStringType::kNormal,
+                                   name_ends_[i] - start).ToLocalChecked();
+    start = name_ends_[i];
+  }
+
+  Local<ArrayBuffer> types_ab = ArrayBuffer::New(isolate, count);
+  if (count > 0)
+    memcpy(types_ab->GetContents().Data(), types_.data(), count);
+
+  Local<ArrayBuffer> inodes_ab =
+      ArrayBuffer::New(isolate, count * sizeof(double));
+  if (count > 0) {
+    memcpy(inodes_ab->GetContents().Data(), inodes_.data(),
+           count * sizeof(double));
+  }
+
+  Local<ArrayBuffer> parents_ab =
+      ArrayBuffer::New(isolate, count * sizeof(uint32_t));
+  if (count > 0) {
+    memcpy(parents_ab->GetContents().Data(), parents_.data(),
+           count * sizeof(uint32_t));
+  }
+
+  Local<Value> stats = Undefined(isolate);
+  if (stat_) {
+    Local<ArrayBuffer> stats_ab = ArrayBuffer::New(
+        isolate, count * kFsStatsFieldsNumber * sizeof(double));
+    double* fields = static_cast<double*>(stats_ab->GetContents().Data());
+    for (size_t i = 0; i < count; i++)
+      FillStatsFields(fields + i * kFsStatsFieldsNumber, &stats_[i]);
+    stats = Float64Array::New(stats_ab, 0, count * kFsStatsFieldsNumber);
+  }
+
+  Local<Value> argv[] = {
+    Null(isolate),
+    Array::New(isolate, names.data(), count),
+    Uint8Array::New(types_ab, 0, count),
+    Float64Array::New(inodes_ab, 0, count),
+    Uint32Array::New(parents_ab, 0, count),
+    stats,
+    v8::Boolean::New(isolate, done_)
+  };
+
+  // The batch is owned by JS now.
+  names_.clear();
+  name_ends_.clear();
+  types_.clear();
+  inodes_.clear();
+  parents_.clear();
+  stats_.clear();
+
+  MakeCallback(env()->oncomplete_string(), arraysize(argv), argv);
+}
+
+// new DirWalker(root, maxDepth, stat)
+void DirWalker::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  CHECK_EQ(args.Length(), 3);
+
+  BufferValue root(env->isolate(), args[0]);
+  CHECK_NOT_NULL(*root);
+  CHECK(args[1]->IsInt32());
+  const int max_depth = args[1].As<Int32>()->Value();
+
+  new DirWalker(env, args.This(), std::string(*root, root.length()),
+                max_depth, args[2]->IsTrue());
+}
+
+// walker.read(excluded)
+// `excluded` is an optional Uint32Array of directory numbers that are not
+// to be listed; entries that have already been found in them are still
+// reported.
+void DirWalker::Read(const FunctionCallbackInfo<Value>& args) {
+  DirWalker* walker;
+  ASSIGN_OR_RETURN_UNWRAP(&walker, args.Holder());
+  CHECK(!walker->read_in_progress_);
+  CHECK(!walker->closed_);
+  CHECK(!walker->done_);
+
+  if (args[0]->IsUint32Array()) {
+    Local<Uint32Array> excluded = args[0].As<Uint32Array>();
+    const size_t length = excluded->Length();
+    uint32_t* ids = reinterpret_cast<uint32_t*>(
+        static_cast<char*>(excluded->Buffer()->GetContents().Data()) +
+        excluded->ByteOffset());
+    walker->excluded_.insert(ids, ids + length);
+    if (walker->current_ && walker->IsExcluded(walker->current_id_))
+      walker->current_.reset();
+  }
+
+  walker->read_in_progress_ = true;
+  walker->ClearWeak();
+  walker->ScheduleWork();
+}
+
+// walker.close()
+void DirWalker::Close(const FunctionCallbackInfo<Value>& args) {
+  DirWalker* walker;
+  ASSIGN_OR_RETURN_UNWRAP(&walker, args.Holder());
+  walker->closed_ = true;
+  if (!walker->read_in_progress_) {
+    walker->pending_.clear();
+    walker->current_.reset();
+  }
+}
+
+void DirWalker::Initialize(Environment* env, Local<Object> target) {
+  Isolate* isolate = env->isolate();
+  HandleScope scope(isolate);
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(DirWalker::New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  Local<String> dirWalkerString =
+      FIXED_ONE_BYTE_STRING(isolate, "DirWalker");
+  t->SetClassName(dirWalkerString);
+
+  env->SetProtoMethod(t, "read", DirWalker::Read);
+  env->SetProtoMethod(t, "close", DirWalker::Close);
+
+  target->Set(env->context(), dirWalkerString,
+              t->GetFunction(env->context()).ToLocalChecked()).FromJust();
+}
+
+}  // namespace fs
+}  // namespace node
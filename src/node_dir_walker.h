@@ -0,0 +1,105 @@
+#ifndef SRC_NODE_DIR_WALKER_H_
+#define SRC_NODE_DIR_WALKER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "async_wrap.h"
+#include "env.h"
+#include "node_internals.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace node {
+namespace fs {
+
+// Walks a directory tree on the threadpool. Every read() lists up to
+// kBatchSize entries, reading directories with getdents64(2) and opening
+// subdirectories relative to their parent with openat(2) where available,
+// and hands them to JS at once as flat arrays.
+class DirWalker : public AsyncWrap, public ThreadPoolWork {
+ public:
+  static constexpr size_t kBatchSize = 4096;
+
+  static void Initialize(Environment* env, v8::Local<v8::Object> target);
+
+  ~DirWalker() override;
+
+  void DoThreadPoolWork() override;
+  void AfterThreadPoolWork(int status) override;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(DirWalker)
+  SET_SELF_SIZE(DirWalker)
+
+ private:
+  class Dir;
+
+  // A directory that has been found but not been listed yet. Directories are
+  // numbered in the order in which they are reported, the root being 0.
+  struct PendingDir {
+    std::shared_ptr<Dir> parent;
+    std::string name;
+    std::string path;
+    uint32_t id;
+    int depth;
+  };
+
+  DirWalker(Environment* env,
+            v8::Local<v8::Object> wrap,
+            std::string&& root,
+            int max_depth,
+            bool stat);
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Read(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  int ReadBatch();
+  void Fail(int err, const char* syscall, const std::string& path);
+  bool IsExcluded(uint32_t id) const {
+    return !excluded_.empty() && excluded_.count(id) != 0;
+  }
+
+  const std::string root_;
+  const int max_depth_;
+  const bool stat_;
+  uv_loop_t* const loop_;
+
+  bool started_ = false;
+  bool done_ = false;
+  bool read_in_progress_ = false;
+  bool closed_ = false;
+
+  std::vector<PendingDir> pending_;
+  std::shared_ptr<Dir> current_;
+  std::string current_path_;
+  uint32_t current_id_ = 0;
+  int current_depth_ = 0;
+  uint32_t next_id_ = 1;
+  std::unordered_set<uint32_t> excluded_;
+
+  // The entries of the last batch. The names are stored back to back, and
+  // `parents_` holds the number of the directory that each entry is in.
+  std::string names_;
+  std::vector<uint32_t> name_ends_;
+  std::vector<uint8_t> types_;
+  std::vector<double> inodes_;
+  std::vector<uint32_t> parents_;
+  std::vector<uv_stat_t> stats_;
+
+  int error_ = 0;
+  const char* error_syscall_ = nullptr;
+  std::string error_path_;
+};
+
+}  // namespace fs
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_DIR_WALKER_H_
@@ -22,6 +22,9 @@
 #include "node_file.h"
 #include "aliased_buffer.h"
 #include "node_buffer.h"
+#include "node_dir_walker.h"
+#include "node_module_resolution_cache.h"
+#include "node_package_json.h"
 #include "node_process.h"
 #include "node_stat_watcher.h"
 #include "util.h"
@@ -81,6 +84,14 @@ using v8::Value;
 # define S_ISDIR(mode)  (((mode) & S_IFMT) == S_IFDIR)
 #endif
 
+#ifndef S_ISREG
+# define S_ISREG(mode)  (((mode) & S_IFMT) == S_IFREG)
+#endif
+
+#ifndef S_ISLNK
+# define S_ISLNK(mode)  (((mode) & S_IFMT) == S_IFLNK)
+#endif
+
 #ifdef __POSIX__
 constexpr char kPathSeparator = '/';
 #else
@@ -883,6 +894,101 @@ static void InternalModuleReadJSON(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+// Used to speed up module loading. Returns the "main", "exports" (as raw JSON
+// text) and "type" fields of a package.json file as an array, undefined when
+// the file does not exist, or null when the file needs to be parsed in full
+// with InternalModuleReadJSON() and JSON.parse(). Results are cached
+// process-wide, see node_package_json.h.
+static void InternalModuleReadPackageJSON(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(isolate, args[0]);
+
+  if (strlen(*path) != path.length())
+    return;  // Contains a nul byte.
+
+  std::shared_ptr<const package_json::PackageFields> fields;
+  switch (package_json::Read(std::string(*path, path.length()), &fields)) {
+    case package_json::ReadResult::kNotFound:
+      return;
+    case package_json::ReadResult::kNeedsFullParse:
+      return args.GetReturnValue().SetNull();
+    case package_json::ReadResult::kOk:
+      break;
+  }
+
+  auto to_string = [&](bool present, const std::string& value) {
+    if (!present)
+      return Undefined(isolate).As<Value>();
+    return String::NewFromUtf8(isolate,
+                               value.data(),
+                               v8::NewStringType::kNormal,
+                               value.size()).ToLocalChecked().As<Value>();
+  };
+  Local<Value> values[] = {
+    to_string(fields->has_main, fields->main),
+    to_string(fields->has_exports, fields->exports),
+    to_string(fields->has_type, fields->type)
+  };
+  args.GetReturnValue().Set(Array::New(isolate, values, arraysize(values)));
+}
+
+// Backs --module-resolution-cache. Returns the cached filename for a
+// resolution key, or undefined.
+static void InternalModuleResolutionCacheLookup(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  node::Utf8Value key(env->isolate(), args[0]);
+
+  std::string filename;
+  if (!module_resolution_cache::Lookup(std::string(*key, key.length()),
+                                       &filename)) {
+    return;
+  }
+  args.GetReturnValue().Set(
+      String::NewFromUtf8(env->isolate(),
+                          filename.data(),
+                          v8::NewStringType::kNormal,
+                          filename.size()).ToLocalChecked());
+}
+
+static void InternalModuleResolutionCacheRecord(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsString());
+  CHECK(args[2]->IsArray());
+  node::Utf8Value key(env->isolate(), args[0]);
+  node::Utf8Value filename(env->isolate(), args[1]);
+
+  if (strlen(*filename) != filename.length())
+    return;  // Contains a nul byte.
+
+  Local<Array> paths = args[2].As<Array>();
+  std::vector<std::string> dependencies;
+  dependencies.reserve(paths->Length());
+  for (uint32_t i = 0; i < paths->Length(); i++) {
+    Local<Value> path;
+    if (!paths->Get(env->context(), i).ToLocal(&path))
+      return;
+    CHECK(path->IsString());
+    node::Utf8Value dependency(env->isolate(), path);
+    if (strlen(*dependency) != dependency.length())
+      return;
+    dependencies.emplace_back(*dependency, dependency.length());
+  }
+
+  module_resolution_cache::Record(std::string(*key, key.length()),
+                                  std::string(*filename, filename.length()),
+                                  dependencies);
+}
+
 // Used to speed up module loading.  Returns 0 if the path refers to
 // a file, 1 when it's a directory or < 0 on error (usually -ENOENT.)
 // The speedup comes from not creating thousands of Stat and Error objects.
@@ -1625,6 +1731,359 @@ static void CopyFile(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+static std::string CopyDirJoin(const std::string& dir, const char* name) {
+#ifdef __POSIX__
+  return dir + '/' + name;
+#else
+  return dir + '\\' + name;
+#endif
+}
+
+// Copying a directory into itself would never finish.
+static bool CopyDirIsInside(const std::string& src, const std::string& dest) {
+  const std::string prefix = CopyDirJoin(src, "");
+  return dest == src || dest.compare(0, prefix.size(), prefix) == 0;
+}
+
+// A single step of a recursive directory copy. Each of these owns the libuv
+// request it runs on, and is released once its entry has been copied.
+struct CopyDirRequest {
+  uv_fs_t req;
+  CopyDirData* data;
+  CopyDirData::Entry entry;
+};
+
+static void CopyDirPump(uv_loop_t* loop, CopyDirData* data);
+static int CopyDirStart(uv_loop_t* loop,
+                        CopyDirRequest* r,
+                        const char** syscall);
+
+static void CopyDirFinish(uv_loop_t* loop,
+                          CopyDirRequest* r,
+                          int err,
+                          const char* syscall) {
+  CopyDirData* data = r->data;
+  if (err < 0) {
+    data->Fail(err, syscall, r->entry.src,
+               r->entry.type == UV_DIRENT_DIR ? "" : r->entry.dest);
+  }
+  uv_fs_req_cleanup(&r->req);
+  delete r;
+  data->in_flight--;
+  CopyDirPump(loop, data);
+}
+
+static void CopyDirAfterStep(uv_fs_t* req, const char* syscall) {
+  CopyDirRequest* r = ContainerOf(&CopyDirRequest::req, req);
+  CopyDirFinish(req->loop, r, req->result < 0 ? req->result : 0, syscall);
+}
+
+static void CopyDirAfterScandir(uv_fs_t* req) {
+  CopyDirRequest* r = ContainerOf(&CopyDirRequest::req, req);
+  if (req->result < 0)
+    return CopyDirFinish(req->loop, r, req->result, "scandir");
+
+  uv_dirent_t ent;
+  int err;
+  while ((err = uv_fs_scandir_next(req, &ent)) == 0) {
+    r->data->pending.push_back({ ent.type,
+                                 CopyDirJoin(r->entry.src, ent.name),
+                                 CopyDirJoin(r->entry.dest, ent.name) });
+  }
+  CopyDirFinish(req->loop, r, err == UV_EOF ? 0 : err, "scandir");
+}
+
+static void CopyDirAfterMkdir(uv_fs_t* req) {
+  CopyDirRequest* r = ContainerOf(&CopyDirRequest::req, req);
+  uv_loop_t* loop = req->loop;
+  int err = req->result;
+  if (err < 0 && err != UV_EEXIST)
+    return CopyDirFinish(loop, r, err, "mkdir");
+
+  uv_fs_req_cleanup(req);
+  err = uv_fs_scandir(loop, req, r->entry.src.c_str(), 0,
+                      CopyDirAfterScandir);
+  if (err < 0) CopyDirFinish(loop, r, err, "scandir");
+}
+
+static void CopyDirAfterReadLink(uv_fs_t* req) {
+  CopyDirRequest* r = ContainerOf(&CopyDirRequest::req, req);
+  uv_loop_t* loop = req->loop;
+  if (req->result < 0)
+    return CopyDirFinish(loop, r, req->result, "readlink");
+
+  std::string target(static_cast<const char*>(req->ptr));
+  uv_fs_req_cleanup(req);
+  int err = uv_fs_symlink(loop, req, target.c_str(), r->entry.dest.c_str(), 0,
+                          uv_fs_callback_t{[](uv_fs_t* req) {
+    CopyDirAfterStep(req, "symlink");
+  }});
+  if (err < 0) CopyDirFinish(loop, r, err, "symlink");
+}
+
+static void CopyDirAfterLStat(uv_fs_t* req) {
+  CopyDirRequest* r = ContainerOf(&CopyDirRequest::req, req);
+  uv_loop_t* loop = req->loop;
+  if (req->result < 0)
+    return CopyDirFinish(loop, r, req->result, "lstat");
+
+  r->entry.type = DirentTypeFromMode(req->statbuf.st_mode);
+  if (r->entry.type == UV_DIRENT_UNKNOWN)
+    return CopyDirFinish(loop, r, UV_ENOTSUP, "copydir");
+
+  uv_fs_req_cleanup(req);
+  const char* syscall;
+  int err = CopyDirStart(loop, r, &syscall);
+  if (err < 0) CopyDirFinish(loop, r, err, syscall);
+}
+
+// Starts copying the entry of `r`. Returns a negative error code, and the
+// operation that failed in `syscall`, if no request could be started.
+static int CopyDirStart(uv_loop_t* loop,
+                        CopyDirRequest* r,
+                        const char** syscall) {
+  const char* src = r->entry.src.c_str();
+  const char* dest = r->entry.dest.c_str();
+  switch (r->entry.type) {
+    case UV_DIRENT_DIR:
+      *syscall = "mkdir";
+      return uv_fs_mkdir(loop, &r->req, dest, 0777, CopyDirAfterMkdir);
+    case UV_DIRENT_FILE:
+      *syscall = "copyfile";
+      return uv_fs_copyfile(loop, &r->req, src, dest, r->data->flags,
+                            uv_fs_callback_t{[](uv_fs_t* req) {
+        CopyDirAfterStep(req, "copyfile");
+      }});
+    case UV_DIRENT_LINK:
+      *syscall = "readlink";
+      return uv_fs_readlink(loop, &r->req, src, CopyDirAfterReadLink);
+    case UV_DIRENT_UNKNOWN:
+      // Not every file system reports the entry type from scandir.
+      *syscall = "lstat";
+      return uv_fs_lstat(loop, &r->req, src, CopyDirAfterLStat);
+    default:
+      // FIFOs, sockets and devices cannot be copied by reading them.
+      *syscall = "copydir";
+      return UV_ENOTSUP;
+  }
+}
+
+static void CopyDirPump(uv_loop_t* loop, CopyDirData* data) {
+  while (data->error == 0 &&
+         data->in_flight < CopyDirData::kMaxRequests &&
+         !data->pending.empty()) {
+    CopyDirRequest* r = new CopyDirRequest();
+    r->data = data;
+    r->entry = std::move(data->pending.back());
+    data->pending.pop_back();
+    data->in_flight++;
+
+    const char* syscall;
+    int err = CopyDirStart(loop, r, &syscall);
+    if (err < 0) {
+      data->Fail(err, syscall, r->entry.src,
+                 r->entry.type == UV_DIRENT_DIR ? "" : r->entry.dest);
+      uv_fs_req_cleanup(&r->req);
+      delete r;
+      data->in_flight--;
+    }
+  }
+
+  if (data->in_flight == 0 && (data->error != 0 || data->pending.empty()))
+    data->Done();
+}
+
+int CopyDirAsync(uv_loop_t* loop,
+                 uv_fs_t* req,
+                 const char* src,
+                 const char* dest,
+                 int flags,
+                 uv_fs_cb cb) {
+  FSReqBase* req_wrap = FSReqBase::from_req(req);
+  req_wrap->copy_dir_data = std::make_unique<CopyDirData>(req, flags, cb);
+  req_wrap->copy_dir_data->pending.push_back({ UV_DIRENT_DIR, src, dest });
+
+  // The request of the caller only checks that the source is a directory,
+  // and that the destination is not inside of it, so that those errors are
+  // reported asynchronously too; the copy itself runs on requests owned by
+  // the CopyDirData.
+  int err = uv_fs_stat(loop, req, src, uv_fs_callback_t{[](uv_fs_t* req) {
+    FSReqBase* req_wrap = FSReqBase::from_req(req);
+    CopyDirData* data = req_wrap->copy_dir_data.get();
+    const CopyDirData::Entry& root = data->pending.back();
+    if (req->result < 0) {
+      data->Fail(req->result, "stat", root.src);
+    } else if (!S_ISDIR(req->statbuf.st_mode)) {
+      data->Fail(UV_ENOTDIR, "copydir", root.src);
+    } else if (CopyDirIsInside(root.src, root.dest)) {
+      data->Fail(UV_EINVAL, "copydir", root.src, root.dest);
+    }
+    uv_fs_req_cleanup(req);
+    CopyDirPump(req_wrap->env()->event_loop(), data);
+  }});
+  if (err < 0) req_wrap->copy_dir_data->Fail(err, "stat", src);
+  return err;
+}
+
+int CopyDirSync(uv_loop_t* loop, CopyDirData* data) {
+  uv_fs_t req;
+  const char* syscall = nullptr;
+  int err = 0;
+
+  while (err == 0 && !data->pending.empty()) {
+    CopyDirData::Entry entry = std::move(data->pending.back());
+    data->pending.pop_back();
+    const char* src = entry.src.c_str();
+    const char* dest = entry.dest.c_str();
+
+    if (entry.type == UV_DIRENT_UNKNOWN) {
+      syscall = "lstat";
+      err = uv_fs_lstat(loop, &req, src, nullptr);
+      if (err == 0) entry.type = DirentTypeFromMode(req.statbuf.st_mode);
+      uv_fs_req_cleanup(&req);
+      if (err < 0) break;
+    }
+
+    switch (entry.type) {
+      case UV_DIRENT_DIR: {
+        syscall = "mkdir";
+        err = uv_fs_mkdir(loop, &req, dest, 0777, nullptr);
+        uv_fs_req_cleanup(&req);
+        if (err < 0 && err != UV_EEXIST) break;
+        syscall = "scandir";
+        err = uv_fs_scandir(loop, &req, src, 0, nullptr);
+        if (err >= 0) {
+          uv_dirent_t ent;
+          while ((err = uv_fs_scandir_next(&req, &ent)) == 0) {
+            data->pending.push_back({ ent.type,
+                                      CopyDirJoin(entry.src, ent.name),
+                                      CopyDirJoin(entry.dest, ent.name) });
+          }
+          if (err == UV_EOF) err = 0;
+        }
+        uv_fs_req_cleanup(&req);
+        break;
+      }
+      case UV_DIRENT_FILE:
+        syscall = "copyfile";
+        err = uv_fs_copyfile(loop, &req, src, dest, data->flags, nullptr);
+        uv_fs_req_cleanup(&req);
+        break;
+      case UV_DIRENT_LINK: {
+        syscall = "readlink";
+        err = uv_fs_readlink(loop, &req, src, nullptr);
+        if (err < 0) {
+          uv_fs_req_cleanup(&req);
+          break;
+        }
+        std::string target(static_cast<const char*>(req.ptr));
+        uv_fs_req_cleanup(&req);
+        syscall = "symlink";
+        err = uv_fs_symlink(loop, &req, target.c_str(), dest, 0, nullptr);
+        uv_fs_req_cleanup(&req);
+        break;
+      }
+      default:
+        syscall = "copydir";
+        err = UV_ENOTSUP;
+        break;
+    }
+
+    if (err < 0) {
+      data->Fail(err, syscall, entry.src,
+                 entry.type == UV_DIRENT_DIR ? "" : entry.dest);
+    }
+  }
+
+  return err;
+}
+
+void AfterCopyDir(uv_fs_t* req) {
+  FSReqBase* req_wrap = FSReqBase::from_req(req);
+  FSReqAfterScope after(req_wrap, req);
+  Isolate* isolate = req_wrap->env()->isolate();
+
+  if (req->result < 0) {
+    CopyDirData* data = req_wrap->copy_dir_data.get();
+    const char* dest =
+        data->error_dest.empty() ? nullptr : data->error_dest.c_str();
+    req_wrap->Reject(UVException(isolate,
+                                 req->result,
+                                 data->error_syscall,
+                                 nullptr,
+                                 data->error_path.c_str(),
+                                 dest));
+    return;
+  }
+
+  req_wrap->Resolve(Undefined(isolate));
+}
+
+static void CopyDir(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 3);
+
+  BufferValue src(isolate, args[0]);
+  CHECK_NOT_NULL(*src);
+
+  BufferValue dest(isolate, args[1]);
+  CHECK_NOT_NULL(*dest);
+
+  CHECK(args[2]->IsInt32());
+  const int flags = args[2].As<Int32>()->Value();
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[3]);
+  if (req_wrap_async != nullptr) {  // copyDir(src, dest, flags, req)
+    AsyncCall(env, req_wrap_async, args, "copydir", UTF8, AfterCopyDir,
+              CopyDirAsync, *src, *dest, flags);
+  } else {  // copyDir(src, dest, flags, undefined, ctx)
+    CHECK_EQ(argc, 5);
+    env->PrintSyncTrace();
+    CopyDirData data(nullptr, flags, nullptr);
+    data.pending.push_back({ UV_DIRENT_DIR, *src, *dest });
+    FS_SYNC_TRACE_BEGIN(copydir);
+    uv_fs_t req;
+    int err = uv_fs_stat(env->event_loop(), &req, *src, nullptr);
+    if (err == 0 && !S_ISDIR(req.statbuf.st_mode)) err = UV_ENOTDIR;
+    if (err < 0)
+      data.Fail(err, err == UV_ENOTDIR ? "copydir" : "stat", *src);
+    uv_fs_req_cleanup(&req);
+    if (err == 0 && CopyDirIsInside(*src, *dest)) {
+      err = UV_EINVAL;
+      data.Fail(err, "copydir", *src, *dest);
+    }
+    if (err == 0)
+      err = CopyDirSync(env->event_loop(), &data);
+    FS_SYNC_TRACE_END(copydir);
+
+    if (err < 0) {
+      Local<Context> context = env->context();
+      Local<Object> ctx_obj = args[4].As<Object>();
+      Local<Value> dest_value = Undefined(isolate);
+      if (!data.error_dest.empty()) {
+        dest_value = String::NewFromUtf8(isolate, data.error_dest.c_str(),
+                                         v8::NewStringType::kNormal)
+                         .ToLocalChecked();
+      }
+      ctx_obj->Set(context,
+                   env->errno_string(),
+                   Integer::New(isolate, err)).FromJust();
+      ctx_obj->Set(context,
+                   env->syscall_string(),
+                   OneByteString(isolate, data.error_syscall)).FromJust();
+      ctx_obj->Set(context,
+                   env->path_string(),
+                   String::NewFromUtf8(isolate, data.error_path.c_str(),
+                                       v8::NewStringType::kNormal)
+                       .ToLocalChecked()).FromJust();
+      ctx_obj->Set(context, env->dest_string(), dest_value).FromJust();
+    }
+  }
+}
+
 
 // Wrapper for write(2).
 //
@@ -2150,6 +2609,15 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "mkdir", MKDir);
   env->SetMethod(target, "readdir", ReadDir);
   env->SetMethod(target, "internalModuleReadJSON", InternalModuleReadJSON);
+  env->SetMethod(target,
+                 "internalModuleReadPackageJSON",
+                 InternalModuleReadPackageJSON);
+  env->SetMethod(target,
+                 "internalModuleResolutionCacheLookup",
+                 InternalModuleResolutionCacheLookup);
+  env->SetMethod(target,
+                 "internalModuleResolutionCacheRecord",
+                 InternalModuleResolutionCacheRecord);
   env->SetMethod(target, "internalModuleStat", InternalModuleStat);
   env->SetMethod(target, "stat", Stat);
   env->SetMethod(target, "lstat", LStat);
@@ -2163,6 +2631,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "writeString", WriteString);
   env->SetMethod(target, "realpath", RealPath);
   env->SetMethod(target, "copyFile", CopyFile);
+  env->SetMethod(target, "copyDir", CopyDir);
 
   env->SetMethod(target, "chmod", Chmod);
   env->SetMethod(target, "fchmod", FChmod);
@@ -2191,6 +2660,7 @@ void Initialize(Local<Object> target,
               env->fs_stats_field_bigint_array()->GetJSArray()).FromJust();
 
   StatWatcher::Initialize(env, target);
+  DirWalker::Initialize(env, target);
 
   // Create FunctionTemplate for FSReqCallback
   Local<FunctionTemplate> fst = env->NewFunctionTemplate(NewFSReqCallback);
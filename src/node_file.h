@@ -21,6 +21,28 @@ using v8::Value;
 
 namespace fs {
 
+// The dirent type of an lstat() result, for when scandir doesn't know it.
+inline uv_dirent_type_t DirentTypeFromMode(uint64_t mode) {
+  switch (mode & S_IFMT) {
+    case S_IFDIR: return UV_DIRENT_DIR;
+    case S_IFREG: return UV_DIRENT_FILE;
+#ifdef S_IFLNK
+    case S_IFLNK: return UV_DIRENT_LINK;
+#endif
+#ifdef S_IFIFO
+    case S_IFIFO: return UV_DIRENT_FIFO;
+#endif
+#ifdef S_IFSOCK
+    case S_IFSOCK: return UV_DIRENT_SOCKET;
+#endif
+    case S_IFCHR: return UV_DIRENT_CHAR;
+#ifdef S_IFBLK
+    case S_IFBLK: return UV_DIRENT_BLOCK;
+#endif
+    default: return UV_DIRENT_UNKNOWN;
+  }
+}
+
 // structure used to store state during a complex operation, e.g., mkdirp.
 class FSContinuationData : public MemoryRetainer {
  public:
@@ -63,10 +85,64 @@ class FSContinuationData : public MemoryRetainer {
   uv_fs_cb done_cb;
 };
 
+// state of a recursive directory copy. Entries that still need to be copied
+// are kept in a work list that up to kMaxRequests libuv requests take from
+// concurrently; JS is only called back once the whole tree has been copied.
+class CopyDirData : public MemoryRetainer {
+ public:
+  static constexpr size_t kMaxRequests = 16;
+
+  struct Entry {
+    uv_dirent_type_t type;
+    std::string src;
+    std::string dest;
+  };
+
+  CopyDirData(uv_fs_t* req, int flags, uv_fs_cb done_cb)
+      : req(req), flags(flags), done_cb(done_cb) {
+  }
+
+  uv_fs_t* req;
+  int flags;
+  std::vector<Entry> pending{};
+  size_t in_flight = 0;
+
+  // the first error that occurred, and the operation that caused it.
+  int error = 0;
+  const char* error_syscall = nullptr;
+  std::string error_path{};
+  std::string error_dest{};
+
+  void Fail(int err, const char* syscall, const std::string& path,
+            const std::string& dest = std::string()) {
+    if (error != 0) return;
+    error = err;
+    error_syscall = syscall;
+    error_path = path;
+    error_dest = dest;
+  }
+
+  void Done() {
+    req->result = error;
+    done_cb(req);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("pending", pending.size() * sizeof(Entry));
+  }
+
+  SET_MEMORY_INFO_NAME(CopyDirData)
+  SET_SELF_SIZE(CopyDirData)
+
+ private:
+  uv_fs_cb done_cb;
+};
+
 class FSReqBase : public ReqWrap<uv_fs_t> {
  public:
   typedef MaybeStackBuffer<char, 64> FSReqBuffer;
   std::unique_ptr<FSContinuationData> continuation_data = nullptr;
+  std::unique_ptr<CopyDirData> copy_dir_data = nullptr;
 
   FSReqBase(Environment* env, Local<Object> req, AsyncWrap::ProviderType type,
             bool use_bigint)
@@ -140,6 +216,7 @@ class FSReqCallback : public FSReqBase {
 
   void MemoryInfo(MemoryTracker* tracker) const override {
     tracker->TrackField("continuation_data", continuation_data);
+    tracker->TrackField("copy_dir_data", copy_dir_data);
   }
 
   SET_MEMORY_INFO_NAME(FSReqCallback)
@@ -191,24 +268,34 @@ constexpr uint64_t ToNative(uv_timespec_t ts) {
 
 #undef constexpr  // end N3652 bug workaround
 
-template <typename NativeT, typename V8T>
-constexpr void FillStatsArray(AliasedBuffer<NativeT, V8T>* fields,
-                              const uv_stat_t* s, const size_t offset = 0) {
-  fields->SetValue(offset + 0, static_cast<NativeT>(s->st_dev));
-  fields->SetValue(offset + 1, static_cast<NativeT>(s->st_mode));
-  fields->SetValue(offset + 2, static_cast<NativeT>(s->st_nlink));
-  fields->SetValue(offset + 3, static_cast<NativeT>(s->st_uid));
-  fields->SetValue(offset + 4, static_cast<NativeT>(s->st_gid));
-  fields->SetValue(offset + 5, static_cast<NativeT>(s->st_rdev));
-  fields->SetValue(offset + 6, static_cast<NativeT>(s->st_blksize));
-  fields->SetValue(offset + 7, static_cast<NativeT>(s->st_ino));
-  fields->SetValue(offset + 8, static_cast<NativeT>(s->st_size));
-  fields->SetValue(offset + 9, static_cast<NativeT>(s->st_blocks));
+// Writes the kFsStatsFieldsNumber fields of `s` in the order that
+// getStatsFromBinding() reads them.
+template <typename NativeT>
+inline void FillStatsFields(NativeT* fields, const uv_stat_t* s) {
+  fields[0] = static_cast<NativeT>(s->st_dev);
+  fields[1] = static_cast<NativeT>(s->st_mode);
+  fields[2] = static_cast<NativeT>(s->st_nlink);
+  fields[3] = static_cast<NativeT>(s->st_uid);
+  fields[4] = static_cast<NativeT>(s->st_gid);
+  fields[5] = static_cast<NativeT>(s->st_rdev);
+  fields[6] = static_cast<NativeT>(s->st_blksize);
+  fields[7] = static_cast<NativeT>(s->st_ino);
+  fields[8] = static_cast<NativeT>(s->st_size);
+  fields[9] = static_cast<NativeT>(s->st_blocks);
 // Dates.
-  fields->SetValue(offset + 10, ToNative<NativeT>(s->st_atim));
-  fields->SetValue(offset + 11, ToNative<NativeT>(s->st_mtim));
-  fields->SetValue(offset + 12, ToNative<NativeT>(s->st_ctim));
-  fields->SetValue(offset + 13, ToNative<NativeT>(s->st_birthtim));
+  fields[10] = ToNative<NativeT>(s->st_atim);
+  fields[11] = ToNative<NativeT>(s->st_mtim);
+  fields[12] = ToNative<NativeT>(s->st_ctim);
+  fields[13] = ToNative<NativeT>(s->st_birthtim);
+}
+
+template <typename NativeT, typename V8T>
+inline void FillStatsArray(AliasedBuffer<NativeT, V8T>* fields,
+                           const uv_stat_t* s, const size_t offset = 0) {
+  NativeT values[kFsStatsFieldsNumber];
+  FillStatsFields(values, s);
+  for (size_t i = 0; i < kFsStatsFieldsNumber; i++)
+    fields->SetValue(offset + i, values[i]);
 }
 
 inline Local<Value> FillGlobalStatsArray(Environment* env,
@@ -288,6 +375,7 @@ class FSReqPromise : public FSReqBase {
   void MemoryInfo(MemoryTracker* tracker) const override {
     tracker->TrackField("stats_field_array", stats_field_array_);
     tracker->TrackField("continuation_data", continuation_data);
+    tracker->TrackField("copy_dir_data", copy_dir_data);
   }
 
   SET_MEMORY_INFO_NAME(FSReqPromise)
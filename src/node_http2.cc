@@ -197,6 +197,13 @@ Http2Options::Http2Options(Environment* env, nghttp2_session_type type) {
   if (flags & (1 << IDX_OPTIONS_MAX_SESSION_MEMORY)) {
     SetMaxSessionMemory(buffer[IDX_OPTIONS_MAX_SESSION_MEMORY] * 1e6);
   }
+
+  // Small DATA frame payloads are copied rather than written to the socket
+  // as separate buffers, see Http2Session::OnSendData().
+  if (flags & (1 << IDX_OPTIONS_WRITE_COALESCING_THRESHOLD)) {
+    SetWriteCoalescingThreshold(
+        buffer[IDX_OPTIONS_WRITE_COALESCING_THRESHOLD]);
+  }
 }
 
 void Http2Session::Http2Settings::Init() {
@@ -586,6 +593,30 @@ void Http2Session::StopTrackingRcbuf(nghttp2_rcbuf* buf) {
   MemoryAllocatorInfo::StopTracking(this, buf);
 }
 
+MaybeLocal<String> Http2Session::GetCachedHeaderString(nghttp2_rcbuf* buf) {
+  auto it = header_string_cache_.find(buf);
+  if (it == header_string_cache_.end())
+    return MaybeLocal<String>();
+  return Local<String>::New(env()->isolate(), it->second);
+}
+
+void Http2Session::CacheHeaderString(nghttp2_rcbuf* buf, Local<String> str) {
+  if (nghttp2_rcbuf_get_buf(buf).len > kMaxCachedHeaderLength)
+    return;
+  // Entries are not evicted individually, there is no way to tell which
+  // of them are still in the dynamic table. Hot ones come back quickly.
+  if (header_string_cache_.size() >= kMaxHeaderStringCacheSize)
+    ClearHeaderStringCache();
+  nghttp2_rcbuf_incref(buf);
+  header_string_cache_.emplace(buf, v8::Global<String>(env()->isolate(), str));
+}
+
+void Http2Session::ClearHeaderStringCache() {
+  for (const auto& entry : header_string_cache_)
+    nghttp2_rcbuf_decref(entry.first);
+  header_string_cache_.clear();
+}
+
 Http2Session::Http2Session(Environment* env,
                            Local<Object> wrap,
                            nghttp2_session_type type)
@@ -610,6 +641,8 @@ Http2Session::Http2Session(Environment* env,
 
   padding_strategy_ = opts.GetPaddingStrategy();
 
+  write_coalescing_threshold_ = opts.GetWriteCoalescingThreshold();
+
   bool hasGetPaddingCallback =
       padding_strategy_ != PADDING_STRATEGY_NONE;
 
@@ -638,6 +671,7 @@ Http2Session::~Http2Session() {
   Debug(this, "freeing nghttp2 session");
   for (const auto& iter : streams_)
     iter.second->session_ = nullptr;
+  ClearHeaderStringCache();
   nghttp2_session_del(session_);
   CHECK_EQ(current_nghttp2_memory_, 0);
 }
@@ -718,6 +752,9 @@ void Http2Session::EmitStatistics() {
     buffer[IDX_SESSION_STATS_DATA_RECEIVED] = entry->data_received();
     buffer[IDX_SESSION_STATS_MAX_CONCURRENT_STREAMS] =
         entry->max_concurrent_streams();
+    buffer[IDX_SESSION_STATS_WRITE_COUNT] = entry->write_count();
+    buffer[IDX_SESSION_STATS_WRITE_BUFFER_COUNT] =
+        entry->write_buffer_count();
     Local<Object> obj;
     if (entry->ToObject().ToLocal(&obj)) entry->Notify(obj);
   }, static_cast<void*>(entry));
@@ -730,6 +767,7 @@ void Http2Session::Close(uint32_t code, bool socket_closed) {
   if (flags_ & SESSION_STATE_CLOSING)
     return;
   flags_ |= SESSION_STATE_CLOSING;
+  flags_ &= ~SESSION_STATE_CORKED;
 
   // Stop reading on the i/o stream
   if (stream_ != nullptr)
@@ -1159,10 +1197,12 @@ int Http2Session::OnDataChunkReceived(nghttp2_session* handle,
     // Since it has access to the original socket buffer from which the data
     // was read in the first place, it can use that to minimize ArrayBuffer
     // allocations.
-    if (LIKELY(buf.base == nullptr))
+    if (LIKELY(buf.base == nullptr)) {
       buf.base = reinterpret_cast<char*>(const_cast<uint8_t*>(data));
-    else
+    } else {
       memcpy(buf.base, data, avail);
+      stream->bytes_copied_ += avail;
+    }
     data += avail;
     len -= avail;
     stream->EmitRead(avail, buf);
@@ -1521,6 +1561,10 @@ void Http2Session::MaybeScheduleWrite() {
   if (UNLIKELY(session_ == nullptr))
     return;
 
+  // Uncorking the session sends the data.
+  if (flags_ & SESSION_STATE_CORKED)
+    return;
+
   if (nghttp2_session_want_write(session_)) {
     HandleScope handle_scope(env()->isolate());
     Debug(this, "scheduling write");
@@ -1611,7 +1655,8 @@ void Http2Session::CopyDataIntoOutgoing(const uint8_t* src, size_t src_length) {
 // chunk out to the i/o socket to be sent. This is a particularly hot method
 // that will generally be called at least twice be event loop iteration.
 // This is a potential performance optimization target later.
-// Returns non-zero value if a write is already in progress.
+// Returns non-zero value if a write is already in progress, or the session is
+// corked.
 uint8_t Http2Session::SendPendingData() {
   Debug(this, "sending pending data");
   // Do not attempt to send data on the socket if the destroying flag has
@@ -1621,6 +1666,10 @@ uint8_t Http2Session::SendPendingData() {
     return 0;
   flags_ &= ~SESSION_STATE_WRITE_SCHEDULED;
 
+  // Everything is held back until Uncork() sends it.
+  if (flags_ & SESSION_STATE_CORKED)
+    return 1;
+
   // SendPendingData should not be called recursively.
   if (flags_ & SESSION_STATE_SENDING)
     return 1;
@@ -1663,21 +1712,29 @@ uint8_t Http2Session::SendPendingData() {
   // Set the buffer base pointers for copied data that ended up in the
   // sessions's own storage since it might have shifted around during gathering.
   // (Those are marked by having .base == nullptr.)
+  // Data that was copied into the storage one after another is contiguous,
+  // and is written as a single buffer.
   size_t offset = 0;
   size_t i = 0;
   for (const nghttp2_stream_write& write : outgoing_buffers_) {
     statistics_.data_sent += write.buf.len;
     if (write.buf.base == nullptr) {
-      bufs[i++] = uv_buf_init(
-          reinterpret_cast<char*>(outgoing_storage_.data() + offset),
-          write.buf.len);
+      char* base = reinterpret_cast<char*>(outgoing_storage_.data() + offset);
       offset += write.buf.len;
+      if (i > 0 && bufs[i - 1].base + bufs[i - 1].len == base) {
+        bufs[i - 1].len += write.buf.len;
+        continue;
+      }
+      bufs[i++] = uv_buf_init(base, write.buf.len);
     } else {
       bufs[i++] = write.buf;
     }
   }
+  count = i;
 
   chunks_sent_since_last_write_++;
+  statistics_.write_count++;
+  statistics_.write_buffer_count += count;
 
   StreamWriteResult res = underlying_stream()->Write(*bufs, count);
   if (!res.async) {
@@ -1722,15 +1779,29 @@ int Http2Session::OnSendData(
     if (write.buf.len <= length) {
       // This write does not suffice by itself, so we can consume it completely.
       length -= write.buf.len;
-      session->outgoing_buffers_.emplace_back(std::move(write));
+      if (write.buf.len < session->write_coalescing_threshold_) {
+        // The copy takes over the WriteWrap, so that it is still only done
+        // once the data has been written to the socket.
+        session->CopyDataIntoOutgoing(
+            reinterpret_cast<const uint8_t*>(write.buf.base), write.buf.len);
+        session->outgoing_buffers_.back().req_wrap = write.req_wrap;
+      } else {
+        session->outgoing_buffers_.emplace_back(std::move(write));
+      }
       stream->queue_.pop();
       continue;
     }
 
     // Slice off `length` bytes of the first write in the queue.
-    session->outgoing_buffers_.emplace_back(nghttp2_stream_write {
-      uv_buf_init(write.buf.base, length)
-    });
+    if (length < session->write_coalescing_threshold_) {
+      session->CopyDataIntoOutgoing(
+          reinterpret_cast<const uint8_t*>(write.buf.base), length);
+    } else {
+      session->outgoing_buffers_.emplace_back(nghttp2_stream_write {
+        write.storage,
+        uv_buf_init(write.buf.base, length)
+      });
+    }
     write.buf.base += length;
     write.buf.len -= length;
     break;
@@ -1903,6 +1974,9 @@ Http2Stream::~Http2Stream() {
     nghttp2_rcbuf_decref(header.value);
   }
 
+  if (file_reader_)
+    file_reader_->Detach();
+
   if (session_ == nullptr)
     return;
   Debug(this, "tearing down stream");
@@ -1964,6 +2038,11 @@ void Http2Stream::Destroy() {
 
   Debug(this, "destroying stream");
 
+  if (file_reader_) {
+    file_reader_->Detach();
+    file_reader_.reset();
+  }
+
   // Wait until the start of the next loop to delete because there
   // may still be some pending operations queued for this stream.
   env()->SetImmediate([](Environment* env, void* data) {
@@ -2180,6 +2259,15 @@ int Http2Stream::DoWrite(WriteWrap* req_wrap,
   return 0;
 }
 
+void Http2Stream::QueueData(std::shared_ptr<char> storage, uv_buf_t buf) {
+  CHECK(!IsDestroyed());
+  Http2Scope h2scope(this);
+  Debug(this, "queuing %d bytes to send", buf.len);
+  queue_.emplace(nghttp2_stream_write { std::move(storage), buf });
+  IncrementAvailableOutboundLength(buf.len);
+  CHECK_NE(nghttp2_session_resume_data(**session_, id_), NGHTTP2_ERR_NOMEM);
+}
+
 // Ads a header to the Http2Stream. Note that the header name and value are
 // provided using a buffer structure provided by nghttp2 that allows us to
 // avoid unnecessary memcpy's. Those buffers are ref counted. The ref count
@@ -2302,6 +2390,135 @@ ssize_t Http2Stream::Provider::Stream::OnRead(nghttp2_session* handle,
   return amount;
 }
 
+Http2FileReader::Http2FileReader(Environment* env,
+                                 Http2Stream* stream,
+                                 uv_file fd,
+                                 int64_t offset,
+                                 int64_t length,
+                                 bool owns_fd)
+    : ThreadPoolWork(env, UV_WORK_FAST_IO),
+      stream_(stream),
+      fd_(fd),
+      offset_(offset < 0 ? -1 : offset),
+      remaining_(length < 0 ? -1 : length),
+      owns_fd_(owns_fd) {}
+
+void Http2FileReader::Start() {
+  if (remaining_ == 0) {
+    stream_->DoShutdown(nullptr);
+    Stop();
+    return;
+  }
+  ReadMore();
+}
+
+void Http2FileReader::Detach() {
+  stream_ = nullptr;
+  Stop();
+}
+
+// Starts reading the next chunk, unless a read is already running or all
+// buffers are still queued for the stream.
+void Http2FileReader::ReadMore() {
+  if (busy_ || stopped_)
+    return;
+  if (free_buffers_.empty()) {
+    if (buffers_.size() == kBufferCount)
+      return;
+    buffers_.emplace_back(new char[kBufferSize]);
+    free_buffers_.push_back(buffers_.back().get());
+  }
+  current_ = free_buffers_.back();
+  free_buffers_.pop_back();
+  busy_ = true;
+  self_ = shared_from_this();
+  ScheduleWork();
+}
+
+// Called once nghttp2 is done with a chunk, or the chunk was discarded.
+void Http2FileReader::Release(char* data) {
+  free_buffers_.push_back(data);
+  ReadMore();
+}
+
+void Http2FileReader::Stop() {
+  stopped_ = true;
+  if (!owns_fd_ || busy_ || closing_)
+    return;
+  // The fd is closed once the current read is done otherwise.
+  closing_ = true;
+  busy_ = true;
+  self_ = shared_from_this();
+  ScheduleWork();
+}
+
+void Http2FileReader::DoThreadPoolWork() {
+  uv_fs_t req;
+  if (closing_) {
+    uv_fs_close(nullptr, &req, fd_, nullptr);
+  } else {
+    size_t size = kBufferSize;
+    if (remaining_ >= 0 && static_cast<uint64_t>(remaining_) < size)
+      size = remaining_;
+    uv_buf_t buf = uv_buf_init(current_, size);
+    result_ = uv_fs_read(nullptr, &req, fd_, &buf, 1, offset_, nullptr);
+  }
+  uv_fs_req_cleanup(&req);
+}
+
+void Http2FileReader::AfterThreadPoolWork(int status) {
+  std::shared_ptr<Http2FileReader> self = std::move(self_);
+  busy_ = false;
+  if (closing_)
+    return;
+
+  char* data = current_;
+  current_ = nullptr;
+  if (stopped_) {
+    // The stream has been destroyed while reading.
+    free_buffers_.push_back(data);
+    Stop();
+    return;
+  }
+
+  HandleScope handle_scope(stream_->env()->isolate());
+  ssize_t nread = status == 0 ? result_ : status;
+  if (nread <= 0) {
+    free_buffers_.push_back(data);
+    if (nread < 0) {
+      Debug(stream_, "reading from fd %d failed: %d", fd_, nread);
+      stream_->SubmitRstStream(NGHTTP2_INTERNAL_ERROR);
+    } else {
+      stream_->DoShutdown(nullptr);
+    }
+    Stop();
+    return;
+  }
+
+  if (offset_ >= 0)
+    offset_ += nread;
+  if (remaining_ > 0)
+    remaining_ -= nread;
+  // Once all requested data has been read, queuing the last chunk must not
+  // start another read.
+  bool eof = remaining_ == 0;
+  if (eof)
+    stopped_ = true;
+
+  std::shared_ptr<char> storage(data, [self](char* data) {
+    self->Release(data);
+  });
+  stream_->QueueData(std::move(storage), uv_buf_init(data, nread));
+
+  if (eof) {
+    if (stream_ != nullptr)
+      stream_->DoShutdown(nullptr);
+    Stop();
+  } else {
+    ReadMore();
+  }
+}
+
 inline void Http2Stream::IncrementAvailableOutboundLength(size_t amount) {
   available_outbound_length_ += amount;
   session_->IncrementCurrentSessionMemory(amount);
@@ -2535,6 +2752,24 @@ void Http2Session::UpdateChunksSent(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(length);
 }
 
+// Holds back writes to the underlying stream until the session is uncorked,
+// so that frames of several streams can be written together.
+void Http2Session::Cork(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  Debug(session, "corking session");
+  session->flags_ |= SESSION_STATE_CORKED;
+}
+
+void Http2Session::Uncork(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  Debug(session, "uncorking session");
+  session->flags_ &= ~SESSION_STATE_CORKED;
+  // Sends everything that was held back.
+  session->SendPendingData();
+}
+
 // Submits an RST_STREAM frame effectively closing the Http2Stream. Note that
 // this *WILL* alter the state of the stream, causing the OnStreamClose
 // callback to the triggered.
@@ -2548,6 +2783,33 @@ void Http2Stream::RstStream(const FunctionCallbackInfo<Value>& args) {
   stream->SubmitRstStream(code);
 }
 
+// Sends the contents of a file descriptor as the remaining outbound DATA
+// frames of the Http2Stream, see Http2FileReader. Unless `ownsFd` is true,
+// the file descriptor is left open.
+void Http2Stream::SendFileData(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<Context> context = env->context();
+  Http2Stream* stream;
+  ASSIGN_OR_RETURN_UNWRAP(&stream, args.Holder());
+  CHECK(args[0]->IsInt32());
+  CHECK_NULL(stream->file_reader_);
+
+  uv_file fd = args[0]->Int32Value(context).FromJust();
+  int64_t offset = args[1]->IntegerValue(context).FromJust();
+  int64_t length = args[2]->IntegerValue(context).FromJust();
+  bool owns_fd = args[3]->IsTrue();
+
+  auto reader = std::make_shared<Http2FileReader>(
+      env, stream, fd, offset, length, owns_fd);
+  if (stream->IsDestroyed()) {
+    reader->Detach();
+    return;
+  }
+  Debug(stream, "sending data from fd %d", fd);
+  stream->file_reader_ = reader;
+  reader->Start();
+}
+
 // Initiates a response on the Http2Stream using the StreamBase API to provide
 // outbound DATA frames.
 void Http2Stream::Respond(const FunctionCallbackInfo<Value>& args) {
@@ -3007,6 +3269,7 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(stream, "trailers", Http2Stream::Trailers);
   env->SetProtoMethod(stream, "respond", Http2Stream::Respond);
   env->SetProtoMethod(stream, "rstStream", Http2Stream::RstStream);
+  env->SetProtoMethod(stream, "sendFileData", Http2Stream::SendFileData);
   env->SetProtoMethod(stream, "refreshState", Http2Stream::RefreshState);
   stream->Inherit(AsyncWrap::GetConstructorTemplate(env));
   StreamBase::AddMethods(env, stream);
@@ -3025,6 +3288,8 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(session, "origin", Http2Session::Origin);
   env->SetProtoMethod(session, "altsvc", Http2Session::AltSvc);
   env->SetProtoMethod(session, "ping", Http2Session::Ping);
+  env->SetProtoMethod(session, "cork", Http2Session::Cork);
+  env->SetProtoMethod(session, "uncork", Http2Session::Uncork);
   env->SetProtoMethod(session, "consume", Http2Session::Consume);
   env->SetProtoMethod(session, "destroy", Http2Session::Destroy);
   env->SetProtoMethod(session, "goaway", Http2Session::Goaway);
@@ -13,6 +13,7 @@
 #include "string_bytes.h"
 
 #include <algorithm>
+#include <memory>
 #include <queue>
 
 namespace node {
@@ -83,10 +84,15 @@ enum nghttp2_stream_options {
 struct nghttp2_stream_write : public MemoryRetainer {
   WriteWrap* req_wrap = nullptr;
   uv_buf_t buf;
+  // Keeps the memory of writes without a WriteWrap alive until all slices
+  // of them have been written.
+  std::shared_ptr<char> storage;
 
   inline explicit nghttp2_stream_write(uv_buf_t buf_) : buf(buf_) {}
   inline nghttp2_stream_write(WriteWrap* req, uv_buf_t buf_) :
       req_wrap(req), buf(buf_) {}
+  inline nghttp2_stream_write(std::shared_ptr<char> storage_, uv_buf_t buf_) :
+      buf(buf_), storage(std::move(storage_)) {}
 
   void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(nghttp2_stream_write)
@@ -335,11 +341,13 @@ enum session_state_flags {
   SESSION_STATE_CLOSED = 0x4,
   SESSION_STATE_CLOSING = 0x8,
   SESSION_STATE_SENDING = 0x10,
+  SESSION_STATE_CORKED = 0x20,
 };
 
 typedef uint32_t(*get_setting)(nghttp2_session* session,
                                nghttp2_settings_id id);
 
+class Http2FileReader;
 class Http2Session;
 class Http2Stream;
 
@@ -413,9 +421,18 @@ class Http2Options {
     return max_session_memory_;
   }
 
+  void SetWriteCoalescingThreshold(size_t threshold) {
+    write_coalescing_threshold_ = threshold;
+  }
+
+  size_t GetWriteCoalescingThreshold() const {
+    return write_coalescing_threshold_;
+  }
+
  private:
   nghttp2_option* options_;
   uint64_t max_session_memory_ = DEFAULT_MAX_SESSION_MEMORY;
+  size_t write_coalescing_threshold_ = 0;
   uint32_t max_header_pairs_ = DEFAULT_MAX_HEADER_LIST_PAIRS;
   padding_strategy_type padding_strategy_ = PADDING_STRATEGY_NONE;
   size_t max_outstanding_pings_ = DEFAULT_MAX_PINGS;
@@ -498,6 +515,9 @@ class Http2Stream : public AsyncWrap,
 
   void Close(int32_t code);
 
+  // Queues data that is not owned by a WriteWrap for sending.
+  void QueueData(std::shared_ptr<char> storage, uv_buf_t buf);
+
   // Destroy this stream instance and free all held memory.
   void Destroy();
 
@@ -586,6 +606,7 @@ class Http2Stream : public AsyncWrap,
   static void Trailers(const FunctionCallbackInfo<Value>& args);
   static void Respond(const FunctionCallbackInfo<Value>& args);
   static void RstStream(const FunctionCallbackInfo<Value>& args);
+  static void SendFileData(const FunctionCallbackInfo<Value>& args);
 
   class Provider;
 
@@ -634,6 +655,9 @@ class Http2Stream : public AsyncWrap,
   std::queue<nghttp2_stream_write> queue_;
   size_t available_outbound_length_ = 0;
 
+  // Set when the outbound data comes from a file descriptor.
+  std::shared_ptr<Http2FileReader> file_reader_;
+
   Http2StreamListener stream_listener_;
 
   friend class Http2Session;
@@ -672,6 +696,61 @@ class Http2Stream::Provider::Stream : public Http2Stream::Provider {
                         void* user_data);
 };
 
+// Sends the contents of a file descriptor as the DATA frames of a stream.
+// Chunks are read on the threadpool into a small set of buffers that are
+// queued for the stream directly and reused once nghttp2 has written them
+// to the socket, so that the next chunk is read while the previous one is
+// sent and no JS objects are created per chunk.
+//
+// The reader is kept alive by the stream, by a pending read and by queued
+// chunks, whichever lasts longest.
+class Http2FileReader : public ThreadPoolWork,
+                        public std::enable_shared_from_this<Http2FileReader> {
+ public:
+  static constexpr size_t kBufferSize = 64 * 1024;
+  static constexpr size_t kBufferCount = 2;
+
+  // A negative `offset` reads from the current file position, a negative
+  // `length` reads until the end of the file.
+  Http2FileReader(Environment* env,
+                  Http2Stream* stream,
+                  uv_file fd,
+                  int64_t offset,
+                  int64_t length,
+                  bool owns_fd);
+
+  void Start();
+
+  // Called when the stream is destroyed. Any pending read is discarded.
+  void Detach();
+
+  void DoThreadPoolWork() override;
+  void AfterThreadPoolWork(int status) override;
+
+ private:
+  void ReadMore();
+  void Release(char* data);
+  void Stop();
+
+  Http2Stream* stream_;
+  uv_file fd_;
+  int64_t offset_;
+  int64_t remaining_;
+  bool owns_fd_;
+
+  bool busy_ = false;      // A read or close is running on the threadpool
+  bool stopped_ = false;   // No more reads are started
+  bool closing_ = false;   // The file descriptor is being closed
+  ssize_t result_ = 0;
+  char* current_ = nullptr;
+
+  std::vector<std::unique_ptr<char[]>> buffers_;
+  std::vector<char*> free_buffers_;
+
+  // Keeps the reader alive while it is busy.
+  std::shared_ptr<Http2FileReader> self_;
+};
+
 
 class Http2Session : public AsyncWrap, public StreamListener {
  public:
@@ -793,6 +872,8 @@ class Http2Session : public AsyncWrap, public StreamListener {
   static void UpdateChunksSent(const FunctionCallbackInfo<Value>& args);
   static void RefreshState(const FunctionCallbackInfo<Value>& args);
   static void Ping(const FunctionCallbackInfo<Value>& args);
+  static void Cork(const FunctionCallbackInfo<Value>& args);
+  static void Uncork(const FunctionCallbackInfo<Value>& args);
   static void AltSvc(const FunctionCallbackInfo<Value>& args);
   static void Origin(const FunctionCallbackInfo<Value>& args);
 
@@ -821,6 +902,12 @@ class Http2Session : public AsyncWrap, public StreamListener {
   // this session now, and may outlive it.
   void StopTrackingRcbuf(nghttp2_rcbuf* buf);
 
+  // Returns the string previously created for this header name or value, if
+  // any. See header_string_cache_.
+  MaybeLocal<String> GetCachedHeaderString(nghttp2_rcbuf* buf);
+  void CacheHeaderString(nghttp2_rcbuf* buf, Local<String> str);
+  void ClearHeaderStringCache();
+
   // Returns the current session memory including memory allocated by nghttp2,
   // the current outbound storage queue, and pending writes.
   uint64_t GetCurrentSessionMemory() {
@@ -846,6 +933,8 @@ class Http2Session : public AsyncWrap, public StreamListener {
     int32_t stream_count;
     size_t max_concurrent_streams;
     double stream_average_duration;
+    uint64_t write_count;         // Writes to the underlying stream
+    uint64_t write_buffer_count;  // Buffers passed to those writes
   };
 
   Statistics statistics_ = {};
@@ -964,6 +1053,14 @@ class Http2Session : public AsyncWrap, public StreamListener {
   // The collection of active Http2Streams associated with this session
   std::unordered_map<int32_t, Http2Stream*> streams_;
 
+  // When a peer refers to a header field in the HPACK dynamic table, nghttp2
+  // passes the rcbuf of the table entry again, so strings created for names
+  // and values are cached by rcbuf. The cache holds a reference to each rcbuf
+  // so that its address is not reused for other headers while it is cached.
+  static constexpr size_t kMaxHeaderStringCacheSize = 256;
+  static constexpr size_t kMaxCachedHeaderLength = 1024;
+  std::unordered_map<nghttp2_rcbuf*, v8::Global<String>> header_string_cache_;
+
   int flags_ = SESSION_STATE_NONE;
 
   // The StreamBase instance being used for i/o
@@ -981,6 +1078,11 @@ class Http2Session : public AsyncWrap, public StreamListener {
   size_t max_outstanding_settings_ = DEFAULT_MAX_SETTINGS;
   std::queue<Http2Settings*> outstanding_settings_;
 
+  // DATA frame payloads smaller than this are copied next to the frame
+  // headers in outgoing_storage_, so that they are written as one buffer,
+  // which a TLS socket encrypts into one record.
+  size_t write_coalescing_threshold_ = 0;
+
   std::vector<nghttp2_stream_write> outgoing_buffers_;
   std::vector<uint8_t> outgoing_storage_;
   std::vector<int32_t> pending_rst_streams_;
@@ -1009,6 +1111,8 @@ class Http2SessionPerformanceEntry : public PerformanceEntry {
           stream_count_(stats.stream_count),
           max_concurrent_streams_(stats.max_concurrent_streams),
           stream_average_duration_(stats.stream_average_duration),
+          write_count_(stats.write_count),
+          write_buffer_count_(stats.write_buffer_count),
           session_type_(type) { }
 
   uint64_t ping_rtt() const { return ping_rtt_; }
@@ -1019,6 +1123,8 @@ class Http2SessionPerformanceEntry : public PerformanceEntry {
   int32_t stream_count() const { return stream_count_; }
   size_t max_concurrent_streams() const { return max_concurrent_streams_; }
   double stream_average_duration() const { return stream_average_duration_; }
+  uint64_t write_count() const { return write_count_; }
+  uint64_t write_buffer_count() const { return write_buffer_count_; }
   nghttp2_session_type type() const { return session_type_; }
 
   void Notify(Local<Value> obj) {
@@ -1034,6 +1140,8 @@ class Http2SessionPerformanceEntry : public PerformanceEntry {
   int32_t stream_count_;
   size_t max_concurrent_streams_;
   double stream_average_duration_;
+  uint64_t write_count_;
+  uint64_t write_buffer_count_;
   nghttp2_session_type session_type_;
 };
 
@@ -1184,18 +1292,28 @@ class ExternalHeader :
       return String::Empty(env->isolate());
     }
 
-    if (may_internalize && vec.len < 64) {
+    Local<String> str;
+    if (session->GetCachedHeaderString(buf).ToLocal(&str)) {
       nghttp2_rcbuf_decref(buf);
+      return str;
+    }
+
+    if (may_internalize && vec.len < 64) {
       // This is a short header name, so there is a good chance V8 already has
       // it internalized.
-      return GetInternalizedString(env, vec);
+      if (GetInternalizedString(env, vec).ToLocal(&str))
+        session->CacheHeaderString(buf, str);
+      nghttp2_rcbuf_decref(buf);
+      return str;
     }
 
     session->StopTrackingRcbuf(buf);
     ExternalHeader* h_str = new ExternalHeader(buf);
-    MaybeLocal<String> str = String::NewExternalOneByte(env->isolate(), h_str);
-    if (str.IsEmpty())
+    if (!String::NewExternalOneByte(env->isolate(), h_str).ToLocal(&str)) {
       delete h_str;
+      return MaybeLocal<String>();
+    }
+    session->CacheHeaderString(buf, str);
 
     return str;
   }
@@ -52,6 +52,7 @@ namespace http2 {
     IDX_OPTIONS_MAX_OUTSTANDING_PINGS,
     IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS,
     IDX_OPTIONS_MAX_SESSION_MEMORY,
+    IDX_OPTIONS_WRITE_COALESCING_THRESHOLD,
     IDX_OPTIONS_FLAGS
   };
 
@@ -82,6 +83,8 @@ namespace http2 {
     IDX_SESSION_STATS_DATA_SENT,
     IDX_SESSION_STATS_DATA_RECEIVED,
     IDX_SESSION_STATS_MAX_CONCURRENT_STREAMS,
+    IDX_SESSION_STATS_WRITE_COUNT,
+    IDX_SESSION_STATS_WRITE_BUFFER_COUNT,
     IDX_SESSION_STATS_COUNT
   };
 
@@ -35,8 +35,11 @@
 
 #include "http_parser_adaptor.h"
 
+#include <algorithm>
 #include <cstdlib>  // free()
 #include <cstring>  // strdup(), strchr()
+#include <memory>
+#include <vector>
 
 
 // This is a binding to http_parser (https://github.com/nodejs/http-parser)
@@ -78,62 +81,114 @@ const uint32_t kOnHeadersComplete = 1;
 const uint32_t kOnBody = 2;
 const uint32_t kOnMessageComplete = 3;
 const uint32_t kOnExecute = 4;
-// Any more fields than this will be flushed into JS
-const size_t kMaxHeaderFieldsCount = 32;
 
-// helper class for the Parser
-struct StringPtr {
-  StringPtr() {
-    on_heap_ = false;
-    Reset();
+// Memory for header strings that have to outlive the buffer they were parsed
+// from. It is handed out from blocks that are kept when the arena is reset for
+// the next message, so that a parser that is reused for further requests,
+// either on a keep-alive connection or from the JS FreeList, does not
+// allocate again.
+class HeaderArena {
+ public:
+  char* Allocate(size_t size) {
+    while (current_ < blocks_.size()) {
+      Block& block = blocks_[current_];
+      if (block.size - used_ >= size) {
+        char* ret = block.data.get() + used_;
+        used_ += size;
+        return ret;
+      }
+      current_++;
+      used_ = 0;
+    }
+
+    size_t block_size = std::max(kBlockSize, size);
+    blocks_.push_back(Block { std::unique_ptr<char[]>(new char[block_size]),
+                              block_size });
+    current_ = blocks_.size() - 1;
+    used_ = size;
+    return blocks_.back().data.get();
   }
 
 
-  ~StringPtr() {
+  // Grows the most recent allocation `str` of `size` bytes by `extra` bytes
+  // in place, if there is room for that.
+  bool Extend(const char* str, size_t size, size_t extra) {
+    if (current_ >= blocks_.size())
+      return false;
+    Block& block = blocks_[current_];
+    if (str + size != block.data.get() + used_ || block.size - used_ < extra)
+      return false;
+    used_ += extra;
+    return true;
+  }
+
+
+  // Makes all memory available again. Blocks beyond the first kRetainedSize
+  // bytes are freed, they are only needed for unusually large headers.
+  void Reset() {
+    size_t retained = 0;
+    size_t i = 0;
+    while (i < blocks_.size() && retained + blocks_[i].size <= kRetainedSize)
+      retained += blocks_[i++].size;
+    blocks_.resize(i);
+    current_ = 0;
+    used_ = 0;
+  }
+
+ private:
+  static const size_t kBlockSize = 4096;
+  static const size_t kRetainedSize = 16384;
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  size_t current_ = 0;  // The block that is being allocated from
+  size_t used_ = 0;     // Bytes allocated from the current block
+};
+
+
+// helper class for the Parser
+struct StringPtr {
+  StringPtr() {
     Reset();
   }
 
 
-  // If str_ does not point to a heap string yet, this function makes it do
-  // so. This is called at the end of each http_parser_execute() so as not
+  // If str_ does not point to the arena yet, this function copies it there.
+  // This is called at the end of each http_parser_execute() so as not
   // to leak references. See issue #2438 and test-http-parser-bad-ref.js.
-  void Save() {
-    if (!on_heap_ && size_ > 0) {
-      char* s = new char[size_];
+  void Save(HeaderArena* arena) {
+    if (!in_arena_ && size_ > 0) {
+      char* s = arena->Allocate(size_);
       memcpy(s, str_, size_);
       str_ = s;
-      on_heap_ = true;
+      in_arena_ = true;
     }
   }
 
 
   void Reset() {
-    if (on_heap_) {
-      delete[] str_;
-      on_heap_ = false;
-    }
-
     str_ = nullptr;
+    in_arena_ = false;
     size_ = 0;
   }
 
 
-  void Update(const char* str, size_t size) {
+  void Update(const char* str, size_t size, HeaderArena* arena) {
     if (str_ == nullptr) {
       str_ = str;
-    } else if (on_heap_ || str_ + size_ != str) {
-      // Non-consecutive input, make a copy on the heap.
-      // TODO(bnoordhuis) Use slab allocation, O(n) allocs is bad.
-      char* s = new char[size_ + size];
+    } else if (in_arena_ && arena->Extend(str_, size_, size)) {
+      memcpy(const_cast<char*>(str_) + size_, str, size);
+    } else if (in_arena_ || str_ + size_ != str) {
+      // Non-consecutive input, make a copy in the arena.
+      char* s = arena->Allocate(size_ + size);
       memcpy(s, str_, size_);
       memcpy(s + size_, str, size);
-
-      if (on_heap_)
-        delete[] str_;
-      else
-        on_heap_ = true;
-
       str_ = s;
+      in_arena_ = true;
     }
     size_ += size;
   }
@@ -148,7 +203,7 @@ struct StringPtr {
 
 
   const char* str_;
-  bool on_heap_;
+  bool in_arena_;
   size_t size_;
 };
 
@@ -174,6 +229,7 @@ class Parser : public AsyncWrap, public StreamListener {
     num_fields_ = num_values_ = 0;
     url_.Reset();
     status_message_.Reset();
+    arena_.Reset();
     return 0;
   }
 
@@ -184,7 +240,7 @@ class Parser : public AsyncWrap, public StreamListener {
       return rv;
     }
 
-    url_.Update(at, length);
+    url_.Update(at, length, &arena_);
     return 0;
   }
 
@@ -195,7 +251,7 @@ class Parser : public AsyncWrap, public StreamListener {
       return rv;
     }
 
-    status_message_.Update(at, length);
+    status_message_.Update(at, length, &arena_);
     return 0;
   }
 
@@ -209,19 +265,16 @@ class Parser : public AsyncWrap, public StreamListener {
     if (num_fields_ == num_values_) {
       // start of new field name
       num_fields_++;
-      if (num_fields_ == kMaxHeaderFieldsCount) {
-        // ran out of space - flush to javascript land
-        Flush();
-        num_fields_ = 1;
-        num_values_ = 0;
+      if (num_fields_ > fields_.size()) {
+        fields_.resize(num_fields_);
+        values_.resize(num_fields_);
       }
       fields_[num_fields_ - 1].Reset();
     }
 
-    CHECK_LT(num_fields_, kMaxHeaderFieldsCount);
     CHECK_EQ(num_fields_, num_values_ + 1);
 
-    fields_[num_fields_ - 1].Update(at, length);
+    fields_[num_fields_ - 1].Update(at, length, &arena_);
 
     return 0;
   }
@@ -239,10 +292,10 @@ class Parser : public AsyncWrap, public StreamListener {
       values_[num_values_ - 1].Reset();
     }
 
-    CHECK_LT(num_values_, arraysize(values_));
+    CHECK_LE(num_values_, values_.size());
     CHECK_EQ(num_values_, num_fields_);
 
-    values_[num_values_ - 1].Update(at, length);
+    values_[num_values_ - 1].Update(at, length, &arena_);
 
     return 0;
   }
@@ -281,15 +334,10 @@ class Parser : public AsyncWrap, public StreamListener {
     for (size_t i = 0; i < arraysize(argv); i++)
       argv[i] = undefined;
 
-    if (have_flushed_) {
-      // Slow case, flush remaining headers.
-      Flush();
-    } else {
-      // Fast case, pass headers and URL to JS land.
-      argv[A_HEADERS] = CreateHeaders();
-      if (parser_.type == HTTP_REQUEST)
-        argv[A_URL] = url_.ToString(env());
-    }
+    // All headers and the URL are passed to JS land at once.
+    argv[A_HEADERS] = CreateHeaders();
+    if (parser_.type == HTTP_REQUEST)
+      argv[A_URL] = url_.ToString(env());
 
     num_fields_ = 0;
     num_values_ = 0;
@@ -453,15 +501,15 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   void Save() {
-    url_.Save();
-    status_message_.Save();
+    url_.Save(&arena_);
+    status_message_.Save(&arena_);
 
     for (size_t i = 0; i < num_fields_; i++) {
-      fields_[i].Save();
+      fields_[i].Save(&arena_);
     }
 
     for (size_t i = 0; i < num_values_; i++) {
-      values_[i].Save();
+      values_[i].Save(&arena_);
     }
   }
 
@@ -769,19 +817,18 @@ class Parser : public AsyncWrap, public StreamListener {
   }
 
   Local<Array> CreateHeaders() {
-    // There could be extra entries but the max size should be fixed
-    Local<Value> headers_v[kMaxHeaderFieldsCount * 2];
+    MaybeStackBuffer<Local<Value>, 64> headers_v(num_values_ * 2);
 
     for (size_t i = 0; i < num_values_; ++i) {
       headers_v[i * 2] = fields_[i].ToString(env());
       headers_v[i * 2 + 1] = values_[i].ToString(env());
     }
 
-    return Array::New(env()->isolate(), headers_v, num_values_ * 2);
+    return Array::New(env()->isolate(), headers_v.out(), num_values_ * 2);
   }
 
 
-  // spill headers and request path to JS land
+  // Spill trailing headers to JS land.
   void Flush() {
     HandleScope scope(env()->isolate());
 
@@ -804,7 +851,6 @@ class Parser : public AsyncWrap, public StreamListener {
       got_exception_ = true;
 
     url_.Reset();
-    have_flushed_ = true;
   }
 
 
@@ -817,9 +863,9 @@ class Parser : public AsyncWrap, public StreamListener {
 #endif  /* NODE_EXPERIMENTAL_HTTP */
     url_.Reset();
     status_message_.Reset();
+    arena_.Reset();
     num_fields_ = 0;
     num_values_ = 0;
-    have_flushed_ = false;
     got_exception_ = false;
   }
 
@@ -853,13 +899,15 @@ class Parser : public AsyncWrap, public StreamListener {
   }
 
   parser_t parser_;
-  StringPtr fields_[kMaxHeaderFieldsCount];  // header fields
-  StringPtr values_[kMaxHeaderFieldsCount];  // header values
+  // Header fields and values. The vectors only grow, num_fields_ and
+  // num_values_ are the number of entries used by the current message.
+  std::vector<StringPtr> fields_;
+  std::vector<StringPtr> values_;
   StringPtr url_;
   StringPtr status_message_;
+  HeaderArena arena_;
   size_t num_fields_;
   size_t num_values_;
-  bool have_flushed_;
   bool got_exception_;
   Local<Object> current_buffer_;
   size_t current_buffer_len_;
@@ -919,6 +967,145 @@ void InitMaxHttpHeaderSizeOnce() {
 #endif  /* NODE_EXPERIMENTAL_HTTP */
 
 
+// Characters that may appear in a header name, as per RFC 7230 section 3.2.6.
+// Must match tokenRegExp in lib/_http_common.js.
+inline bool IsTokenChar(uint8_t c) {
+  if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9')) {
+    return true;
+  }
+  return c != '\0' && strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+}
+
+
+// Characters that may appear in a header value. Unlike headerCharRegex in
+// lib/_http_common.js this does not allow obs-text, see below.
+inline bool IsHeaderValueChar(uint8_t c) {
+  return c == '\t' || (c >= 0x20 && c <= 0x7e);
+}
+
+
+inline bool IsAscii(const char* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    if (static_cast<uint8_t>(data[i]) >= 0x80)
+      return false;
+  }
+  return true;
+}
+
+
+// serializeHeaders(buffer, offset, firstLine, fields, tail, validate)
+//
+// Writes `firstLine`, the `name: value` pairs from the flat `fields` array,
+// `tail` and the final CRLF into `buffer` starting at `offset`. Header names
+// and values are checked if `validate` is true, the other strings are
+// trusted.
+//
+// Returns the length of the header block. If that is larger than the space
+// left in `buffer` nothing has been written and the caller should retry with
+// a large enough buffer. Returns -1 if the header block can't be serialized
+// here, because a string is not ASCII-only or a name or value is invalid.
+// The caller then falls back to building the header block in JS, which also
+// takes care of throwing the right error. Strings that aren't ASCII-only are
+// left to JS because their encoding on the wire depends on the encoding of
+// the first chunk of the body.
+void SerializeHeaders(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  SPREAD_BUFFER_ARG(args[0], buffer);
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsString());
+  CHECK(args[3]->IsArray());
+  CHECK(args[4]->IsString());
+
+  const size_t offset = args[1].As<Uint32>()->Value();
+  CHECK_LE(offset, buffer_length);
+  Local<String> first_line = args[2].As<String>();
+  Local<Array> fields = args[3].As<Array>();
+  Local<String> tail = args[4].As<String>();
+  const bool validate = args[5]->IsTrue();
+
+  const uint32_t count = fields->Length();
+  CHECK_EQ(count % 2, 0);
+
+  args.GetReturnValue().Set(-1);
+
+  MaybeStackBuffer<Local<String>, 64> strings(count);
+  size_t length = first_line->Length() + tail->Length() + 2;
+  if (!first_line->IsOneByte() || !tail->IsOneByte())
+    return;
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> value;
+    if (!fields->Get(env->context(), i).ToLocal(&value))
+      return;
+    if (!value->IsString())
+      return;
+    strings[i] = value.As<String>();
+    if (!strings[i]->IsOneByte())
+      return;
+    // `name: value\r\n`
+    length += strings[i]->Length() + 2;
+  }
+
+  if (length > buffer_length - offset)
+    return args.GetReturnValue().Set(static_cast<double>(length));
+
+  char* const start = buffer_data + offset;
+  char* dst = start;
+  auto write = [&](Local<String> string) {
+    const int written = string->WriteOneByte(env->isolate(),
+                                             reinterpret_cast<uint8_t*>(dst),
+                                             0,
+                                             -1,
+                                             String::NO_NULL_TERMINATION);
+    const char* const data = dst;
+    dst += written;
+    return data;
+  };
+
+  size_t line_length = first_line->Length();
+  if (!IsAscii(write(first_line), line_length))
+    return;
+
+  for (uint32_t i = 0; i < count; i += 2) {
+    const size_t name_length = strings[i]->Length();
+    const uint8_t* name =
+        reinterpret_cast<const uint8_t*>(write(strings[i]));
+    if (validate) {
+      if (name_length == 0)
+        return;
+      for (size_t j = 0; j < name_length; j++) {
+        if (!IsTokenChar(name[j]))
+          return;
+      }
+    } else if (!IsAscii(reinterpret_cast<const char*>(name), name_length)) {
+      return;
+    }
+    *dst++ = ':';
+    *dst++ = ' ';
+
+    const size_t value_length = strings[i + 1]->Length();
+    const uint8_t* value =
+        reinterpret_cast<const uint8_t*>(write(strings[i + 1]));
+    for (size_t j = 0; j < value_length; j++) {
+      // Without validation, only check that the value is ASCII-only.
+      if (validate ? !IsHeaderValueChar(value[j]) : value[j] >= 0x80)
+        return;
+    }
+    *dst++ = '\r';
+    *dst++ = '\n';
+  }
+
+  line_length = tail->Length();
+  if (!IsAscii(write(tail), line_length))
+    return;
+  *dst++ = '\r';
+  *dst++ = '\n';
+
+  CHECK_EQ(static_cast<size_t>(dst - start), length);
+  args.GetReturnValue().Set(static_cast<double>(length));
+}
+
+
 void InitializeHttpParser(Local<Object> target,
                           Local<Value> unused,
                           Local<Context> context,
@@ -969,6 +1156,8 @@ void InitializeHttpParser(Local<Object> target,
               FIXED_ONE_BYTE_STRING(env->isolate(), "HTTPParser"),
               t->GetFunction(env->context()).ToLocalChecked()).FromJust();
 
+  env->SetMethod(target, "serializeHeaders", SerializeHeaders);
+
 #ifndef NODE_EXPERIMENTAL_HTTP
   static uv_once_t init_once = UV_ONCE_INIT;
   uv_once(&init_once, InitMaxHttpHeaderSizeOnce);
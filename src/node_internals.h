@@ -233,9 +233,14 @@ class DebugSealHandleScope {
 #endif
 };
 
+// Work is run on libuv's threadpool for its `kind`: CPU-bound work, fast
+// (file system) I/O and slow (network, e.g. DNS) I/O each have a pool of
+// their own, so that one kind of work can't starve the others.
 class ThreadPoolWork {
  public:
-  explicit inline ThreadPoolWork(Environment* env) : env_(env) {
+  explicit inline ThreadPoolWork(Environment* env,
+                                 uv_work_kind kind = UV_WORK_CPU)
+      : env_(env), kind_(kind) {
     CHECK_NOT_NULL(env);
   }
   inline virtual ~ThreadPoolWork() = default;
@@ -248,14 +253,16 @@ class ThreadPoolWork {
 
  private:
   Environment* env_;
+  uv_work_kind kind_;
   uv_work_t work_req_;
 };
 
 void ThreadPoolWork::ScheduleWork() {
   env_->IncreaseWaitingRequestCounter();
-  int status = uv_queue_work(
+  int status = uv_queue_work_kind(
       env_->event_loop(),
       &work_req_,
+      kind_,
       [](uv_work_t* req) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
         self->DoThreadPoolWork();
@@ -0,0 +1,423 @@
+#include "node_module_resolution_cache.h"
+#include "node_mutex.h"
+#include "node_version.h"
+#include "util.h"
+#include "uv.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>  // S_IFMT, S_IFREG
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#ifdef __POSIX__
+#include <sys/mman.h>  // mmap
+#endif
+
+namespace node {
+namespace module_resolution_cache {
+
+namespace {
+
+// The file is a local cache rather than an interchange format, so integers
+// are stored in host byte order:
+//
+//   header:  char magic[8], uint32_t version_length, uint32_t entry_count,
+//            followed by version_length bytes of NODE_VERSION
+//   entry:   uint32_t key_length, uint32_t filename_length,
+//            uint32_t dependency_count, int64_t mtime_sec, int64_t mtime_nsec,
+//            followed by the key and filename bytes and the dependencies
+//   dependency:
+//            uint32_t path_length, int64_t mtime_sec, int64_t mtime_nsec,
+//            followed by the path bytes
+//
+// Dependencies are the directories and package.json files that the search
+// looked at. One that did not exist is stored with an mtime of -1, so that
+// creating it invalidates the entry, too.
+//
+// Files written by another Node.js version are ignored, since resolution
+// rules may differ between releases.
+constexpr char kMagic[8] = { 'N', 'O', 'D', 'E', 'M', 'R', 'C', '2' };
+
+// Points either into the mapped file or into `owned_strings`.
+struct Slice {
+  const char* data;
+  size_t length;
+
+  bool operator==(const Slice& other) const {
+    return length == other.length && memcmp(data, other.data, length) == 0;
+  }
+};
+
+struct SliceHash {
+  size_t operator()(const Slice& slice) const {
+    // FNV-1a.
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < slice.length; i++) {
+      hash ^= static_cast<uint8_t>(slice.data[i]);
+      hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+enum class State : uint8_t { kUnvalidated, kValid, kStale };
+
+struct Dependency {
+  Slice path;
+  int64_t mtime_sec;
+  int64_t mtime_nsec;
+
+  bool operator==(const Dependency& other) const {
+    return path == other.path &&
+           mtime_sec == other.mtime_sec && mtime_nsec == other.mtime_nsec;
+  }
+};
+
+struct Entry {
+  Slice filename;
+  int64_t mtime_sec;
+  int64_t mtime_nsec;
+  std::vector<Dependency> dependencies;
+  State state;
+};
+
+Mutex cache_mutex;
+bool enabled = false;
+bool dirty = false;
+std::string cache_path;  // NOLINT(runtime/string)
+std::unordered_map<Slice, Entry, SliceHash> entries;
+std::deque<std::string> owned_strings;
+// Dependency paths recorded in this process. Most of them are shared by many
+// entries, e.g. the node_modules directories of a package.
+std::unordered_set<Slice, SliceHash> interned_paths;
+// The mtimes of the dependencies that have been validated in this process.
+// Entries are only validated once per process, so this never needs to be
+// refreshed either.
+std::unordered_map<Slice, std::pair<int64_t, int64_t>, SliceHash>
+    dependency_mtimes;
+
+bool StatMtime(const char* path, int64_t* sec, int64_t* nsec) {
+  uv_fs_t req;
+  const int rc = uv_fs_stat(nullptr, &req, path, nullptr);
+  *sec = req.statbuf.st_mtim.tv_sec;
+  *nsec = req.statbuf.st_mtim.tv_nsec;
+  const bool is_file = (req.statbuf.st_mode & S_IFMT) == S_IFREG;
+  uv_fs_req_cleanup(&req);
+  return rc == 0 && is_file;
+}
+
+void StatDependency(const char* path, int64_t* sec, int64_t* nsec) {
+  uv_fs_t req;
+  if (uv_fs_stat(nullptr, &req, path, nullptr) == 0) {
+    *sec = req.statbuf.st_mtim.tv_sec;
+    *nsec = req.statbuf.st_mtim.tv_nsec;
+  } else {
+    *sec = *nsec = -1;
+  }
+  uv_fs_req_cleanup(&req);
+}
+
+// Maps the whole file read-only. The mapping lives for the rest of the
+// process because the index points into it.
+const char* MapFile(const std::string& path, size_t* length) {
+  uv_fs_t req;
+  const int fd = uv_fs_open(nullptr, &req, path.c_str(), O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return nullptr;
+
+  const char* data = nullptr;
+  int rc = uv_fs_fstat(nullptr, &req, fd, nullptr);
+  const size_t size = req.statbuf.st_size;
+  uv_fs_req_cleanup(&req);
+  if (rc == 0 && size > 0) {
+#ifdef __POSIX__
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED)
+      data = static_cast<const char*>(mapping);
+#else
+    char* buffer = Malloc(size);
+    uv_buf_t buf = uv_buf_init(buffer, size);
+    rc = uv_fs_read(nullptr, &req, fd, &buf, 1, 0, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (rc == static_cast<int>(size))
+      data = buffer;
+    else
+      free(buffer);
+#endif
+  }
+
+  CHECK_EQ(0, uv_fs_close(nullptr, &req, fd, nullptr));
+  uv_fs_req_cleanup(&req);
+  *length = size;
+  return data;
+}
+
+template <typename T>
+inline bool ReadField(const char** pos, const char* end, T* value) {
+  const char* start = *pos;
+  if (static_cast<size_t>(end - start) < sizeof(*value))
+    return false;
+  memcpy(value, start, sizeof(*value));
+  *pos += sizeof(*value);
+  return true;
+}
+
+inline bool ReadBytes(const char** pos, const char* end, size_t length,
+                      Slice* slice) {
+  const char* start = *pos;
+  if (static_cast<size_t>(end - start) < length)
+    return false;
+  *slice = Slice { start, length };
+  *pos += length;
+  return true;
+}
+
+void Parse(const char* data, size_t length) {
+  const char* pos = data;
+  const char* const end = data + length;
+
+  Slice magic, version;
+  uint32_t version_length, count;
+  if (!ReadBytes(&pos, end, sizeof(kMagic), &magic) ||
+      memcmp(magic.data, kMagic, sizeof(kMagic)) != 0 ||
+      !ReadField(&pos, end, &version_length) ||
+      !ReadField(&pos, end, &count) ||
+      !ReadBytes(&pos, end, version_length, &version) ||
+      !(version == Slice { NODE_VERSION, sizeof(NODE_VERSION) - 1 })) {
+    return;
+  }
+
+  entries.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t key_length, filename_length, dependency_count;
+    Entry entry;
+    Slice key;
+    bool ok = ReadField(&pos, end, &key_length) &&
+              ReadField(&pos, end, &filename_length) &&
+              ReadField(&pos, end, &dependency_count) &&
+              ReadField(&pos, end, &entry.mtime_sec) &&
+              ReadField(&pos, end, &entry.mtime_nsec) &&
+              ReadBytes(&pos, end, key_length, &key) &&
+              ReadBytes(&pos, end, filename_length, &entry.filename);
+    for (uint32_t j = 0; ok && j < dependency_count; j++) {
+      uint32_t path_length;
+      Dependency dependency;
+      ok = ReadField(&pos, end, &path_length) &&
+           ReadField(&pos, end, &dependency.mtime_sec) &&
+           ReadField(&pos, end, &dependency.mtime_nsec) &&
+           ReadBytes(&pos, end, path_length, &dependency.path);
+      if (ok)
+        entry.dependencies.push_back(dependency);
+    }
+    if (!ok) {
+      // Truncated file, e.g. from a crash of an older writer. Keep what was
+      // read so far.
+      break;
+    }
+    entry.state = State::kUnvalidated;
+    entries[key] = std::move(entry);
+  }
+}
+
+template <typename T>
+inline void WriteField(FILE* file, T value) {
+  fwrite(&value, sizeof(value), 1, file);
+}
+
+void Save() {
+  Mutex::ScopedLock lock(cache_mutex);
+  if (!dirty)
+    return;
+  dirty = false;
+
+  std::string temp_path = cache_path + "." + std::to_string(uv_os_getpid()) +
+                          ".tmp";
+  FILE* file = fopen(temp_path.c_str(), "wb");
+  if (file == nullptr)
+    return;
+
+  uint32_t count = 0;
+  for (const auto& it : entries)
+    count += it.second.state != State::kStale;
+
+  fwrite(kMagic, sizeof(kMagic), 1, file);
+  WriteField<uint32_t>(file, sizeof(NODE_VERSION) - 1);
+  WriteField<uint32_t>(file, count);
+  fwrite(NODE_VERSION, sizeof(NODE_VERSION) - 1, 1, file);
+  for (const auto& it : entries) {
+    const Entry& entry = it.second;
+    if (entry.state == State::kStale)
+      continue;
+    WriteField<uint32_t>(file, it.first.length);
+    WriteField<uint32_t>(file, entry.filename.length);
+    WriteField<uint32_t>(file, entry.dependencies.size());
+    WriteField<int64_t>(file, entry.mtime_sec);
+    WriteField<int64_t>(file, entry.mtime_nsec);
+    fwrite(it.first.data, it.first.length, 1, file);
+    fwrite(entry.filename.data, entry.filename.length, 1, file);
+    for (const Dependency& dependency : entry.dependencies) {
+      WriteField<uint32_t>(file, dependency.path.length);
+      WriteField<int64_t>(file, dependency.mtime_sec);
+      WriteField<int64_t>(file, dependency.mtime_nsec);
+      fwrite(dependency.path.data, dependency.path.length, 1, file);
+    }
+  }
+
+  const bool write_ok = !ferror(file);
+  const bool ok = fclose(file) == 0 && write_ok;
+  uv_fs_t req;
+  // Concurrent processes may race to write the cache; renaming a complete
+  // file into place makes sure that readers never see a partial one.
+  if (!ok ||
+      uv_fs_rename(nullptr, &req, temp_path.c_str(), cache_path.c_str(),
+                   nullptr) != 0) {
+    if (ok)
+      uv_fs_req_cleanup(&req);
+    uv_fs_unlink(nullptr, &req, temp_path.c_str(), nullptr);
+  }
+  uv_fs_req_cleanup(&req);
+}
+
+Slice Own(const std::string& str) {
+  owned_strings.push_back(str);
+  return Slice { owned_strings.back().data(), owned_strings.back().size() };
+}
+
+Slice InternPath(const std::string& path) {
+  auto it = interned_paths.find(Slice { path.data(), path.size() });
+  if (it != interned_paths.end())
+    return *it;
+  const Slice slice = Own(path);
+  interned_paths.insert(slice);
+  return slice;
+}
+
+bool DependenciesUnchanged(const std::vector<Dependency>& dependencies) {
+  for (const Dependency& dependency : dependencies) {
+    int64_t sec, nsec;
+    bool known;
+    {
+      Mutex::ScopedLock lock(cache_mutex);
+      auto it = dependency_mtimes.find(dependency.path);
+      known = it != dependency_mtimes.end();
+      if (known) {
+        sec = it->second.first;
+        nsec = it->second.second;
+      }
+    }
+    if (!known) {
+      const std::string path(dependency.path.data, dependency.path.length);
+      StatDependency(path.c_str(), &sec, &nsec);
+      Mutex::ScopedLock lock(cache_mutex);
+      dependency_mtimes.emplace(dependency.path, std::make_pair(sec, nsec));
+    }
+    if (sec != dependency.mtime_sec || nsec != dependency.mtime_nsec)
+      return false;
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+void Initialize(const std::string& path) {
+  Mutex::ScopedLock lock(cache_mutex);
+  if (enabled)
+    return;
+  enabled = true;
+  cache_path = path;
+
+  size_t length;
+  const char* data = MapFile(path, &length);
+  if (data != nullptr)
+    Parse(data, length);
+
+  // exit() is reached both when the event loop runs dry and through
+  // process.exit(), so this catches every regular shutdown.
+  atexit(Save);
+}
+
+bool Lookup(const std::string& key, std::string* filename) {
+  const Slice key_slice { key.data(), key.size() };
+  Entry entry;
+  {
+    Mutex::ScopedLock lock(cache_mutex);
+    if (!enabled)
+      return false;
+    auto it = entries.find(key_slice);
+    if (it == entries.end())
+      return false;
+    entry = it->second;
+  }
+
+  if (entry.state == State::kStale)
+    return false;
+
+  std::string result(entry.filename.data, entry.filename.length);
+  if (entry.state == State::kUnvalidated) {
+    int64_t sec, nsec;
+    const bool valid = StatMtime(result.c_str(), &sec, &nsec) &&
+                       sec == entry.mtime_sec && nsec == entry.mtime_nsec &&
+                       DependenciesUnchanged(entry.dependencies);
+    Mutex::ScopedLock lock(cache_mutex);
+    auto it = entries.find(key_slice);
+    // Another thread may have recorded a new result in the meantime.
+    if (it != entries.end() && it->second.filename.data == entry.filename.data)
+      it->second.state = valid ? State::kValid : State::kStale;
+    if (!valid) {
+      dirty = true;
+      return false;
+    }
+  }
+
+  *filename = std::move(result);
+  return true;
+}
+
+void Record(const std::string& key,
+            const std::string& filename,
+            const std::vector<std::string>& dependencies) {
+  int64_t sec, nsec;
+  if (!StatMtime(filename.c_str(), &sec, &nsec))
+    return;
+
+  std::vector<std::pair<int64_t, int64_t>> mtimes(dependencies.size());
+  for (size_t i = 0; i < dependencies.size(); i++) {
+    StatDependency(dependencies[i].c_str(),
+                   &mtimes[i].first, &mtimes[i].second);
+  }
+
+  Mutex::ScopedLock lock(cache_mutex);
+  if (!enabled)
+    return;
+  std::vector<Dependency> recorded;
+  recorded.reserve(dependencies.size());
+  for (size_t i = 0; i < dependencies.size(); i++) {
+    recorded.push_back(Dependency { InternPath(dependencies[i]),
+                                    mtimes[i].first, mtimes[i].second });
+  }
+
+  auto it = entries.find(Slice { key.data(), key.size() });
+  if (it != entries.end()) {
+    const Entry& entry = it->second;
+    if (entry.state != State::kStale &&
+        entry.mtime_sec == sec && entry.mtime_nsec == nsec &&
+        entry.filename == Slice { filename.data(), filename.size() } &&
+        entry.dependencies == recorded) {
+      return;
+    }
+    entries.erase(it);
+  }
+
+  entries.emplace(Own(key), Entry { Own(filename), sec, nsec,
+                                    std::move(recorded), State::kValid });
+  dirty = true;
+}
+
+}  // namespace module_resolution_cache
+}  // namespace node
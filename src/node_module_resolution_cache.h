@@ -0,0 +1,39 @@
+#ifndef SRC_NODE_MODULE_RESOLUTION_CACHE_H_
+#define SRC_NODE_MODULE_RESOLUTION_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <string>
+#include <vector>
+
+namespace node {
+namespace module_resolution_cache {
+
+// Persistent, process-wide cache of CommonJS resolution results, enabled with
+// --module-resolution-cache=file. The file is mapped into memory once at
+// startup and shared by the main thread and all Workers. Each entry maps a
+// resolution key (the request and its lookup paths) to the resolved filename
+// and the mtimes of that file and of every directory and package.json that
+// the search consulted. Entries are validated lazily, the first time they are
+// used in a process, and new results are written back to the file when the
+// process exits.
+
+// Maps `path`. A missing, unreadable or incompatible file is treated as an
+// empty cache. Only the first call has any effect.
+void Initialize(const std::string& path);
+
+// Returns true and sets `*filename` if `key` has a valid entry.
+bool Lookup(const std::string& key, std::string* filename);
+
+// Records the result of a resolution that missed the cache. `dependencies`
+// are the paths whose contents decided the result; they need not exist.
+void Record(const std::string& key,
+            const std::string& filename,
+            const std::vector<std::string>& dependencies);
+
+}  // namespace module_resolution_cache
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_MODULE_RESOLUTION_CACHE_H_
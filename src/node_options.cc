@@ -427,6 +427,11 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "the process title to use on startup",
             &PerProcessOptions::title,
             kAllowedInEnvironment);
+  AddOption("--code-cache-dir",
+            "directory in which V8 code cache for CommonJS and ES modules "
+            "is stored and reused across runs",
+            &PerProcessOptions::code_cache_dir,
+            kAllowedInEnvironment);
   AddOption("--trace-event-categories",
             "comma separated list of trace event categories to record",
             &PerProcessOptions::trace_event_categories,
@@ -442,6 +447,11 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "set the maximum size of HTTP headers (default: 8KB)",
             &PerProcessOptions::max_http_header_size,
             kAllowedInEnvironment);
+  AddOption("--module-resolution-cache",
+            "persist CommonJS module resolution results in a file and "
+            "reuse them across runs",
+            &PerProcessOptions::module_resolution_cache,
+            kAllowedInEnvironment);
   AddOption("--v8-pool-size",
             "set V8's thread pool size",
             &PerProcessOptions::v8_thread_pool_size,
@@ -0,0 +1,407 @@
+#include "node_package_json.h"
+#include "node_mutex.h"
+#include "util.h"
+#include "uv.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <cstring>
+#include <unordered_map>
+
+namespace node {
+namespace package_json {
+
+namespace {
+
+// Deeper documents are left to the full JSON parser.
+constexpr int kMaxDepth = 1000;
+
+class Scanner {
+ public:
+  Scanner(const char* data, size_t length)
+      : pos_(data), end_(data + length) {}
+
+  bool ScanTopLevel(PackageFields* fields);
+
+ private:
+  inline bool AtEnd() const { return pos_ == end_; }
+  inline bool Peek(char c) const { return !AtEnd() && *pos_ == c; }
+  inline bool Consume(char c);
+  void SkipWhitespace();
+  bool ParseHex4(uint32_t* value);
+  // Decodes a string into `out`, or only validates it if `out` is nullptr.
+  bool ParseString(std::string* out);
+  bool SkipValue(int depth);
+  bool SkipNumber();
+  bool SkipLiteral(const char* literal);
+
+  const char* pos_;
+  const char* const end_;
+};
+
+bool Scanner::Consume(char c) {
+  if (!Peek(c))
+    return false;
+  pos_++;
+  return true;
+}
+
+void Scanner::SkipWhitespace() {
+  while (!AtEnd() &&
+         (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r')) {
+    pos_++;
+  }
+}
+
+bool Scanner::ParseHex4(uint32_t* value) {
+  if (end_ - pos_ < 4)
+    return false;
+  uint32_t result = 0;
+  for (int i = 0; i < 4; i++) {
+    const char c = *pos_++;
+    result <<= 4;
+    if (c >= '0' && c <= '9')
+      result |= c - '0';
+    else if (c >= 'a' && c <= 'f')
+      result |= c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+      result |= c - 'A' + 10;
+    else
+      return false;
+  }
+  *value = result;
+  return true;
+}
+
+static void AppendUtf8(std::string* out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+bool Scanner::ParseString(std::string* out) {
+  if (!Consume('"'))
+    return false;
+
+  while (!AtEnd()) {
+    // Copy runs of plain characters in one go.
+    const char* run = pos_;
+    while (!AtEnd() && *pos_ != '"' && *pos_ != '\\' &&
+           static_cast<unsigned char>(*pos_) >= 0x20) {
+      pos_++;
+    }
+    if (out != nullptr)
+      out->append(run, pos_ - run);
+
+    if (AtEnd())
+      return false;
+
+    const char c = *pos_++;
+    if (c == '"')
+      return true;
+    if (c != '\\')
+      return false;  // Unescaped control character.
+
+    if (AtEnd())
+      return false;
+    const char escape = *pos_++;
+    char decoded;
+    switch (escape) {
+      case '"': decoded = '"'; break;
+      case '\\': decoded = '\\'; break;
+      case '/': decoded = '/'; break;
+      case 'b': decoded = '\b'; break;
+      case 'f': decoded = '\f'; break;
+      case 'n': decoded = '\n'; break;
+      case 'r': decoded = '\r'; break;
+      case 't': decoded = '\t'; break;
+      case 'u': {
+        uint32_t code_point;
+        if (!ParseHex4(&code_point))
+          return false;
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          uint32_t low;
+          if (!Consume('\\') || !Consume('u') || !ParseHex4(&low) ||
+              low < 0xDC00 || low > 0xDFFF) {
+            // Lone surrogates are valid JSON but cannot be represented in
+            // UTF-8, leave them to the full parser.
+            return false;
+          }
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) +
+                       (low - 0xDC00);
+        } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+          return false;
+        }
+        if (out != nullptr)
+          AppendUtf8(out, code_point);
+        continue;
+      }
+      default:
+        return false;
+    }
+    if (out != nullptr)
+      out->push_back(decoded);
+  }
+
+  return false;
+}
+
+bool Scanner::SkipNumber() {
+  Consume('-');
+  if (Consume('0')) {
+    // No leading zeros.
+  } else if (!AtEnd() && *pos_ >= '1' && *pos_ <= '9') {
+    while (!AtEnd() && *pos_ >= '0' && *pos_ <= '9') pos_++;
+  } else {
+    return false;
+  }
+
+  if (Consume('.')) {
+    if (AtEnd() || *pos_ < '0' || *pos_ > '9')
+      return false;
+    while (!AtEnd() && *pos_ >= '0' && *pos_ <= '9') pos_++;
+  }
+
+  if (Consume('e') || Consume('E')) {
+    if (!Consume('+'))
+      Consume('-');
+    if (AtEnd() || *pos_ < '0' || *pos_ > '9')
+      return false;
+    while (!AtEnd() && *pos_ >= '0' && *pos_ <= '9') pos_++;
+  }
+
+  return true;
+}
+
+bool Scanner::SkipLiteral(const char* literal) {
+  const size_t length = strlen(literal);
+  if (static_cast<size_t>(end_ - pos_) < length ||
+      memcmp(pos_, literal, length) != 0) {
+    return false;
+  }
+  pos_ += length;
+  return true;
+}
+
+bool Scanner::SkipValue(int depth) {
+  if (depth > kMaxDepth || AtEnd())
+    return false;
+
+  switch (*pos_) {
+    case '"':
+      return ParseString(nullptr);
+    case '{':
+      pos_++;
+      SkipWhitespace();
+      if (Consume('}'))
+        return true;
+      for (;;) {
+        if (!ParseString(nullptr))
+          return false;
+        SkipWhitespace();
+        if (!Consume(':'))
+          return false;
+        SkipWhitespace();
+        if (!SkipValue(depth + 1))
+          return false;
+        SkipWhitespace();
+        if (Consume('}'))
+          return true;
+        if (!Consume(','))
+          return false;
+        SkipWhitespace();
+      }
+    case '[':
+      pos_++;
+      SkipWhitespace();
+      if (Consume(']'))
+        return true;
+      for (;;) {
+        if (!SkipValue(depth + 1))
+          return false;
+        SkipWhitespace();
+        if (Consume(']'))
+          return true;
+        if (!Consume(','))
+          return false;
+        SkipWhitespace();
+      }
+    case 't':
+      return SkipLiteral("true");
+    case 'f':
+      return SkipLiteral("false");
+    case 'n':
+      return SkipLiteral("null");
+    default:
+      return SkipNumber();
+  }
+}
+
+bool Scanner::ScanTopLevel(PackageFields* fields) {
+  if (end_ - pos_ >= 3 && memcmp(pos_, "\xEF\xBB\xBF", 3) == 0)
+    pos_ += 3;  // Skip UTF-8 BOM.
+
+  SkipWhitespace();
+  if (!Consume('{'))
+    return false;
+  SkipWhitespace();
+
+  if (!Consume('}')) {
+    std::string key;
+    for (;;) {
+      key.clear();
+      if (!ParseString(&key))
+        return false;
+      SkipWhitespace();
+      if (!Consume(':'))
+        return false;
+      SkipWhitespace();
+
+      // Like JSON.parse(), later duplicates overwrite earlier ones.
+      if (key == "main" || key == "type") {
+        std::string* value = key == "main" ? &fields->main : &fields->type;
+        if (!Peek('"'))
+          return false;  // Non-string values are left to the full parser.
+        value->clear();
+        if (!ParseString(value))
+          return false;
+        (key == "main" ? fields->has_main : fields->has_type) = true;
+      } else if (key == "exports") {
+        const char* start = pos_;
+        if (!SkipValue(1))
+          return false;
+        fields->exports.assign(start, pos_ - start);
+        fields->has_exports = true;
+      } else if (!SkipValue(1)) {
+        return false;
+      }
+
+      SkipWhitespace();
+      if (Consume('}'))
+        break;
+      if (!Consume(','))
+        return false;
+      SkipWhitespace();
+    }
+  }
+
+  SkipWhitespace();
+  return AtEnd();
+}
+
+struct CacheEntry {
+  uv_timespec_t mtime;
+  uint64_t size;
+  uint64_t ino;
+  ReadResult result;
+  std::shared_ptr<const PackageFields> fields;
+};
+
+Mutex cache_mutex;
+std::unordered_map<std::string, CacheEntry> cache;
+
+inline bool IsUnchanged(const CacheEntry& entry, const uv_stat_t& stat) {
+  return entry.mtime.tv_sec == stat.st_mtim.tv_sec &&
+         entry.mtime.tv_nsec == stat.st_mtim.tv_nsec &&
+         entry.size == stat.st_size &&
+         entry.ino == stat.st_ino;
+}
+
+bool ReadContents(const std::string& path,
+                  size_t size_hint,
+                  std::string* contents) {
+  uv_fs_t req;
+  const int fd = uv_fs_open(nullptr, &req, path.c_str(), O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return false;
+
+  // One extra byte so that a file which grew since it was stat()ed is
+  // noticed without a second round trip in the common case.
+  contents->resize(size_hint + 1);
+  size_t offset = 0;
+  bool ok = true;
+  for (;;) {
+    if (offset == contents->size())
+      contents->resize(contents->size() * 2);
+    uv_buf_t buf = uv_buf_init(&(*contents)[offset],
+                               contents->size() - offset);
+    const int r = uv_fs_read(nullptr, &req, fd, &buf, 1, offset, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (r < 0)
+      ok = false;
+    if (r <= 0)
+      break;
+    offset += r;
+  }
+  contents->resize(offset);
+
+  CHECK_EQ(0, uv_fs_close(nullptr, &req, fd, nullptr));
+  uv_fs_req_cleanup(&req);
+  return ok;
+}
+
+}  // anonymous namespace
+
+bool Scan(const char* data, size_t length, PackageFields* fields) {
+  Scanner scanner(data, length);
+  return scanner.ScanTopLevel(fields);
+}
+
+ReadResult Read(const std::string& path,
+                std::shared_ptr<const PackageFields>* fields) {
+  uv_fs_t req;
+  const int rc = uv_fs_stat(nullptr, &req, path.c_str(), nullptr);
+  const uv_stat_t stat = req.statbuf;
+  uv_fs_req_cleanup(&req);
+  if (rc != 0 || (stat.st_mode & S_IFMT) == S_IFDIR)
+    return ReadResult::kNotFound;
+
+  {
+    Mutex::ScopedLock lock(cache_mutex);
+    auto it = cache.find(path);
+    if (it != cache.end() && IsUnchanged(it->second, stat)) {
+      *fields = it->second.fields;
+      return it->second.result;
+    }
+  }
+
+  std::string contents;
+  if (!ReadContents(path, stat.st_size, &contents))
+    return ReadResult::kNotFound;
+
+  std::shared_ptr<PackageFields> parsed = std::make_shared<PackageFields>();
+  ReadResult result = ReadResult::kOk;
+  if (!Scan(contents.data(), contents.size(), parsed.get())) {
+    result = ReadResult::kNeedsFullParse;
+    parsed.reset();
+  }
+
+  {
+    Mutex::ScopedLock lock(cache_mutex);
+    CacheEntry& entry = cache[path];
+    entry.mtime = stat.st_mtim;
+    entry.size = stat.st_size;
+    entry.ino = stat.st_ino;
+    entry.result = result;
+    entry.fields = parsed;
+  }
+
+  *fields = std::move(parsed);
+  return result;
+}
+
+}  // namespace package_json
+}  // namespace node
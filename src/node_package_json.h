@@ -0,0 +1,53 @@
+#ifndef SRC_NODE_PACKAGE_JSON_H_
+#define SRC_NODE_PACKAGE_JSON_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace node {
+namespace package_json {
+
+// The package.json fields that module resolution cares about. Everything else
+// in the file is validated but not retained.
+struct PackageFields {
+  bool has_main = false;
+  bool has_exports = false;
+  bool has_type = false;
+  std::string main;
+  // The raw JSON text of the "exports" value, which may be any JSON type.
+  std::string exports;
+  std::string type;
+};
+
+enum class ReadResult {
+  // The file does not exist or could not be read.
+  kNotFound,
+  // The fields were extracted.
+  kOk,
+  // The file is not valid JSON, or uses a construct the scanner leaves to a
+  // full JSON parser (such as a non-string "main" or a lone surrogate
+  // escape). The caller should fall back to parsing the whole document.
+  kNeedsFullParse
+};
+
+// Scans the top-level object of a package.json document, validating the
+// whole document but only decoding the "main", "exports" and "type" members.
+// Returns false when the caller needs to fall back to a full JSON parse. A
+// leading UTF-8 BOM is skipped.
+bool Scan(const char* data, size_t length, PackageFields* fields);
+
+// Reads and scans the package.json file at `path`. Results are kept in a
+// process-wide cache, shared by all Environments and Workers, and reused for
+// as long as the file's mtime, size and inode are unchanged.
+ReadResult Read(const std::string& path,
+                std::shared_ptr<const PackageFields>* fields);
+
+}  // namespace package_json
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PACKAGE_JSON_H_
@@ -14,10 +14,12 @@ namespace node {
 namespace performance {
 
 using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::DontDelete;
 using v8::Function;
 using v8::FunctionCallbackInfo;
+using v8::Float64Array;
 using v8::FunctionTemplate;
 using v8::GCCallbackFlags;
 using v8::GCType;
@@ -34,6 +36,7 @@ using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::String;
+using v8::Uint32;
 using v8::Uint32Array;
 using v8::Value;
 
@@ -393,6 +396,32 @@ void Timerify(const FunctionCallbackInfo<Value>& args) {
 
 // Event Loop Timing Histogram
 namespace {
+// Fills a Float64Array with the statistics of each of libuv's threadpools,
+// in the order of `uv_work_kind`.
+static void GetThreadpoolStats(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), UV_WORK_KIND_MAX * kThreadpoolStatsFieldsCount);
+  Local<ArrayBuffer> ab = array->Buffer();
+  double* fields = static_cast<double*>(ab->GetContents().Data());
+
+  for (int kind = 0; kind < UV_WORK_KIND_MAX; kind++) {
+    uv_threadpool_stats_t stats;
+    CHECK_EQ(uv_threadpool_stats(static_cast<uv_work_kind>(kind), &stats), 0);
+    fields[kThreadpoolThreads] = stats.threads;
+    fields[kThreadpoolIdleThreads] = stats.idle_threads;
+    fields[kThreadpoolQueued] = stats.queued;
+    fields[kThreadpoolMaxQueued] = stats.max_queued;
+    fields[kThreadpoolRunning] = stats.running;
+    fields[kThreadpoolSubmitted] = stats.submitted;
+    fields[kThreadpoolCompleted] = stats.completed;
+    fields[kThreadpoolWaitTime] = stats.wait_time;
+    fields[kThreadpoolMaxWaitTime] = stats.max_wait_time;
+    fields[kThreadpoolRunTime] = stats.run_time;
+    fields += kThreadpoolStatsFieldsCount;
+  }
+}
+
 static void ELDHistogramMin(const FunctionCallbackInfo<Value>& args) {
   ELDHistogram* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
@@ -472,6 +501,111 @@ static void ELDHistogramNew(const FunctionCallbackInfo<Value>& args) {
   CHECK_GT(resolution, 0);
   new ELDHistogram(env, args.This(), resolution);
 }
+
+// The ThreadpoolMonitor methods that read a histogram take its index as the
+// first argument.
+static Histogram* GetThreadpoolHistogram(
+    const FunctionCallbackInfo<Value>& args,
+    ThreadpoolMonitor* monitor) {
+  CHECK(args[0]->IsUint32());
+  return monitor->histogram(args[0].As<Uint32>()->Value());
+}
+
+static void ThreadpoolMonitorMin(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  Histogram* histogram = GetThreadpoolHistogram(args, monitor);
+  args.GetReturnValue().Set(static_cast<double>(histogram->Min()));
+}
+
+static void ThreadpoolMonitorMax(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  Histogram* histogram = GetThreadpoolHistogram(args, monitor);
+  args.GetReturnValue().Set(static_cast<double>(histogram->Max()));
+}
+
+static void ThreadpoolMonitorMean(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  args.GetReturnValue().Set(GetThreadpoolHistogram(args, monitor)->Mean());
+}
+
+static void ThreadpoolMonitorExceeds(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  CHECK(args[0]->IsUint32());
+  double value =
+      static_cast<double>(monitor->Exceeds(args[0].As<Uint32>()->Value()));
+  args.GetReturnValue().Set(value);
+}
+
+static void ThreadpoolMonitorStddev(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  args.GetReturnValue().Set(GetThreadpoolHistogram(args, monitor)->Stddev());
+}
+
+static void ThreadpoolMonitorPercentile(
+    const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  Histogram* histogram = GetThreadpoolHistogram(args, monitor);
+  CHECK(args[1]->IsNumber());
+  double percentile = args[1].As<Number>()->Value();
+  args.GetReturnValue().Set(histogram->Percentile(percentile));
+}
+
+static void ThreadpoolMonitorPercentiles(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  Histogram* histogram = GetThreadpoolHistogram(args, monitor);
+  CHECK(args[1]->IsMap());
+  Local<Map> map = args[1].As<Map>();
+  histogram->Percentiles([&](double key, double value) {
+    map->Set(env->context(),
+             Number::New(env->isolate(), key),
+             Number::New(env->isolate(), value)).IsEmpty();
+  });
+}
+
+static void ThreadpoolMonitorEnable(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  args.GetReturnValue().Set(monitor->Enable());
+}
+
+static void ThreadpoolMonitorDisable(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  args.GetReturnValue().Set(monitor->Disable());
+}
+
+static void ThreadpoolMonitorReset(const FunctionCallbackInfo<Value>& args) {
+  ThreadpoolMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  monitor->ResetState();
+}
+
+static void ThreadpoolMonitorNew(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  new ThreadpoolMonitor(env, args.This());
+}
+
+// Called by libuv on the loop thread for every request that has been run on
+// one of the threadpools, before the request's own callback.
+static void ThreadpoolWorkTiming(uv_loop_t* loop,
+                                 void* arg,
+                                 uv_work_kind kind,
+                                 uint64_t wait_time,
+                                 uint64_t run_time) {
+  performance_state* state = static_cast<performance_state*>(arg);
+  for (ThreadpoolMonitor* monitor : state->threadpool_monitors)
+    monitor->Record(kind, wait_time, run_time);
+}
 }  // namespace
 
 ELDHistogram::ELDHistogram(
@@ -499,6 +633,57 @@ ELDHistogram::~ELDHistogram() {
   CloseTimer();
 }
 
+ThreadpoolMonitor::ThreadpoolMonitor(Environment* env, Local<Object> wrap)
+    : BaseObject(env, wrap) {
+  MakeWeak();
+  for (auto& histogram : histograms_)
+    histogram.reset(new Histogram(1, 3.6e12));
+}
+
+ThreadpoolMonitor::~ThreadpoolMonitor() {
+  Disable();
+}
+
+void ThreadpoolMonitor::Record(uv_work_kind kind,
+                               uint64_t wait_time,
+                               uint64_t run_time) {
+  size_t index = 2 * kind;
+  if (!histograms_[index]->Record(wait_time))
+    exceeds_[index]++;
+  if (!histograms_[index + 1]->Record(run_time))
+    exceeds_[index + 1]++;
+}
+
+bool ThreadpoolMonitor::Enable() {
+  if (enabled_) return false;
+  enabled_ = true;
+  performance_state* state = env()->performance_state();
+  if (state->threadpool_monitors.empty()) {
+    uv_loop_set_work_timing_cb(env()->event_loop(),
+                               ThreadpoolWorkTiming,
+                               state);
+  }
+  state->threadpool_monitors.insert(this);
+  return true;
+}
+
+bool ThreadpoolMonitor::Disable() {
+  if (!enabled_) return false;
+  enabled_ = false;
+  performance_state* state = env()->performance_state();
+  state->threadpool_monitors.erase(this);
+  if (state->threadpool_monitors.empty())
+    uv_loop_set_work_timing_cb(env()->event_loop(), nullptr, nullptr);
+  return true;
+}
+
+void ThreadpoolMonitor::ResetState() {
+  for (size_t i = 0; i < kHistogramCount; i++) {
+    histograms_[i]->Reset();
+    exceeds_[i] = 0;
+  }
+}
+
 void ELDHistogramDelayInterval(uv_timer_t* req) {
   ELDHistogram* histogram =
     reinterpret_cast<ELDHistogram*>(req->data);
@@ -587,6 +772,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "timerify", Timerify);
   env->SetMethod(
       target, "setupGarbageCollectionTracking", SetupGarbageCollectionTracking);
+  env->SetMethod(target, "getThreadpoolStats", GetThreadpoolStats);
 
   Local<Object> constants = Object::New(isolate);
 
@@ -641,6 +827,25 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(eldh, "reset", ELDHistogramReset);
   target->Set(context, eldh_classname,
               eldh->GetFunction(env->context()).ToLocalChecked()).FromJust();
+
+  Local<String> tpm_classname =
+      FIXED_ONE_BYTE_STRING(isolate, "ThreadpoolMonitor");
+  Local<FunctionTemplate> tpm =
+      env->NewFunctionTemplate(ThreadpoolMonitorNew);
+  tpm->SetClassName(tpm_classname);
+  tpm->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(tpm, "exceeds", ThreadpoolMonitorExceeds);
+  env->SetProtoMethod(tpm, "min", ThreadpoolMonitorMin);
+  env->SetProtoMethod(tpm, "max", ThreadpoolMonitorMax);
+  env->SetProtoMethod(tpm, "mean", ThreadpoolMonitorMean);
+  env->SetProtoMethod(tpm, "stddev", ThreadpoolMonitorStddev);
+  env->SetProtoMethod(tpm, "percentile", ThreadpoolMonitorPercentile);
+  env->SetProtoMethod(tpm, "percentiles", ThreadpoolMonitorPercentiles);
+  env->SetProtoMethod(tpm, "enable", ThreadpoolMonitorEnable);
+  env->SetProtoMethod(tpm, "disable", ThreadpoolMonitorDisable);
+  env->SetProtoMethod(tpm, "reset", ThreadpoolMonitorReset);
+  target->Set(context, tpm_classname,
+              tpm->GetFunction(env->context()).ToLocalChecked()).FromJust();
 }
 
 }  // namespace performance
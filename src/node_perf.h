@@ -110,6 +110,22 @@ enum PerformanceGCKind {
   NODE_PERFORMANCE_GC_WEAKCB = GCType::kGCTypeProcessWeakCallbacks
 };
 
+// Layout of the statistics that getThreadpoolStats() reports per threadpool,
+// keep in sync with lib/perf_hooks.js.
+enum ThreadpoolStatsFields {
+  kThreadpoolThreads,
+  kThreadpoolIdleThreads,
+  kThreadpoolQueued,
+  kThreadpoolMaxQueued,
+  kThreadpoolRunning,
+  kThreadpoolSubmitted,
+  kThreadpoolCompleted,
+  kThreadpoolWaitTime,
+  kThreadpoolMaxWaitTime,
+  kThreadpoolRunTime,
+  kThreadpoolStatsFieldsCount
+};
+
 class GCPerformanceEntry : public PerformanceEntry {
  public:
   GCPerformanceEntry(Environment* env,
@@ -160,6 +176,46 @@ class ELDHistogram : public BaseObject, public Histogram {
   uv_timer_t* timer_;
 };
 
+// Records how long the threadpool work of an Environment waited for a thread
+// and how long it ran. There are two histograms per kind of work, at
+// `2 * kind` for the wait times and at `2 * kind + 1` for the run times.
+class ThreadpoolMonitor : public BaseObject {
+ public:
+  static constexpr size_t kHistogramCount = 2 * UV_WORK_KIND_MAX;
+
+  ThreadpoolMonitor(Environment* env, Local<Object> wrap);
+  ~ThreadpoolMonitor() override;
+
+  void Record(uv_work_kind kind, uint64_t wait_time, uint64_t run_time);
+  bool Enable();
+  bool Disable();
+  void ResetState();
+
+  Histogram* histogram(size_t index) {
+    CHECK_LT(index, kHistogramCount);
+    return histograms_[index].get();
+  }
+  int64_t Exceeds(size_t index) {
+    CHECK_LT(index, kHistogramCount);
+    return exceeds_[index];
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    size_t size = 0;
+    for (const auto& histogram : histograms_)
+      size += histogram->GetMemorySize();
+    tracker->TrackFieldWithSize("histograms", size);
+  }
+
+  SET_MEMORY_INFO_NAME(ThreadpoolMonitor)
+  SET_SELF_SIZE(ThreadpoolMonitor)
+
+ private:
+  bool enabled_ = false;
+  std::unique_ptr<Histogram> histograms_[kHistogramCount];
+  int64_t exceeds_[kHistogramCount] = {};
+};
+
 }  // namespace performance
 }  // namespace node
 
@@ -10,12 +10,15 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <unordered_set>
 
 namespace node {
 namespace performance {
 
 #define PERFORMANCE_NOW() uv_hrtime()
 
+class ThreadpoolMonitor;
+
 // These occur before the environment is created. Cache them
 // here and add them to the milestones when the env is init'd.
 extern uint64_t performance_v8_start;
@@ -77,6 +80,9 @@ class performance_state {
 
   uint64_t performance_last_gc_start_mark = 0;
 
+  // The enabled perf_hooks.monitorThreadpool() monitors.
+  std::unordered_set<ThreadpoolMonitor*> threadpool_monitors;
+
   void Mark(enum PerformanceMilestone milestone,
             uint64_t ts = PERFORMANCE_NOW());
 
@@ -34,10 +34,14 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
-#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace node {
 
@@ -51,6 +55,7 @@ using v8::HandleScope;
 using v8::Int32;
 using v8::Integer;
 using v8::Local;
+using v8::Number;
 using v8::Object;
 using v8::String;
 using v8::Uint32;
@@ -241,7 +246,7 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
  public:
   CompressionStream(Environment* env, Local<Object> wrap)
       : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
-        ThreadPoolWork(env),
+        ThreadPoolWork(env, UV_WORK_CPU),
         write_result_(nullptr) {
     MakeWeak();
   }
@@ -714,6 +719,499 @@ class BrotliCompressionStream : public CompressionStream<CompressionContext> {
 using BrotliEncoderStream = BrotliCompressionStream<BrotliEncoderContext>;
 using BrotliDecoderStream = BrotliCompressionStream<BrotliDecoderContext>;
 
+// Compresses gzip and zlib streams pigz-style: the input is split into
+// blocks that are deflated independently and concurrently. Every block is
+// primed with the last 32 KiB of the input before it and ends with a sync
+// flush (the last one with Z_FINISH), so that the raw deflate output of all
+// blocks forms a single valid deflate stream. The header, the trailer and the
+// combined checksum are added on the main thread.
+struct DeflateBlock {
+  // Compression parameters.
+  int level;
+  int mem_level;
+  int strategy;
+  bool gzip;
+  bool last;
+
+  const unsigned char* dictionary = nullptr;
+  size_t dictionary_length = 0;
+  const unsigned char* input = nullptr;
+  size_t input_length = 0;
+  // Holds the dictionary followed by the input for asynchronous writes.
+  std::vector<unsigned char> storage;
+
+  std::vector<unsigned char> output;
+  uLong checksum = 0;
+  int err = Z_OK;
+
+  // May be called on any thread.
+  void Compress();
+};
+
+void DeflateBlock::Compress() {
+  checksum = gzip ? crc32(crc32(0L, Z_NULL, 0), input, input_length) :
+                    adler32(adler32(0L, Z_NULL, 0), input, input_length);
+
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  // Negative window bits produce a raw deflate stream.
+  err = deflateInit2(&strm, level, Z_DEFLATED, -Z_MAX_WINDOWBITS, mem_level,
+                     strategy);
+  if (err != Z_OK)
+    return;
+
+  if (dictionary_length > 0) {
+    err = deflateSetDictionary(&strm, dictionary, dictionary_length);
+    if (err != Z_OK) {
+      deflateEnd(&strm);
+      return;
+    }
+  }
+
+  // A sync flush may add a few bytes over the bound for Z_FINISH.
+  output.resize(deflateBound(&strm, input_length) + 16);
+  strm.next_in = const_cast<unsigned char*>(input);
+  strm.avail_in = input_length;
+  strm.next_out = output.data();
+  strm.avail_out = output.size();
+
+  const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+  for (;;) {
+    err = deflate(&strm, flush);
+    if (err == Z_STREAM_ERROR || strm.avail_out != 0)
+      break;
+    const size_t used = output.size();
+    output.resize(used * 2);
+    strm.next_out = output.data() + used;
+    strm.avail_out = used;
+  }
+  if (err != Z_STREAM_ERROR)
+    err = Z_OK;
+
+  output.resize(strm.total_out);
+  deflateEnd(&strm);
+}
+
+class ParallelDeflateStream : public AsyncWrap {
+ public:
+  static constexpr size_t kBlockSize = 128 * 1024;
+  static constexpr size_t kDictionarySize = 32 * 1024;
+
+  ParallelDeflateStream(Environment* env,
+                        Local<Object> wrap,
+                        node_zlib_mode mode)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
+        gzip_(mode == GZIP) {
+    CHECK(mode == GZIP || mode == DEFLATE);
+    MakeWeak();
+    ResetState();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args[0]->IsInt32());
+    node_zlib_mode mode =
+        static_cast<node_zlib_mode>(args[0].As<Int32>()->Value());
+    new ParallelDeflateStream(env, args.This(), mode);
+  }
+
+  // init(level, memLevel, strategy, parallelism, blockCallback)
+  static void Init(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.Length() == 5 &&
+          "init(level, memLevel, strategy, parallelism, blockCallback)");
+    ParallelDeflateStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    Local<Context> context = args.GetIsolate()->GetCurrentContext();
+
+    if (!args[0]->Int32Value(context).To(&wrap->level_)) return;
+    if (!args[1]->Int32Value(context).To(&wrap->mem_level_)) return;
+    if (!args[2]->Int32Value(context).To(&wrap->strategy_)) return;
+    uint32_t parallelism;
+    if (!args[3]->Uint32Value(context).To(&parallelism)) return;
+    CHECK_GT(parallelism, 0);
+    wrap->parallelism_ = parallelism;
+
+    CHECK(args[4]->IsFunction());
+    wrap->block_js_callback_.Reset(args.GetIsolate(), args[4].As<Function>());
+
+    // Fail early for invalid parameters, rather than on the threadpool.
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    const int err = deflateInit2(&strm, wrap->level_, Z_DEFLATED,
+                                 -Z_MAX_WINDOWBITS, wrap->mem_level_,
+                                 wrap->strategy_);
+    if (err == Z_OK) {
+      deflateEnd(&strm);
+    } else {
+      wrap->EmitError(CompressionError("Init error", ZlibStrerror(err), err));
+    }
+    args.GetReturnValue().Set(err == Z_OK);
+  }
+
+  // write(buffer, flush)
+  // Compresses `buffer` as one block on the threadpool. The block callback
+  // is called with the compressed data and the length of the input once
+  // this block and all blocks before it have been compressed.
+  static void Write(const FunctionCallbackInfo<Value>& args) {
+    ParallelDeflateStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    CHECK(!wrap->closed_ && "already finalized");
+    CHECK(Buffer::HasInstance(args[0]));
+    CHECK(args[1]->IsUint32());
+    const uint32_t flush = args[1].As<Uint32>()->Value();
+
+    std::unique_ptr<DeflateBlock> block(new DeflateBlock());
+    wrap->InitBlock(block.get(), flush);
+    const unsigned char* data =
+        reinterpret_cast<unsigned char*>(Buffer::Data(args[0]));
+    const size_t length = Buffer::Length(args[0]);
+    CHECK_LE(length, kBlockSize);
+    block->storage.reserve(wrap->dictionary_.size() + length);
+    block->storage.assign(wrap->dictionary_.begin(), wrap->dictionary_.end());
+    block->storage.insert(block->storage.end(), data, data + length);
+    block->dictionary = block->storage.data();
+    block->dictionary_length = wrap->dictionary_.size();
+    block->input = block->storage.data() + block->dictionary_length;
+    block->input_length = length;
+    wrap->UpdateDictionary(block.get(), flush);
+
+    if (wrap->in_flight_++ == 0)
+      wrap->ClearWeak();
+    (new DeflateBlockWork(wrap, wrap->next_write_++, std::move(block)))
+        ->ScheduleWork();
+  }
+
+  // writeSync(buffer, flush)
+  // Compresses `buffer` using up to `parallelism` threads and returns the
+  // result, including the header and trailer where they are due.
+  static void WriteSync(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    ParallelDeflateStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    CHECK(!wrap->closed_ && "already finalized");
+    CHECK_EQ(wrap->in_flight_, 0);
+    CHECK(Buffer::HasInstance(args[0]));
+    CHECK(args[1]->IsUint32());
+    const uint32_t flush = args[1].As<Uint32>()->Value();
+    env->PrintSyncTrace();
+
+    const unsigned char* data =
+        reinterpret_cast<unsigned char*>(Buffer::Data(args[0]));
+    const size_t length = Buffer::Length(args[0]);
+
+    // The input is not copied: the blocks take their dictionaries from the
+    // end of the previous block, except for the first one.
+    std::vector<DeflateBlock> blocks;
+    size_t offset = 0;
+    do {
+      const size_t block_length = std::min(kBlockSize, length - offset);
+      const bool is_last_block = offset + block_length == length;
+      blocks.emplace_back();
+      DeflateBlock* block = &blocks.back();
+      wrap->InitBlock(block, is_last_block ? flush : Z_NO_FLUSH);
+      block->input = data + offset;
+      block->input_length = block_length;
+      if (offset == 0) {
+        block->dictionary = wrap->dictionary_.data();
+        block->dictionary_length = wrap->dictionary_.size();
+      } else {
+        block->dictionary_length = std::min(offset, kDictionarySize);
+        block->dictionary = data + offset - block->dictionary_length;
+      }
+      offset += block_length;
+    } while (offset < length);
+    RunBlocks(&blocks, wrap->parallelism_);
+
+    std::vector<unsigned char> result;
+    for (DeflateBlock& block : blocks) {
+      if (!wrap->AppendBlock(&block, &result))
+        return;
+    }
+    wrap->UpdateDictionary(&blocks.back(), flush);
+
+    Local<Object> buffer;
+    if (Buffer::Copy(env,
+                     reinterpret_cast<char*>(result.data()),
+                     result.size()).ToLocal(&buffer)) {
+      args.GetReturnValue().Set(buffer);
+    }
+  }
+
+  static void Params(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.Length() == 2 && "params(level, strategy)");
+    ParallelDeflateStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    Local<Context> context = args.GetIsolate()->GetCurrentContext();
+    // Applies to blocks that are written from now on.
+    if (!args[0]->Int32Value(context).To(&wrap->level_)) return;
+    if (!args[1]->Int32Value(context).To(&wrap->strategy_)) return;
+  }
+
+  static void Reset(const FunctionCallbackInfo<Value>& args) {
+    ParallelDeflateStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    // Blocks that are still being compressed belong to the old stream and
+    // are discarded when done.
+    wrap->next_emit_ = wrap->next_write_;
+    wrap->done_.clear();
+    wrap->ResetState();
+  }
+
+  static void Close(const FunctionCallbackInfo<Value>& args) {
+    ParallelDeflateStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    // Blocks that are still being compressed are discarded when done.
+    wrap->closed_ = true;
+  }
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(ParallelDeflateStream)
+  SET_SELF_SIZE(ParallelDeflateStream)
+
+ private:
+  class DeflateBlockWork : public ThreadPoolWork {
+   public:
+    DeflateBlockWork(ParallelDeflateStream* stream,
+                     uint64_t index,
+                     std::unique_ptr<DeflateBlock> block)
+        : ThreadPoolWork(stream->env()),
+          stream_(stream),
+          index_(index),
+          block_(std::move(block)) {}
+
+    void DoThreadPoolWork() override {
+      block_->Compress();
+    }
+
+    void AfterThreadPoolWork(int status) override {
+      std::unique_ptr<DeflateBlockWork> self(this);
+      stream_->OnBlockDone(index_, std::move(block_), status);
+    }
+
+   private:
+    ParallelDeflateStream* const stream_;
+    const uint64_t index_;
+    std::unique_ptr<DeflateBlock> block_;
+  };
+
+  // Compresses `blocks` on the calling thread and up to `parallelism - 1`
+  // additional threads.
+  static void RunBlocks(std::vector<DeflateBlock>* blocks,
+                        uint32_t parallelism) {
+    struct Runner {
+      std::vector<DeflateBlock>* blocks;
+      std::atomic<size_t> next{0};
+    } runner;
+    runner.blocks = blocks;
+    auto run = [](void* arg) {
+      Runner* runner = static_cast<Runner*>(arg);
+      size_t i;
+      while ((i = runner->next++) < runner->blocks->size())
+        (*runner->blocks)[i].Compress();
+    };
+
+    std::vector<uv_thread_t> threads(
+        std::min<size_t>(parallelism, blocks->size()) - 1);
+    size_t started = 0;
+    for (uv_thread_t& thread : threads) {
+      if (uv_thread_create(&thread, run, &runner) != 0)
+        break;
+      started++;
+    }
+    run(&runner);
+    for (size_t i = 0; i < started; i++)
+      CHECK_EQ(uv_thread_join(&threads[i]), 0);
+  }
+
+  void ResetState() {
+    dictionary_.clear();
+    header_written_ = false;
+    checksum_ = gzip_ ? crc32(0L, Z_NULL, 0) : adler32(0L, Z_NULL, 0);
+    total_in_ = 0;
+  }
+
+  void InitBlock(DeflateBlock* block, uint32_t flush) const {
+    block->level = level_;
+    block->mem_level = mem_level_;
+    block->strategy = strategy_;
+    block->gzip = gzip_;
+    block->last = flush == Z_FINISH;
+  }
+
+  // Keeps the end of the input that has been written so far as dictionary
+  // for the next block. A full flush resets it, so that decompression can
+  // restart at this point.
+  void UpdateDictionary(const DeflateBlock* block, uint32_t flush) {
+    if (flush == Z_FULL_FLUSH || flush == Z_FINISH) {
+      dictionary_.clear();
+      return;
+    }
+    if (block->input_length >= kDictionarySize) {
+      dictionary_.assign(block->input + block->input_length - kDictionarySize,
+                         block->input + block->input_length);
+      return;
+    }
+    dictionary_.insert(dictionary_.end(),
+                       block->input, block->input + block->input_length);
+    if (dictionary_.size() > kDictionarySize) {
+      dictionary_.erase(dictionary_.begin(),
+                        dictionary_.end() - kDictionarySize);
+    }
+  }
+
+  void WriteHeader(std::vector<unsigned char>* out) const {
+    const int level = level_ == Z_DEFAULT_COMPRESSION ? 6 : level_;
+    if (gzip_) {
+      // Same as what deflate() writes for a gzip stream without a header
+      // set through deflateSetHeader().
+#ifdef _WIN32
+      const unsigned char os = 10;
+#else
+      const unsigned char os = 3;
+#endif
+      const unsigned char xfl =
+          level == 9 ? 2 : (strategy_ >= Z_HUFFMAN_ONLY || level < 2 ? 4 : 0);
+      const unsigned char header[] = {
+        GZIP_HEADER_ID1, GZIP_HEADER_ID2, Z_DEFLATED, 0, 0, 0, 0, 0, xfl, os
+      };
+      out->insert(out->end(), header, header + sizeof(header));
+    } else {
+      unsigned int level_flags;
+      if (strategy_ >= Z_HUFFMAN_ONLY || level < 2)
+        level_flags = 0;
+      else if (level < 6)
+        level_flags = 1;
+      else if (level == 6)
+        level_flags = 2;
+      else
+        level_flags = 3;
+      unsigned int header =
+          ((Z_DEFLATED + ((Z_MAX_WINDOWBITS - 8) << 4)) << 8) |
+          (level_flags << 6);
+      header += 31 - (header % 31);
+      out->push_back(header >> 8);
+      out->push_back(header & 0xff);
+    }
+  }
+
+  void WriteTrailer(std::vector<unsigned char>* out) const {
+    if (gzip_) {
+      const uint32_t isize = static_cast<uint32_t>(total_in_);
+      for (int i = 0; i < 4; i++)
+        out->push_back((checksum_ >> (8 * i)) & 0xff);
+      for (int i = 0; i < 4; i++)
+        out->push_back((isize >> (8 * i)) & 0xff);
+    } else {
+      for (int i = 3; i >= 0; i--)
+        out->push_back((checksum_ >> (8 * i)) & 0xff);
+    }
+  }
+
+  // Appends the output of `block` to `out`, along with the header before
+  // the first block and the trailer after the last one. Blocks must be
+  // appended in order. Returns false and emits an error if compressing the
+  // block failed.
+  bool AppendBlock(DeflateBlock* block, std::vector<unsigned char>* out) {
+    if (block->err != Z_OK) {
+      closed_ = true;
+      EmitError(CompressionError("Compression failed",
+                                 ZlibStrerror(block->err),
+                                 block->err));
+      return false;
+    }
+
+    if (!header_written_) {
+      WriteHeader(out);
+      header_written_ = true;
+    }
+    out->insert(out->end(), block->output.begin(), block->output.end());
+    checksum_ = gzip_ ?
+        crc32_combine(checksum_, block->checksum, block->input_length) :
+        adler32_combine(checksum_, block->checksum, block->input_length);
+    total_in_ += block->input_length;
+    if (block->last) {
+      WriteTrailer(out);
+      ResetState();
+    }
+    return true;
+  }
+
+  void OnBlockDone(uint64_t index,
+                   std::unique_ptr<DeflateBlock> block,
+                   int status) {
+    CHECK_GT(in_flight_, 0);
+    OnScopeLeave on_scope_leave([&]() {
+      if (--in_flight_ == 0)
+        MakeWeak();
+    });
+    if (status == UV_ECANCELED)
+      closed_ = true;
+    if (closed_ || index < next_emit_)
+      return;
+    CHECK_EQ(status, 0);
+
+    HandleScope handle_scope(env()->isolate());
+    Context::Scope context_scope(env()->context());
+
+    done_.emplace(index, std::move(block));
+    // Blocks finish in any order, but are passed to JS in the order in which
+    // they were written.
+    for (auto it = done_.find(next_emit_);
+         it != done_.end() && !closed_;
+         it = done_.find(next_emit_)) {
+      std::unique_ptr<DeflateBlock> next = std::move(it->second);
+      done_.erase(it);
+      next_emit_++;
+
+      std::vector<unsigned char> out;
+      if (!AppendBlock(next.get(), &out))
+        return;
+      Local<Object> buffer;
+      if (!Buffer::Copy(env(),
+                        reinterpret_cast<char*>(out.data()),
+                        out.size()).ToLocal(&buffer)) {
+        return;
+      }
+      Local<Value> argv[] = {
+        buffer,
+        Number::New(env()->isolate(), next->input_length)
+      };
+      Local<Function> cb = PersistentToLocal::Default(env()->isolate(),
+                                                      block_js_callback_);
+      MakeCallback(cb, arraysize(argv), argv);
+    }
+  }
+
+  // TODO(addaleax): Switch to modern error system (node_errors.h).
+  void EmitError(const CompressionError& err) {
+    HandleScope scope(env()->isolate());
+    Local<Value> args[3] = {
+      OneByteString(env()->isolate(), err.message),
+      Integer::New(env()->isolate(), err.err),
+      OneByteString(env()->isolate(), err.code)
+    };
+    MakeCallback(env()->onerror_string(), arraysize(args), args);
+  }
+
+  const bool gzip_;
+  int level_ = Z_DEFAULT_COMPRESSION;
+  int mem_level_ = Z_DEFAULT_MEMLEVEL;
+  int strategy_ = Z_DEFAULT_STRATEGY;
+  uint32_t parallelism_ = 1;
+  bool closed_ = false;
+  Persistent<Function> block_js_callback_;
+
+  std::vector<unsigned char> dictionary_;
+  bool header_written_;
+  uLong checksum_;
+  uint64_t total_in_;
+
+  size_t in_flight_ = 0;
+  uint64_t next_write_ = 0;
+  uint64_t next_emit_ = 0;
+  std::map<uint64_t, std::unique_ptr<DeflateBlock>> done_;
+};
+
 void ZlibContext::Close() {
   CHECK_LE(mode_, UNZIP);
 
@@ -1239,6 +1737,32 @@ void Initialize(Local<Object> target,
   MakeClass<BrotliEncoderStream>::Make(env, target, "BrotliEncoder");
   MakeClass<BrotliDecoderStream>::Make(env, target, "BrotliDecoder");
 
+  {
+    Local<FunctionTemplate> z =
+        env->NewFunctionTemplate(ParallelDeflateStream::New);
+    z->InstanceTemplate()->SetInternalFieldCount(1);
+    z->Inherit(AsyncWrap::GetConstructorTemplate(env));
+
+    env->SetProtoMethod(z, "write", ParallelDeflateStream::Write);
+    env->SetProtoMethod(z, "writeSync", ParallelDeflateStream::WriteSync);
+    env->SetProtoMethod(z, "close", ParallelDeflateStream::Close);
+    env->SetProtoMethod(z, "init", ParallelDeflateStream::Init);
+    env->SetProtoMethod(z, "params", ParallelDeflateStream::Params);
+    env->SetProtoMethod(z, "reset", ParallelDeflateStream::Reset);
+
+    Local<String> name =
+        FIXED_ONE_BYTE_STRING(env->isolate(), "ParallelDeflate");
+    z->SetClassName(name);
+    target->Set(env->context(),
+                name,
+                z->GetFunction(env->context()).ToLocalChecked()).FromJust();
+    target->Set(env->context(),
+                FIXED_ONE_BYTE_STRING(env->isolate(),
+                                      "PARALLEL_DEFLATE_BLOCK_SIZE"),
+                Number::New(env->isolate(),
+                            ParallelDeflateStream::kBlockSize)).FromJust();
+  }
+
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "ZLIB_VERSION"),
               FIXED_ONE_BYTE_STRING(env->isolate(), ZLIB_VERSION)).FromJust();
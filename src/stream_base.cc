@@ -7,6 +7,7 @@
 #include "node_errors.h"
 #include "env-inl.h"
 #include "js_stream.h"
+#include "stream_receive_slab.h"
 #include "string_bytes.h"
 #include "util-inl.h"
 #include "v8.h"
@@ -26,6 +27,7 @@ using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Integer;
 using v8::Local;
+using v8::MaybeLocal;
 using v8::Object;
 using v8::ReadOnly;
 using v8::String;
@@ -51,6 +53,21 @@ int StreamBase::ReadStopJS(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+int StreamBase::UseReceiveSlab(const FunctionCallbackInfo<Value>& args) {
+  default_listener_.set_use_receive_slab(true);
+  return 0;
+}
+
+
+int StreamBase::UseUserBuffer(const FunctionCallbackInfo<Value>& args) {
+  CHECK(Buffer::HasInstance(args[0]));
+
+  uv_buf_t buf = uv_buf_init(Buffer::Data(args[0]), Buffer::Length(args[0]));
+  PushStreamListener(new CustomBufferJSListener(buf));
+  return 0;
+}
+
+
 int StreamBase::Shutdown(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsObject());
   Local<Object> req_wrap_obj = args[0].As<Object>();
@@ -291,19 +308,22 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-void StreamBase::CallJSOnreadMethod(ssize_t nread,
-                                    Local<ArrayBuffer> ab,
-                                    size_t offset) {
+MaybeLocal<Value> StreamBase::CallJSOnreadMethod(ssize_t nread,
+                                                 Local<ArrayBuffer> ab,
+                                                 size_t offset,
+                                                 StreamBaseJSChecks checks) {
   Environment* env = env_;
 
   DCHECK_EQ(static_cast<int32_t>(nread), nread);
   DCHECK_LE(offset, INT32_MAX);
 
-  if (ab.IsEmpty()) {
-    DCHECK_EQ(offset, 0);
-    DCHECK_LE(nread, 0);
-  } else {
-    DCHECK_GE(nread, 0);
+  if (checks == DONT_SKIP_NREAD_CHECKS) {
+    if (ab.IsEmpty()) {
+      DCHECK_EQ(offset, 0);
+      DCHECK_LE(nread, 0);
+    } else {
+      DCHECK_GE(nread, 0);
+    }
   }
 
   env->stream_base_state()[kReadBytesOrError] = nread;
@@ -317,7 +337,7 @@ void StreamBase::CallJSOnreadMethod(ssize_t nread,
   CHECK_NOT_NULL(wrap);
   Local<Value> onread = wrap->object()->GetInternalField(kOnReadFunctionField);
   CHECK(onread->IsFunction());
-  wrap->MakeCallback(onread.As<Function>(), arraysize(argv), argv);
+  return wrap->MakeCallback(onread.As<Function>(), arraysize(argv), argv);
 }
 
 
@@ -363,8 +383,14 @@ void StreamBase::AddMethods(Environment* env, Local<FunctionTemplate> t) {
   AddMethod(env, sig, attributes, t, GetBytesRead, env->bytes_read_string());
   AddMethod(
       env, sig, attributes, t, GetBytesWritten, env->bytes_written_string());
+  AddMethod(
+      env, sig, attributes, t, GetBytesCopied, env->bytes_copied_string());
   env->SetProtoMethod(t, "readStart", JSMethod<&StreamBase::ReadStartJS>);
   env->SetProtoMethod(t, "readStop", JSMethod<&StreamBase::ReadStopJS>);
+  env->SetProtoMethod(
+      t, "useReceiveSlab", JSMethod<&StreamBase::UseReceiveSlab>);
+  env->SetProtoMethod(
+      t, "useUserBuffer", JSMethod<&StreamBase::UseUserBuffer>);
   env->SetProtoMethod(t, "shutdown", JSMethod<&StreamBase::Shutdown>);
   env->SetProtoMethod(t, "writev", JSMethod<&StreamBase::Writev>);
   env->SetProtoMethod(t, "writeBuffer", JSMethod<&StreamBase::WriteBuffer>);
@@ -411,6 +437,14 @@ void StreamBase::GetBytesWritten(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(static_cast<double>(wrap->bytes_written_));
 }
 
+void StreamBase::GetBytesCopied(const FunctionCallbackInfo<Value>& args) {
+  StreamBase* wrap = StreamBase::FromObject(args.This().As<Object>());
+  if (wrap == nullptr) return args.GetReturnValue().Set(0);
+
+  // uint64_t -> double. 53bits is enough for all real cases.
+  args.GetReturnValue().Set(static_cast<double>(wrap->bytes_copied_));
+}
+
 void StreamBase::GetExternal(const FunctionCallbackInfo<Value>& args) {
   StreamBase* wrap = StreamBase::FromObject(args.This().As<Object>());
   if (wrap == nullptr) return;
@@ -448,6 +482,11 @@ void StreamResource::ClearError() {
 uv_buf_t EmitToJSStreamListener::OnStreamAlloc(size_t suggested_size) {
   CHECK_NOT_NULL(stream_);
   Environment* env = static_cast<StreamBase*>(stream_)->stream_env();
+  if (use_receive_slab_) {
+    uv_buf_t buf = env->receive_slab()->Allocate(suggested_size);
+    if (buf.base != nullptr)
+      return buf;
+  }
   return env->AllocateManaged(suggested_size).release();
 }
 
@@ -457,6 +496,15 @@ void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
   Environment* env = stream->stream_env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
+
+  if (use_receive_slab_ && env->receive_slab()->Owns(buf_)) {
+    size_t offset = 0;
+    Local<ArrayBuffer> ab = env->receive_slab()->Commit(nread, &offset);
+    if (nread != 0)
+      stream->CallJSOnreadMethod(nread, ab, offset);
+    return;
+  }
+
   AllocatedBuffer buf(env, buf_);
 
   if (nread <= 0)  {
@@ -472,6 +520,34 @@ void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
 }
 
 
+uv_buf_t CustomBufferJSListener::OnStreamAlloc(size_t suggested_size) {
+  return buffer_;
+}
+
+
+void CustomBufferJSListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf) {
+  CHECK_NOT_NULL(stream_);
+  CHECK_EQ(buf.base, buffer_.base);
+
+  if (nread == 0)
+    return;
+
+  StreamBase* stream = static_cast<StreamBase*>(stream_);
+  Environment* env = stream->stream_env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  // The data is already in the JS Buffer, so only `nread` is passed on.
+  MaybeLocal<Value> ret = stream->CallJSOnreadMethod(
+      nread, Local<ArrayBuffer>(), 0, StreamBase::SKIP_NREAD_CHECKS);
+  Local<Value> next_buf_v;
+  if (ret.ToLocal(&next_buf_v) && Buffer::HasInstance(next_buf_v)) {
+    buffer_.base = Buffer::Data(next_buf_v);
+    buffer_.len = Buffer::Length(next_buf_v);
+  }
+}
+
+
 void ReportWritesToJSStreamListener::OnStreamAfterReqFinished(
     StreamReq* req_wrap, int status) {
   StreamBase* stream = static_cast<StreamBase*>(stream_);
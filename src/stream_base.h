@@ -177,6 +177,30 @@ class EmitToJSStreamListener : public ReportWritesToJSStreamListener {
  public:
   uv_buf_t OnStreamAlloc(size_t suggested_size) override;
   void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override;
+
+  // Carve reads out of the Environment's StreamReceiveSlab instead of
+  // allocating a buffer for each one.
+  inline void set_use_receive_slab(bool value) { use_receive_slab_ = value; }
+
+ private:
+  bool use_receive_slab_ = false;
+};
+
+
+// A stream listener that reads into a Buffer provided by JS instead of
+// allocating a new one for each read. Only the number of bytes read is
+// passed to the `.onread` method, which may return the Buffer to use for
+// the next read.
+class CustomBufferJSListener : public ReportWritesToJSStreamListener {
+ public:
+  explicit CustomBufferJSListener(uv_buf_t buffer) : buffer_(buffer) {}
+
+  uv_buf_t OnStreamAlloc(size_t suggested_size) override;
+  void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override;
+  void OnStreamDestroy() override { delete this; }
+
+ private:
+  uv_buf_t buffer_;
 };
 
 
@@ -253,6 +277,9 @@ class StreamResource {
   StreamListener* listener_ = nullptr;
   uint64_t bytes_read_ = 0;
   uint64_t bytes_written_ = 0;
+  // Bytes of incoming data that had to be copied into the listener's buffers
+  // instead of being read into them directly.
+  uint64_t bytes_copied_ = 0;
 
   friend class StreamListener;
 };
@@ -273,9 +300,13 @@ class StreamBase : public StreamResource {
   virtual bool IsIPCPipe();
   virtual int GetFD();
 
-  void CallJSOnreadMethod(ssize_t nread,
-                          v8::Local<v8::ArrayBuffer> ab,
-                          size_t offset = 0);
+  enum StreamBaseJSChecks { DONT_SKIP_NREAD_CHECKS, SKIP_NREAD_CHECKS };
+
+  v8::MaybeLocal<v8::Value> CallJSOnreadMethod(
+      ssize_t nread,
+      v8::Local<v8::ArrayBuffer> ab,
+      size_t offset = 0,
+      StreamBaseJSChecks checks = DONT_SKIP_NREAD_CHECKS);
 
   // This is named `stream_env` to avoid name clashes, because a lot of
   // subclasses are also `BaseObject`s.
@@ -318,6 +349,8 @@ class StreamBase : public StreamResource {
   // JS Methods
   int ReadStartJS(const v8::FunctionCallbackInfo<v8::Value>& args);
   int ReadStopJS(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int UseReceiveSlab(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int UseUserBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
   int Shutdown(const v8::FunctionCallbackInfo<v8::Value>& args);
   int Writev(const v8::FunctionCallbackInfo<v8::Value>& args);
   int WriteBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -328,6 +361,7 @@ class StreamBase : public StreamResource {
   static void GetExternal(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetBytesRead(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetBytesWritten(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetBytesCopied(const v8::FunctionCallbackInfo<v8::Value>& args);
   void AttachToObject(v8::Local<v8::Object> obj);
 
   template <int (StreamBase::*Method)(
@@ -0,0 +1,128 @@
+#include "stream_receive_slab.h"
+#include "env-inl.h"
+#include "util-inl.h"
+
+#include <algorithm>
+
+namespace node {
+
+using v8::ArrayBuffer;
+using v8::ArrayBufferCreationMode;
+using v8::Isolate;
+using v8::Local;
+using v8::WeakCallbackInfo;
+using v8::WeakCallbackType;
+
+namespace {
+
+// Views are aligned like the ones handed out by the JS Buffer pool, so that
+// typed arrays can be created on top of `buf.buffer`.
+inline size_t Align(size_t size) {
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+}  // anonymous namespace
+
+StreamReceiveSlab::StreamReceiveSlab(Environment* env) : env_(env) {}
+
+StreamReceiveSlab::~StreamReceiveSlab() {
+  // JS may still hold views into the current and the retired chunks, so they
+  // are left to the garbage collector. Without a slab to return to, the weak
+  // callback frees them.
+  Retire();
+  for (Chunk* chunk : retired_)
+    chunk->slab = nullptr;
+  for (char* data : pool_)
+    FreeChunkMemory(data);
+}
+
+char* StreamReceiveSlab::NewChunkMemory() {
+  env_->isolate()->AdjustAmountOfExternalAllocatedMemory(kChunkSize);
+  return Malloc(kChunkSize);
+}
+
+void StreamReceiveSlab::FreeChunkMemory(char* data) {
+  free(data);
+  env_->isolate()->AdjustAmountOfExternalAllocatedMemory(
+      -static_cast<int64_t>(kChunkSize));
+}
+
+void StreamReceiveSlab::Retire() {
+  CHECK(!pending_);
+  if (current_buffer_.IsEmpty()) {
+    // No view was ever created, so the memory can be reused right away.
+    if (current_ != nullptr)
+      pool_.push_back(current_);
+  } else {
+    Chunk* chunk = new Chunk { this, current_, std::move(current_buffer_) };
+    chunk->buffer.SetWeak(chunk, WeakCallback, WeakCallbackType::kParameter);
+    retired_.insert(chunk);
+  }
+  current_ = nullptr;
+  used_ = 0;
+}
+
+void StreamReceiveSlab::WeakCallback(const WeakCallbackInfo<Chunk>& data) {
+  Chunk* chunk = data.GetParameter();
+  chunk->buffer.Reset();
+  StreamReceiveSlab* slab = chunk->slab;
+  if (slab == nullptr) {
+    free(chunk->data);
+    data.GetIsolate()->AdjustAmountOfExternalAllocatedMemory(
+        -static_cast<int64_t>(kChunkSize));
+  } else {
+    slab->retired_.erase(chunk);
+    if (slab->pool_.size() < kMaxPooledChunks)
+      slab->pool_.push_back(chunk->data);
+    else
+      slab->FreeChunkMemory(chunk->data);
+  }
+  delete chunk;
+}
+
+uv_buf_t StreamReceiveSlab::Allocate(size_t suggested_size) {
+  if (pending_)
+    return uv_buf_init(nullptr, 0);
+
+  if (current_ != nullptr && kChunkSize - used_ < kMinReadSize) {
+    if (retired_.size() >= kMaxRetiredChunks)
+      return uv_buf_init(nullptr, 0);
+    Retire();
+  }
+  if (current_ == nullptr) {
+    if (pool_.empty()) {
+      current_ = NewChunkMemory();
+    } else {
+      current_ = pool_.back();
+      pool_.pop_back();
+    }
+  }
+
+  pending_ = true;
+  const size_t size = std::min(suggested_size, kChunkSize - used_);
+  return uv_buf_init(current_ + used_, static_cast<unsigned int>(size));
+}
+
+Local<ArrayBuffer> StreamReceiveSlab::Commit(ssize_t nread, size_t* offset) {
+  CHECK(pending_);
+  pending_ = false;
+  if (nread <= 0)
+    return Local<ArrayBuffer>();
+
+  CHECK_LE(used_ + nread, kChunkSize);
+  Isolate* isolate = env_->isolate();
+  Local<ArrayBuffer> ab;
+  if (current_buffer_.IsEmpty()) {
+    ab = ArrayBuffer::New(isolate, current_, kChunkSize,
+                          ArrayBufferCreationMode::kExternalized);
+    current_buffer_.Reset(isolate, ab);
+  } else {
+    ab = current_buffer_.Get(isolate);
+  }
+
+  *offset = used_;
+  used_ = std::min(used_ + Align(nread), kChunkSize);
+  return ab;
+}
+
+}  // namespace node
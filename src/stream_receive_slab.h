@@ -0,0 +1,89 @@
+#ifndef SRC_STREAM_RECEIVE_SLAB_H_
+#define SRC_STREAM_RECEIVE_SLAB_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "uv.h"
+#include "v8.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+// Per-Environment allocator for stream reads that opted in through
+// `handle.useReceiveSlab()`. Instead of allocating (and later shrinking) a
+// 64 KiB buffer for every read, reads are carved out of large chunks that
+// are shared by all such streams. Each chunk is exposed to JS as a single
+// ArrayBuffer, and every read becomes a Buffer view into it, so a chunk is
+// released only after the last of those views has been garbage collected.
+// Released chunks are kept around for reuse, up to a small limit.
+//
+// A single small Buffer that JS holds on to keeps its whole chunk alive, so
+// the number of chunks that are full but still referenced is capped. Past
+// the cap, reads fall back to regular allocations until the garbage
+// collector has released some of them.
+//
+// Only one read can be pending at a time. libuv calls the read callback
+// right after the alloc callback, so this only matters for streams that
+// allocate ahead of time; `Allocate()` returns a null buffer for them and the
+// caller falls back to a regular allocation.
+class StreamReceiveSlab {
+ public:
+  static constexpr size_t kChunkSize = 1024 * 1024;
+  // When less than this is left in the current chunk, a new one is started.
+  static constexpr size_t kMinReadSize = 16 * 1024;
+  static constexpr size_t kMaxPooledChunks = 4;
+  static constexpr size_t kMaxRetiredChunks = 16;
+
+  explicit StreamReceiveSlab(Environment* env);
+  ~StreamReceiveSlab();
+
+  StreamReceiveSlab(const StreamReceiveSlab&) = delete;
+  StreamReceiveSlab& operator=(const StreamReceiveSlab&) = delete;
+
+  // Returns a null buffer if the caller has to allocate the read itself.
+  uv_buf_t Allocate(size_t suggested_size);
+
+  // Whether `buf` is the region handed out by the last `Allocate()` call.
+  inline bool Owns(const uv_buf_t& buf) const {
+    return pending_ && buf.base == current_ + used_;
+  }
+
+  // Keeps the first `nread` bytes of the pending region. Returns the
+  // ArrayBuffer of the whole chunk and stores the region's position in
+  // `offset`. `nread` may be zero or negative, in which case the region is
+  // given back and an empty handle is returned.
+  v8::Local<v8::ArrayBuffer> Commit(ssize_t nread, size_t* offset);
+
+ private:
+  struct Chunk {
+    StreamReceiveSlab* slab;
+    char* data;
+    v8::Global<v8::ArrayBuffer> buffer;
+  };
+
+  static void WeakCallback(const v8::WeakCallbackInfo<Chunk>& data);
+
+  char* NewChunkMemory();
+  void FreeChunkMemory(char* data);
+  void Retire();
+
+  Environment* const env_;
+  char* current_ = nullptr;
+  size_t used_ = 0;
+  bool pending_ = false;
+  v8::Global<v8::ArrayBuffer> current_buffer_;
+
+  // Chunks that no longer receive reads but are still referenced from JS.
+  std::unordered_set<Chunk*> retired_;
+  std::vector<char*> pool_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_STREAM_RECEIVE_SLAB_H_
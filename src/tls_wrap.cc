@@ -24,9 +24,12 @@
 #include "debug_utils.h"
 #include "node_buffer.h"  // Buffer
 #include "node_crypto.h"  // SecureContext
+#include "node_crypto_async_key.h"
 #include "node_crypto_bio.h"  // NodeBIO
 // ClientHelloParser
 #include "node_crypto_clienthello-inl.h"
+#include "node_crypto_ktls.h"
+#include "node_internals.h"  // ThreadPoolWork
 #include "stream_base-inl.h"
 #include "util-inl.h"
 
@@ -34,6 +37,7 @@ namespace node {
 
 using crypto::SecureContext;
 using crypto::SSLWrap;
+using v8::Array;
 using v8::Context;
 using v8::DontDelete;
 using v8::EscapableHandleScope;
@@ -43,12 +47,58 @@ using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::Isolate;
 using v8::Local;
+using v8::Number;
 using v8::Object;
 using v8::ReadOnly;
 using v8::Signature;
 using v8::String;
 using v8::Value;
 
+// Resumes a handshake that is paused on `operation` after making the
+// operation fail, so that the handshake is aborted and the job finishes.
+static void FinishPausedHandshake(SSL* ssl,
+                                  crypto::AsyncKeyOperation* operation) {
+  operation->Fail();
+  // The owner is gone, nothing may call back into it.
+  SSL_set_info_callback(ssl, nullptr);
+  SSL_set_msg_callback(ssl, nullptr);
+  crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
+  SSL_do_handshake(ssl);
+}
+
+
+class TLSWrap::AsyncKeyWork : public ThreadPoolWork {
+ public:
+  AsyncKeyWork(TLSWrap* wrap, crypto::AsyncKeyOperation* operation)
+      : ThreadPoolWork(wrap->env()), wrap_(wrap), operation_(operation) {}
+
+  void DoThreadPoolWork() override {
+    operation_->Run();
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<AsyncKeyWork> self(this);
+    if (status == UV_ECANCELED)
+      operation_->Fail();
+    if (wrap_ != nullptr)
+      wrap_->OnAsyncKeyWorkDone();
+    else
+      FinishPausedHandshake(ssl_.get(), operation_);
+  }
+
+  void Orphan(crypto::SSLPointer&& ssl) {
+    wrap_ = nullptr;
+    ssl_ = std::move(ssl);
+  }
+
+ private:
+  TLSWrap* wrap_;
+  crypto::AsyncKeyOperation* const operation_;
+  // Owned once wrap_ is gone.
+  crypto::SSLPointer ssl_;
+};
+
+
 TLSWrap::TLSWrap(Environment* env,
                  Local<Object> obj,
                  Kind kind,
@@ -79,6 +129,7 @@ TLSWrap::TLSWrap(Environment* env,
 
 TLSWrap::~TLSWrap() {
   Debug(this, "~TLSWrap()");
+  CancelAsyncHandshake();
   sc_ = nullptr;
 }
 
@@ -196,6 +247,7 @@ void TLSWrap::Receive(const FunctionCallbackInfo<Value>& args) {
     uv_buf_t buf = wrap->OnStreamAlloc(len);
     size_t copy = buf.len > len ? len : buf.len;
     memcpy(buf.base, data, copy);
+    wrap->bytes_copied_ += copy;
     buf.len = copy;
     wrap->OnStreamRead(copy, buf);
 
@@ -230,6 +282,17 @@ void TLSWrap::SSLInfoCallback(const SSL* ssl_, int where, int ret) {
   // SSL_renegotiate_pending() should take `const SSL*`, but it does not.
   SSL* ssl = const_cast<SSL*>(ssl_);
   TLSWrap* c = static_cast<TLSWrap*>(SSL_get_app_data(ssl_));
+
+  if (crypto::InAsyncKeyJob()) {
+    // Called from within an asynchronous handshake job, see
+    // MakeDeferredCallbacks().
+    if (where & SSL_CB_HANDSHAKE_START)
+      c->deferred_handshake_start_ = true;
+    if (where & SSL_CB_HANDSHAKE_DONE && !SSL_renegotiate_pending(ssl))
+      c->deferred_handshake_done_ = true;
+    return;
+  }
+
   Environment* env = c->env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
@@ -266,6 +329,70 @@ void TLSWrap::SSLInfoCallback(const SSL* ssl_, int where, int ret) {
 }
 
 
+void TLSWrap::SSLMessageCallback(int write_p,
+                                 int version,
+                                 int content_type,
+                                 const void* buf,
+                                 size_t len,
+                                 SSL* ssl,
+                                 void* arg) {
+  if (content_type != SSL3_RT_HEADER || len == 0)
+    return;
+
+  TLSWrap* c = static_cast<TLSWrap*>(arg);
+  uint64_t* seq = write_p ? &c->ktls_write_seq_ : &c->ktls_read_seq_;
+  // The record that carries ChangeCipherSpec is the last one of its epoch,
+  // the next one is the first that uses the new keys.
+  if (static_cast<const unsigned char*>(buf)[0] == SSL3_RT_CHANGE_CIPHER_SPEC)
+    *seq = 0;
+  else
+    ++*seq;
+}
+
+
+void TLSWrap::MaybeEnableKTLS() {
+  if (!ktls_requested_ || !established_ || ssl_ == nullptr)
+    return;
+
+  // Everything that OpenSSL has produced or received so far has to be out of
+  // the way, so that the kernel starts at a record boundary on both sides.
+  if (write_size_ != 0 ||
+      !pending_cleartext_input_.empty() ||
+      BIO_pending(enc_out_) != 0 ||
+      BIO_pending(enc_in_) != 0 ||
+      SSL_has_pending(ssl_.get()) ||
+      SSL_renegotiate_pending(ssl_.get())) {
+    return;
+  }
+
+  ktls_requested_ = false;
+  SSL_set_msg_callback(ssl_.get(), nullptr);
+
+  if (shutdown_ || eof_ || SSL_get_shutdown(ssl_.get()) != 0) {
+    Debug(this, "Not enabling kTLS, connection is shutting down");
+    return;
+  }
+  const int fd = GetFD();
+  if (fd < 0 || !crypto::CanUseKTLS(ssl_.get())) {
+    Debug(this, "kTLS is not supported for this connection");
+    return;
+  }
+
+  bool partial;
+  const int err = crypto::EnableKTLS(
+      ssl_.get(), fd, ktls_write_seq_, ktls_read_seq_, &partial);
+  if (err == 0) {
+    Debug(this, "Enabled kTLS");
+    ktls_ = true;
+    return;
+  }
+
+  Debug(this, "Could not enable kTLS: %s", uv_err_name(err));
+  if (partial)
+    EmitRead(err);
+}
+
+
 void TLSWrap::EncOut() {
   Debug(this, "Trying to write encrypted output");
 
@@ -320,22 +447,15 @@ void TLSWrap::EncOut() {
         }, this, object());
       }
     }
+    MaybeEnableKTLS();
     return;
   }
 
-  char* data[kSimultaneousBufferCount];
-  size_t size[arraysize(data)];
-  size_t count = arraysize(data);
-  write_size_ = crypto::NodeBIO::FromBIO(enc_out_)->PeekMultiple(data,
-                                                                 size,
-                                                                 &count);
+  uv_buf_t bufs[kSimultaneousBufferCount];
+  size_t count = arraysize(bufs);
+  write_size_ = crypto::NodeBIO::FromBIO(enc_out_)->PeekMultiple(bufs, &count);
   CHECK(write_size_ != 0 && count != 0);
 
-  uv_buf_t buf[arraysize(data)];
-  uv_buf_t* bufs = buf;
-  for (size_t i = 0; i < count; i++)
-    buf[i] = uv_buf_init(data[i], size[i]);
-
   Debug(this, "Writing %zu buffers to the underlying stream", count);
   StreamWriteResult res = underlying_stream()->Write(bufs, count);
   if (res.err != 0) {
@@ -382,6 +502,12 @@ void TLSWrap::OnStreamAfterWrite(WriteWrap* req_wrap, int status) {
     return;
   }
 
+  // Clear text was written directly, see DoWrite().
+  if (ktls_) {
+    InvokeQueued(0);
+    return;
+  }
+
   // Commit
   crypto::NodeBIO::FromBIO(enc_out_)->Read(nullptr, write_size_);
 
@@ -407,6 +533,7 @@ Local<Value> TLSWrap::GetSSLError(int status, int* err, std::string* msg) {
     case SSL_ERROR_WANT_READ:
     case SSL_ERROR_WANT_WRITE:
     case SSL_ERROR_WANT_X509_LOOKUP:
+    case SSL_ERROR_WANT_ASYNC:
       return Local<Value>();
 
     case SSL_ERROR_ZERO_RETURN:
@@ -489,31 +616,87 @@ void TLSWrap::ClearOut() {
     return;
   }
 
+  // The kernel decrypts incoming records, see OnStreamRead().
+  if (ktls_) {
+    Debug(this, "Returning from ClearOut(), kTLS enabled");
+    return;
+  }
+
   if (ssl_ == nullptr) {
     Debug(this, "Returning from ClearOut(), ssl_ == nullptr");
     return;
   }
 
+  if (async_key_work_ != nullptr) {
+    Debug(this, "Returning from ClearOut(), private key operation pending");
+    return;
+  }
+
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  char out[kClearOutChunkSize];
-  int read;
-  for (;;) {
-    read = SSL_read(ssl_.get(), out, sizeof(out));
-    Debug(this, "Read %d bytes of cleartext output", read);
+  int read = 1;
+  if (async_handshake_ && !SSL_is_init_finished(ssl_.get())) {
+    // Run the handshake in an ASYNC job, so that its private key operations
+    // can pause it. This also resumes a paused job. The handshake is driven
+    // with SSL_do_handshake(), which, unlike SSL_read(), takes no buffer
+    // that the job would write to when it is resumed later.
+    crypto::UseAsyncKeyOperations(SSL_get_privatekey(ssl_.get()));
+    SSL_set_mode(ssl_.get(), SSL_MODE_ASYNC);
+    async_key_operation_ = nullptr;
+    read = SSL_do_handshake(ssl_.get());
+    Debug(this, "Handshake step returned %d", read);
+
+    if (read <= 0 && SSL_get_error(ssl_.get(), read) == SSL_ERROR_WANT_ASYNC) {
+      async_key_operation_ = crypto::TakeAsyncKeyOperation();
+      CHECK_NOT_NULL(async_key_operation_);
+      Debug(this, "Running private key operation on the threadpool");
+      async_key_work_ = new AsyncKeyWork(this, async_key_operation_);
+      async_key_work_->ScheduleWork();
+    } else {
+      // Only a paused job needs the mode. SSL_read() and SSL_write() must not
+      // start jobs of their own.
+      SSL_clear_mode(ssl_.get(), SSL_MODE_ASYNC);
+    }
 
-    if (read <= 0)
-      break;
+    MakeDeferredCallbacks();
+    if (ssl_ == nullptr) {
+      Debug(this, "Returning from ClearOut(), ssl_ == nullptr");
+      return;
+    }
+  }
 
-    char* current = out;
-    while (read > 0) {
-      int avail = read;
+  // Reading only starts once the handshake is done.
+  if (read > 0) {
+    for (;;) {
+      // SSL_read() returns data from at most one record, so unless part of a
+      // record is still pending, a single record is the most that can be
+      // read. Decrypt straight into the listener's buffer; if it is smaller,
+      // the rest stays pending in SSL for the next iteration. Any copy of
+      // decrypted data on its way to the listener has to be counted in
+      // bytes_copied_, which tests expect to stay zero here.
+      const int pending = SSL_pending(ssl_.get());
+      // Once the handshake is done, SSL_read() can only return data or an
+      // alert if some of it is still buffered in SSL or there is encrypted
+      // input left. Otherwise it would fail with SSL_ERROR_WANT_READ, and
+      // the buffer would be allocated only to be given back. There is no
+      // error to report then, only a possible shutdown.
+      if (pending == 0 && BIO_pending(enc_in_) == 0 &&
+          SSL_is_init_finished(ssl_.get())) {
+        Debug(this, "Leaving read loop, no input");
+        read = 1;
+        break;
+      }
+      uv_buf_t buf = EmitAlloc(pending > 0 ? pending : kClearOutChunkSize);
+      read = SSL_read(ssl_.get(), buf.base, buf.len);
+      Debug(this, "Read %d bytes of cleartext output", read);
+
+      if (read <= 0) {
+        // Give the buffer back to the listener.
+        EmitRead(0, buf);
+        break;
+      }
 
-      uv_buf_t buf = EmitAlloc(avail);
-      if (static_cast<int>(buf.len) < avail)
-        avail = buf.len;
-      memcpy(buf.base, current, avail);
-      EmitRead(avail, buf);
+      EmitRead(read, buf);
 
       // Caveat emptor: OnRead() calls into JS land which can result in
       // the SSL context object being destroyed.  We have to carefully
@@ -522,9 +705,6 @@ void TLSWrap::ClearOut() {
         Debug(this, "Returning from read loop, ssl_ == nullptr");
         return;
       }
-
-      read -= avail;
-      current += avail;
     }
   }
 
@@ -559,6 +739,62 @@ void TLSWrap::ClearOut() {
 }
 
 
+void TLSWrap::MakeDeferredCallbacks() {
+  if (deferred_handshake_start_) {
+    deferred_handshake_start_ = false;
+    SSLInfoCallback(ssl_.get(), SSL_CB_HANDSHAKE_START, 1);
+    if (ssl_ == nullptr)
+      return;
+  }
+
+  if (cert_cb_deferred_) {
+    cert_cb_deferred_ = false;
+    SSLCertCallback(ssl_.get(), this);
+    if (ssl_ == nullptr)
+      return;
+  }
+
+  if (deferred_new_session_) {
+    crypto::SSLSessionPointer session = std::move(deferred_new_session_);
+    NewSessionCallback(ssl_.get(), session.get());
+    if (ssl_ == nullptr)
+      return;
+  }
+
+  if (deferred_handshake_done_) {
+    deferred_handshake_done_ = false;
+    SSLInfoCallback(ssl_.get(), SSL_CB_HANDSHAKE_DONE, 1);
+  }
+}
+
+
+void TLSWrap::OnAsyncKeyWorkDone() {
+  Debug(this, "Private key operation finished");
+  async_key_work_ = nullptr;
+
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  // Resume the handshake before anything else calls into SSL.
+  ClearOut();
+  Cycle();
+}
+
+
+void TLSWrap::CancelAsyncHandshake() {
+  if (async_key_operation_ == nullptr || ssl_ == nullptr)
+    return;
+
+  if (async_key_work_ != nullptr) {
+    env()->isolate()->AdjustAmountOfExternalAllocatedMemory(-kExternalSize);
+    async_key_work_->Orphan(std::move(ssl_));
+    async_key_work_ = nullptr;
+  } else {
+    FinishPausedHandshake(ssl_.get(), async_key_operation_);
+  }
+  async_key_operation_ = nullptr;
+}
+
+
 void TLSWrap::ClearIn() {
   Debug(this, "Trying to write cleartext input");
   // Ignore cycling data if ClientHello wasn't yet parsed
@@ -567,6 +803,11 @@ void TLSWrap::ClearIn() {
     return;
   }
 
+  if (async_key_operation_ != nullptr) {
+    Debug(this, "Returning from ClearIn(), handshake paused");
+    return;
+  }
+
   if (ssl_ == nullptr) {
     Debug(this, "Returning from ClearIn(), ssl_ == nullptr");
     return;
@@ -704,6 +945,25 @@ int TLSWrap::DoWrite(WriteWrap* w,
     return UV_EPROTO;
   }
 
+  // The kernel encrypts the data itself, and the WriteWrap is done as soon as
+  // the underlying stream has written it.
+  if (ktls_) {
+    CHECK_NULL(current_write_);
+    current_write_ = w;
+    write_callback_scheduled_ = true;
+    StreamWriteResult res = underlying_stream()->Write(bufs, count);
+    if (res.err != 0) {
+      current_write_ = nullptr;
+      return res.err;
+    }
+    if (!res.async) {
+      env()->SetImmediate([](Environment* env, void* data) {
+        static_cast<TLSWrap*>(data)->OnStreamAfterWrite(nullptr, 0);
+      }, this, object());
+    }
+    return 0;
+  }
+
   bool empty = true;
   size_t i;
   for (i = 0; i < count; i++) {
@@ -752,6 +1012,16 @@ int TLSWrap::DoWrite(WriteWrap* w,
     return 0;
   }
 
+  // SSL_write() would run into the paused handshake job, leave the data to
+  // ClearIn().
+  if (async_key_operation_ != nullptr) {
+    Debug(this, "Handshake paused, saving %zu buffers for later write", count);
+    pending_cleartext_input_.insert(pending_cleartext_input_.end(),
+                                    &bufs[0],
+                                    &bufs[count]);
+    return 0;
+  }
+
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
   int written = 0;
@@ -793,6 +1063,8 @@ int TLSWrap::DoWrite(WriteWrap* w,
 
 uv_buf_t TLSWrap::OnStreamAlloc(size_t suggested_size) {
   CHECK_NOT_NULL(ssl_);
+  if (ktls_)
+    return EmitAlloc(suggested_size);
 
   size_t size = suggested_size;
   char* base = crypto::NodeBIO::FromBIO(enc_in_)->PeekWritable(&size);
@@ -802,6 +1074,23 @@ uv_buf_t TLSWrap::OnStreamAlloc(size_t suggested_size) {
 
 void TLSWrap::OnStreamRead(ssize_t nread, const uv_buf_t& buf) {
   Debug(this, "Read %zd bytes from underlying stream", nread);
+  if (ktls_) {
+    // The kernel fails plain reads with EIO when the next record is not
+    // application data, e.g. a close_notify alert.
+    if (nread == UV_EIO)
+      nread = crypto::ReadKTLSControlRecord(GetFD());
+    if (nread == UV_EOF) {
+      if (eof_)
+        return;
+      eof_ = true;
+      if (ssl_)
+        SSL_set_shutdown(ssl_.get(), SSL_get_shutdown(ssl_.get()) |
+                                     SSL_RECEIVED_SHUTDOWN);
+    }
+    EmitRead(nread, buf);
+    return;
+  }
+
   if (nread < 0)  {
     // Error should be emitted only after all data was read
     ClearOut();
@@ -853,8 +1142,22 @@ int TLSWrap::DoShutdown(ShutdownWrap* req_wrap) {
   Debug(this, "DoShutdown()");
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  if (ssl_ && SSL_shutdown(ssl_.get()) == 0)
+  if (ktls_ && ssl_) {
+    // All writes have finished at this point, so the alert is not going to
+    // overtake any data. It is best-effort, like the EncOut() below.
+    SSL_set_shutdown(ssl_.get(), SSL_get_shutdown(ssl_.get()) |
+                                 SSL_SENT_SHUTDOWN);
+    int err = crypto::SendKTLSCloseNotify(GetFD());
+    if (err != 0)
+      Debug(this, "Could not send close_notify: %s", uv_err_name(err));
+    shutdown_ = true;
+    return stream_->DoShutdown(req_wrap);
+  }
+
+  if (ssl_ && async_key_operation_ == nullptr &&
+      SSL_shutdown(ssl_.get()) == 0) {
     SSL_shutdown(ssl_.get());
+  }
 
   shutdown_ = true;
   EncOut();
@@ -925,6 +1228,7 @@ void TLSWrap::DestroySSL(const FunctionCallbackInfo<Value>& args) {
   wrap->InvokeQueued(UV_ECANCELED, "Canceled because of SSL destruction");
 
   // Destroy the SSL structure and friends
+  wrap->CancelAsyncHandshake();
   wrap->SSLWrap<TLSWrap>::DestroySSL();
   wrap->enc_in_ = nullptr;
   wrap->enc_out_ = nullptr;
@@ -985,6 +1289,41 @@ void TLSWrap::SetServername(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void TLSWrap::RequestKTLS(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  CHECK(!wrap->started_);
+  CHECK_NOT_NULL(wrap->ssl_);
+
+  wrap->ktls_requested_ = true;
+  SSL_set_msg_callback(wrap->ssl_.get(), SSLMessageCallback);
+  SSL_set_msg_callback_arg(wrap->ssl_.get(), wrap);
+}
+
+
+void TLSWrap::EnableAsyncHandshake(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK_NOT_NULL(wrap->ssl_);
+  CHECK(wrap->is_server());
+
+  // Keys that cannot be offloaded, e.g. Ed25519 keys or keys from engines, are
+  // still used synchronously.
+  wrap->async_handshake_ = crypto::CanUseAsyncKeyOperations();
+  if (wrap->async_handshake_)
+    crypto::UseAsyncKeyOperations(SSL_get_privatekey(wrap->ssl_.get()));
+  args.GetReturnValue().Set(wrap->async_handshake_);
+}
+
+
+void TLSWrap::IsKTLSEnabled(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  args.GetReturnValue().Set(wrap->ktls_);
+}
+
+
 int TLSWrap::SelectSNIContextCallback(SSL* s, int* ad, void* arg) {
   TLSWrap* p = static_cast<TLSWrap*>(SSL_get_app_data(s));
   Environment* env = p->env();
@@ -994,6 +1333,13 @@ int TLSWrap::SelectSNIContextCallback(SSL* s, int* ad, void* arg) {
   if (servername == nullptr)
     return SSL_TLSEXT_ERR_OK;
 
+  // V8 must not be used within a handshake job. `sni_context` is only set by
+  // the certificate callback, which has applied the context already.
+  if (crypto::InAsyncKeyJob()) {
+    return p->sni_context_.IsEmpty() ? SSL_TLSEXT_ERR_NOACK
+                                     : SSL_TLSEXT_ERR_OK;
+  }
+
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
 
@@ -1021,6 +1367,9 @@ int TLSWrap::SelectSNIContextCallback(SSL* s, int* ad, void* arg) {
   SecureContext* sc = Unwrap<SecureContext>(ctx.As<Object>());
   CHECK_NOT_NULL(sc);
   p->SetSNIContext(sc);
+  // The key of the new context is used later in the same job.
+  if (p->async_handshake_)
+    crypto::UseAsyncKeyOperations(SSL_get_privatekey(s));
   return SSL_TLSEXT_ERR_OK;
 }
 
@@ -1049,6 +1398,20 @@ void TLSWrap::MemoryInfo(MemoryTracker* tracker) const {
 }
 
 
+// Returns the number of NodeBIO buffers that have been allocated, and of
+// those that were reused from the pool instead.
+static void GetBIOBufferPoolStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  crypto::NodeBIOBufferPool* pool = env->bio_buffer_pool();
+  Local<Value> stats[] = {
+    Number::New(env->isolate(), static_cast<double>(pool->allocated())),
+    Number::New(env->isolate(), static_cast<double>(pool->reused()))
+  };
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), stats, arraysize(stats)));
+}
+
+
 void TLSWrap::Initialize(Local<Object> target,
                          Local<Value> unused,
                          Local<Context> context,
@@ -1056,6 +1419,7 @@ void TLSWrap::Initialize(Local<Object> target,
   Environment* env = Environment::GetCurrent(context);
 
   env->SetMethod(target, "wrap", TLSWrap::Wrap);
+  env->SetMethod(target, "getBIOBufferPoolStats", GetBIOBufferPoolStats);
 
   Local<FunctionTemplate> t = BaseObject::MakeLazilyInitializedJSTemplate(env);
   Local<String> tlsWrapString =
@@ -1088,6 +1452,9 @@ void TLSWrap::Initialize(Local<Object> target,
 
   env->SetProtoMethod(t, "getServername", GetServername);
   env->SetProtoMethod(t, "setServername", SetServername);
+  env->SetProtoMethod(t, "requestKTLS", RequestKTLS);
+  env->SetProtoMethod(t, "isKTLSEnabled", IsKTLSEnabled);
+  env->SetProtoMethod(t, "enableAsyncHandshake", EnableAsyncHandshake);
 
   env->set_tls_wrap_constructor_function(
       t->GetFunction(env->context()).ToLocalChecked());
@@ -41,6 +41,7 @@ namespace node {
 // Forward-declarations
 class WriteWrap;
 namespace crypto {
+class AsyncKeyOperation;
 class SecureContext;
 class NodeBIO;
 }
@@ -116,6 +117,14 @@ class TLSWrap : public AsyncWrap,
           crypto::SecureContext* sc);
 
   static void SSLInfoCallback(const SSL* ssl_, int where, int ret);
+  // Counts records to keep track of the sequence numbers, see RequestKTLS().
+  static void SSLMessageCallback(int write_p,
+                                 int version,
+                                 int content_type,
+                                 const void* buf,
+                                 size_t len,
+                                 SSL* ssl,
+                                 void* arg);
   void InitSSL();
   // SSL has a "clear" text (unencrypted) side (to/from the node API) and
   // encrypted ("enc") text side (to/from the underlying socket/stream).
@@ -127,6 +136,23 @@ class TLSWrap : public AsyncWrap,
   void ClearIn();  // SSL_write() clear data "in" to SSL.
   void ClearOut();  // SSL_read() clear text "out" from SSL.
 
+  // Makes the callbacks into JS that were deferred because they were due
+  // while an asynchronous handshake job was running.
+  void MakeDeferredCallbacks();
+  // Called once the private key operation of an asynchronous handshake has
+  // finished on the threadpool.
+  void OnAsyncKeyWorkDone();
+  // Called before ssl_ is destroyed. If the handshake is paused, makes its
+  // private key operation fail and finishes the job, possibly once the
+  // AsyncKeyWork is done, which then takes ssl_ over.
+  void CancelAsyncHandshake();
+
+  // Hands the connection over to kernel TLS if it was requested and no data
+  // is buffered on either side of SSL. Afterwards, OpenSSL is no longer used
+  // for reading or writing, and clear text is passed through to the
+  // underlying stream as is.
+  void MaybeEnableKTLS();
+
   // Call Done() on outstanding WriteWrap request.
   bool InvokeQueued(int status, const char* error_str = nullptr);
 
@@ -165,6 +191,10 @@ class TLSWrap : public AsyncWrap,
   static void DestroySSL(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetServername(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetServername(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void RequestKTLS(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void IsKTLSEnabled(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableAsyncHandshake(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static int SelectSNIContextCallback(SSL* s, int* ad, void* arg);
 
   crypto::SecureContext* sc_;
@@ -188,6 +218,26 @@ class TLSWrap : public AsyncWrap,
   // after the `UV_EOF` on socket.
   bool eof_ = false;
 
+  bool ktls_requested_ = false;
+  bool ktls_ = false;
+  // Sequence numbers of the next records to be written to enc_out_ and read
+  // from enc_in_ by OpenSSL.
+  uint64_t ktls_write_seq_ = 0;
+  uint64_t ktls_read_seq_ = 0;
+
+  // Private key operations of the handshake run on the threadpool, see
+  // node_crypto_async_key.h.
+  class AsyncKeyWork;
+  bool async_handshake_ = false;
+  // The operation that paused the handshake, from the moment
+  // SSL_do_handshake() returned until ClearOut() resumes the job. No other
+  // SSL functions must be called in the meantime.
+  crypto::AsyncKeyOperation* async_key_operation_ = nullptr;
+  // Runs async_key_operation_ on the threadpool.
+  AsyncKeyWork* async_key_work_ = nullptr;
+  bool deferred_handshake_start_ = false;
+  bool deferred_handshake_done_ = false;
+
  private:
   static void GetWriteQueueSize(
       const v8::FunctionCallbackInfo<v8::Value>& info);
@@ -74,16 +74,87 @@ inline bool SendWrap::have_callback() const {
 }
 
 
-UDPWrap::UDPWrap(Environment* env, Local<Object> object)
+// Tracks the datagrams of a sendBatch() call that could not be written
+// synchronously. The first one is dispatched through the ReqWrap's own
+// request, the others through extra_reqs_; JS is called back once, after
+// the last of them has completed.
+class SendBatchWrap : public ReqWrap<uv_udp_send_t> {
+ public:
+  SendBatchWrap(Environment* env,
+                Local<Object> req_wrap_obj,
+                bool have_callback,
+                size_t count);
+  inline bool have_callback() const { return have_callback_; }
+  inline uv_udp_send_t* extra_req(size_t index);
+  inline void Queued() { pending_++; }
+  inline void Failed(int status) { if (status_ == 0) status_ = status; }
+  // Returns true when the last outstanding datagram has completed.
+  inline bool Done(int status);
+  inline int status() const { return status_; }
+  size_t msg_size = 0;
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(SendBatchWrap)
+  SET_SELF_SIZE(SendBatchWrap)
+
+ private:
+  const bool have_callback_;
+  std::unique_ptr<uv_udp_send_t[]> extra_reqs_;
+  size_t pending_ = 0;
+  int status_ = 0;
+};
+
+
+SendBatchWrap::SendBatchWrap(Environment* env,
+                             Local<Object> req_wrap_obj,
+                             bool have_callback,
+                             size_t count)
+    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_UDPSENDWRAP),
+      have_callback_(have_callback) {
+  CHECK_GT(count, 0);
+  if (count > 1)
+    extra_reqs_.reset(new uv_udp_send_t[count - 1]);
+}
+
+
+uv_udp_send_t* SendBatchWrap::extra_req(size_t index) {
+  uv_udp_send_t* req = &extra_reqs_[index];
+  req->data = this;
+  return req;
+}
+
+
+bool SendBatchWrap::Done(int status) {
+  Failed(status);
+  CHECK_GT(pending_, 0);
+  return --pending_ == 0;
+}
+
+
+UDPWrap::UDPWrap(Environment* env,
+                 Local<Object> object,
+                 uint32_t recv_batch)
     : HandleWrap(env,
                  object,
                  reinterpret_cast<uv_handle_t*>(&handle_),
-                 AsyncWrap::PROVIDER_UDPWRAP) {
-  int r = uv_udp_init(env->event_loop(), &handle_);
+                 AsyncWrap::PROVIDER_UDPWRAP),
+      recv_batch_(recv_batch) {
+  unsigned int flags = AF_UNSPEC;
+  if (recv_batch_ > 0)
+    flags |= UV_UDP_RECVMMSG;
+  int r = uv_udp_init_ex(env->event_loop(), &handle_, flags);
   CHECK_EQ(r, 0);  // can't fail anyway
 }
 
 
+void UDPWrap::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("recv_slab", recv_slab_.size);
+  tracker->TrackFieldWithSize("pending_datagrams",
+                              pending_datagrams_.capacity() *
+                                  sizeof(PendingDatagram));
+}
+
+
 void UDPWrap::Initialize(Local<Object> target,
                          Local<Value> unused,
                          Local<Context> context,
@@ -117,6 +188,8 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "send", Send);
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "send6", Send6);
+  env->SetProtoMethod(t, "sendBatch", SendBatch);
+  env->SetProtoMethod(t, "sendBatch6", SendBatch6);
   env->SetProtoMethod(t, "recvStart", RecvStart);
   env->SetProtoMethod(t, "recvStop", RecvStop);
   env->SetProtoMethod(t, "getsockname",
@@ -151,6 +224,7 @@ void UDPWrap::Initialize(Local<Object> target,
 
   Local<Object> constants = Object::New(env->isolate());
   NODE_DEFINE_CONSTANT(constants, UV_UDP_IPV6ONLY);
+  NODE_DEFINE_CONSTANT(constants, kMaxRecvBatch);
   target->Set(context,
               env->constants_string(),
               constants).FromJust();
@@ -160,7 +234,13 @@ void UDPWrap::Initialize(Local<Object> target,
 void UDPWrap::New(const FunctionCallbackInfo<Value>& args) {
   CHECK(args.IsConstructCall());
   Environment* env = Environment::GetCurrent(args);
-  new UDPWrap(env, args.This());
+  // new UDP([recvBatch])
+  uint32_t recv_batch = 0;
+  if (args[0]->IsUint32()) {
+    recv_batch = args[0].As<Uint32>()->Value();
+    CHECK_LE(recv_batch, kMaxRecvBatch);
+  }
+  new UDPWrap(env, args.This(), recv_batch);
 }
 
 
@@ -409,6 +489,124 @@ void UDPWrap::DoSend(const FunctionCallbackInfo<Value>& args, int family) {
 }
 
 
+void UDPWrap::DoSendBatch(const FunctionCallbackInfo<Value>& args,
+                          int family) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  // sendBatch(req, list, ports, addresses, hasCallback, segment)
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsArray());
+  CHECK(args[3]->IsArray());
+  CHECK(args[4]->IsBoolean());
+  CHECK(args[5]->IsBoolean());
+
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Local<Array> list = args[1].As<Array>();
+  Local<Array> ports = args[2].As<Array>();
+  Local<Array> addresses = args[3].As<Array>();
+  const bool have_callback = args[4]->IsTrue();
+  const unsigned int flags = args[5]->IsTrue() ? UV_UDP_SEGMENT : 0;
+
+  const size_t count = list->Length();
+  CHECK_GT(count, 0);
+  CHECK_EQ(ports->Length(), count);
+  CHECK_EQ(addresses->Length(), count);
+
+  MaybeStackBuffer<uv_buf_t, 64> bufs(count);
+  MaybeStackBuffer<uv_buf_t*, 64> buf_ptrs(count);
+  MaybeStackBuffer<unsigned int, 64> nbufs(count);
+  MaybeStackBuffer<sockaddr_storage, 64> addr_storage(count);
+  MaybeStackBuffer<sockaddr*, 64> addrs(count);
+  size_t msg_size = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> chunk = list->Get(env->context(), i).ToLocalChecked();
+    Local<Value> port = ports->Get(env->context(), i).ToLocalChecked();
+    Local<Value> address = addresses->Get(env->context(), i).ToLocalChecked();
+    CHECK(port->IsUint32());
+    CHECK(address->IsString());
+
+    size_t length = Buffer::Length(chunk);
+    bufs[i] = uv_buf_init(Buffer::Data(chunk), length);
+    buf_ptrs[i] = &bufs[i];
+    nbufs[i] = 1;
+    msg_size += length;
+
+    node::Utf8Value ip(env->isolate(), address);
+    int err = sockaddr_for_family(family,
+                                  ip.out(),
+                                  port.As<Uint32>()->Value(),
+                                  &addr_storage[i]);
+    if (err != 0)
+      return args.GetReturnValue().Set(err);
+    addrs[i] = reinterpret_cast<sockaddr*>(&addr_storage[i]);
+  }
+
+  // Write as much as possible right away, with one sendmmsg() or UDP_SEGMENT
+  // send, and only queue requests for what the socket buffer did not take.
+  size_t sent = 0;
+  int err = uv_udp_try_send2(&wrap->handle_,
+                             count,
+                             *buf_ptrs,
+                             *nbufs,
+                             *addrs,
+                             flags);
+  if (err >= 0)
+    sent = err;
+  else if (err != UV_EAGAIN)
+    return args.GetReturnValue().Set(err);
+
+  // The return value is the number of datagrams left in flight. When it is
+  // zero JS completes the batch itself, otherwise `oncomplete` is called.
+  if (sent == count)
+    return args.GetReturnValue().Set(0);
+
+  SendBatchWrap* req_wrap;
+  {
+    AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(wrap);
+    req_wrap = new SendBatchWrap(env, req_wrap_obj, have_callback,
+                                 count - sent);
+  }
+  req_wrap->msg_size = msg_size;
+
+  err = req_wrap->Dispatch(uv_udp_send,
+                           &wrap->handle_,
+                           buf_ptrs[sent],
+                           1,
+                           addrs[sent],
+                           OnSendBatch);
+  if (err) {
+    delete req_wrap;
+    return args.GetReturnValue().Set(err);
+  }
+  req_wrap->Queued();
+
+  for (size_t i = sent + 1; i < count; i++) {
+    err = uv_udp_send(req_wrap->extra_req(i - sent - 1),
+                      &wrap->handle_,
+                      buf_ptrs[i],
+                      1,
+                      addrs[i],
+                      OnSendBatch);
+    if (err) {
+      // The datagrams queued so far will still complete, report the error
+      // through `oncomplete` once they have.
+      req_wrap->Failed(err);
+      break;
+    }
+    req_wrap->Queued();
+  }
+
+  args.GetReturnValue().Set(static_cast<uint32_t>(count - sent));
+}
+
+
 void UDPWrap::Send(const FunctionCallbackInfo<Value>& args) {
   DoSend(args, AF_INET);
 }
@@ -419,6 +617,16 @@ void UDPWrap::Send6(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void UDPWrap::SendBatch(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET);
+}
+
+
+void UDPWrap::SendBatch6(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET6);
+}
+
+
 void UDPWrap::RecvStart(const FunctionCallbackInfo<Value>& args) {
   UDPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
@@ -457,10 +665,40 @@ void UDPWrap::OnSend(uv_udp_send_t* req, int status) {
 }
 
 
+void UDPWrap::OnSendBatch(uv_udp_send_t* req, int status) {
+  SendBatchWrap* req_wrap = static_cast<SendBatchWrap*>(req->data);
+  if (!req_wrap->Done(status))
+    return;
+
+  std::unique_ptr<SendBatchWrap> req_wrap_ptr{req_wrap};
+  if (req_wrap->have_callback()) {
+    Environment* env = req_wrap->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Value> arg[] = {
+      Integer::New(env->isolate(), req_wrap->status()),
+      Integer::New(env->isolate(), req_wrap->msg_size),
+    };
+    req_wrap->MakeCallback(env->oncomplete_string(), 2, arg);
+  }
+}
+
+
 void UDPWrap::OnAlloc(uv_handle_t* handle,
                       size_t suggested_size,
                       uv_buf_t* buf) {
   UDPWrap* wrap = static_cast<UDPWrap*>(handle->data);
+  if (wrap->recv_batch_ > 0) {
+    // Datagrams are copied out of the slab before libuv asks for another
+    // buffer, so a single allocation can be reused for the socket's lifetime.
+    if (wrap->recv_slab_.is_empty()) {
+      wrap->recv_slab_ =
+          MallocedBuffer<char>(wrap->recv_batch_ * suggested_size);
+      wrap->pending_datagrams_.reserve(wrap->recv_batch_);
+    }
+    *buf = uv_buf_init(wrap->recv_slab_.data, wrap->recv_slab_.size);
+    return;
+  }
   *buf = wrap->env()->AllocateManaged(suggested_size).release();
 }
 
@@ -472,6 +710,9 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
   UDPWrap* wrap = static_cast<UDPWrap*>(handle->data);
   Environment* env = wrap->env();
 
+  if (wrap->recv_batch_ > 0)
+    return wrap->OnRecvBatched(nread, buf_, addr, flags);
+
   AllocatedBuffer buf(env, *buf_);
   if (nread == 0 && addr == nullptr) {
     return;
@@ -499,6 +740,168 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
   wrap->MakeCallback(env->onmessage_string(), arraysize(argv), argv);
 }
 
+
+static bool IsSameHost(const sockaddr_storage* a, const sockaddr_storage* b) {
+  if (a->ss_family != b->ss_family)
+    return false;
+  switch (a->ss_family) {
+    case AF_INET6:
+      return memcmp(&reinterpret_cast<const sockaddr_in6*>(a)->sin6_addr,
+                    &reinterpret_cast<const sockaddr_in6*>(b)->sin6_addr,
+                    sizeof(in6_addr)) == 0;
+    case AF_INET:
+      return memcmp(&reinterpret_cast<const sockaddr_in*>(a)->sin_addr,
+                    &reinterpret_cast<const sockaddr_in*>(b)->sin_addr,
+                    sizeof(in_addr)) == 0;
+    default:
+      return false;
+  }
+}
+
+
+void UDPWrap::OnRecvBatched(ssize_t nread,
+                            const uv_buf_t* buf,
+                            const struct sockaddr* addr,
+                            unsigned int flags) {
+  // libuv is done with the slab, hand everything read so far to JS.
+  if (flags & UV_UDP_MMSG_FREE)
+    return FlushRecvBatch();
+
+  if (nread == 0 && addr == nullptr)
+    return FlushRecvBatch();
+
+  if (nread < 0) {
+    FlushRecvBatch();
+    if (IsHandleClosing())
+      return;
+
+    Environment* env = this->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Value> argv[] = {
+      Integer::New(env->isolate(), nread),
+      object(),
+      Undefined(env->isolate()),
+      Undefined(env->isolate())
+    };
+    MakeCallback(env->onmessage_string(), arraysize(argv), argv);
+    return;
+  }
+
+  CHECK_GE(buf->base, recv_slab_.data);
+  CHECK_LE(buf->base + nread, recv_slab_.data + recv_slab_.size);
+
+  PendingDatagram datagram;
+  datagram.offset = buf->base - recv_slab_.data;
+  datagram.length = nread;
+  memset(&datagram.address, 0, sizeof(datagram.address));
+  if (addr != nullptr) {
+    memcpy(&datagram.address,
+           addr,
+           addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6) :
+                                         sizeof(sockaddr_in));
+  }
+  pending_datagrams_.push_back(datagram);
+
+  // Datagrams read by recvmsg() rather than recvmmsg() are not followed by a
+  // UV_UDP_MMSG_FREE callback, deliver them right away.
+  if (!(flags & UV_UDP_MMSG_CHUNK))
+    FlushRecvBatch();
+}
+
+
+void UDPWrap::FlushRecvBatch() {
+  if (pending_datagrams_.empty())
+    return;
+
+  Environment* env = this->env();
+  if (IsHandleClosing()) {
+    pending_datagrams_.clear();
+    return;
+  }
+
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  size_t total = 0;
+  for (const PendingDatagram& datagram : pending_datagrams_)
+    total += datagram.length;
+
+  // Compact the datagrams, which recvmmsg() left at 64 KB strides, into one
+  // Buffer that JS slices per message.
+  AllocatedBuffer buf = env->AllocateManaged(total);
+  const size_t count = pending_datagrams_.size();
+  MaybeStackBuffer<Local<Value>, 5 * kMaxRecvBatch> info(5 * count);
+  Local<String> address;
+  const sockaddr_storage* last_address = nullptr;
+  size_t offset = 0;
+
+  // info is a flat list of (offset, length, address, family, port) tuples.
+  for (size_t i = 0; i < count; i++) {
+    const PendingDatagram& datagram = pending_datagrams_[i];
+    if (datagram.length > 0) {
+      memcpy(buf.data() + offset,
+             recv_slab_.data + datagram.offset,
+             datagram.length);
+    }
+
+    const sockaddr* sa =
+        reinterpret_cast<const sockaddr*>(&datagram.address);
+    // Senders tend to repeat, so the address string is only rebuilt when the
+    // peer changes.
+    const bool same_host = last_address != nullptr &&
+                           IsSameHost(last_address, &datagram.address);
+    last_address = &datagram.address;
+    char ip[INET6_ADDRSTRLEN];
+    Local<Value> family;
+    int port;
+    switch (sa->sa_family) {
+      case AF_INET6: {
+        const sockaddr_in6* a6 = reinterpret_cast<const sockaddr_in6*>(sa);
+        if (!same_host) {
+          uv_inet_ntop(AF_INET6, &a6->sin6_addr, ip, sizeof ip);
+          address = OneByteString(env->isolate(), ip);
+        }
+        family = env->ipv6_string();
+        port = ntohs(a6->sin6_port);
+        break;
+      }
+      case AF_INET: {
+        const sockaddr_in* a4 = reinterpret_cast<const sockaddr_in*>(sa);
+        if (!same_host) {
+          uv_inet_ntop(AF_INET, &a4->sin_addr, ip, sizeof ip);
+          address = OneByteString(env->isolate(), ip);
+        }
+        family = env->ipv4_string();
+        port = ntohs(a4->sin_port);
+        break;
+      }
+      default:
+        address = String::Empty(env->isolate());
+        family = Undefined(env->isolate());
+        port = 0;
+    }
+
+    info[5 * i] = Integer::NewFromUnsigned(env->isolate(), offset);
+    info[5 * i + 1] = Integer::NewFromUnsigned(env->isolate(),
+                                               datagram.length);
+    info[5 * i + 2] = address;
+    info[5 * i + 3] = family;
+    info[5 * i + 4] = Integer::New(env->isolate(), port);
+    offset += datagram.length;
+  }
+  pending_datagrams_.clear();
+
+  Local<Value> argv[] = {
+    Integer::NewFromUnsigned(env->isolate(), count),
+    object(),
+    buf.ToBuffer().ToLocalChecked(),
+    Array::New(env->isolate(), info.out(), info.length())
+  };
+  MakeCallback(env->onmessagebatch_string(), arraysize(argv), argv);
+}
+
+
 MaybeLocal<Object> UDPWrap::Instantiate(Environment* env,
                                         AsyncWrap* parent,
                                         UDPWrap::SocketType type) {
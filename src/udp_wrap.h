@@ -30,6 +30,8 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <vector>
+
 namespace node {
 
 class UDPWrap: public HandleWrap {
@@ -48,6 +50,8 @@ class UDPWrap: public HandleWrap {
   static void Send(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Send6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStart(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStop(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void AddMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -64,23 +68,37 @@ class UDPWrap: public HandleWrap {
   static v8::MaybeLocal<v8::Object> Instantiate(Environment* env,
                                                 AsyncWrap* parent,
                                                 SocketType type);
-  SET_NO_MEMORY_INFO()
+  // Largest number of datagrams that can be drained by one recvmmsg() call.
+  static constexpr uint32_t kMaxRecvBatch = 64;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(UDPWrap)
   SET_SELF_SIZE(UDPWrap)
 
  private:
   typedef uv_udp_t HandleType;
 
+  // A datagram read into recv_slab_ that has not been delivered to JS yet.
+  struct PendingDatagram {
+    size_t offset;
+    size_t length;
+    sockaddr_storage address;
+  };
+
   template <typename T,
             int (*F)(const typename T::HandleType*, sockaddr*, int*)>
   friend void GetSockOrPeerName(const v8::FunctionCallbackInfo<v8::Value>&);
 
-  UDPWrap(Environment* env, v8::Local<v8::Object> object);
+  UDPWrap(Environment* env,
+          v8::Local<v8::Object> object,
+          uint32_t recv_batch);
 
   static void DoBind(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
   static void DoSend(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
+  static void DoSendBatch(const v8::FunctionCallbackInfo<v8::Value>& args,
+                          int family);
   static void SetMembership(const v8::FunctionCallbackInfo<v8::Value>& args,
                             uv_membership membership);
 
@@ -88,13 +106,28 @@ class UDPWrap: public HandleWrap {
                       size_t suggested_size,
                       uv_buf_t* buf);
   static void OnSend(uv_udp_send_t* req, int status);
+  static void OnSendBatch(uv_udp_send_t* req, int status);
   static void OnRecv(uv_udp_t* handle,
                      ssize_t nread,
                      const uv_buf_t* buf,
                      const struct sockaddr* addr,
                      unsigned int flags);
 
+  void OnRecvBatched(ssize_t nread,
+                     const uv_buf_t* buf,
+                     const struct sockaddr* addr,
+                     unsigned int flags);
+  void FlushRecvBatch();
+
   uv_udp_t handle_;
+
+  // When recv_batch_ is non-zero the handle reads up to that many datagrams
+  // per recvmmsg() into recv_slab_, which is reused across reads. The
+  // datagrams are compacted into a single Buffer and passed to JS through
+  // one `onmessagebatch` call.
+  const uint32_t recv_batch_;
+  MallocedBuffer<char> recv_slab_;
+  std::vector<PendingDatagram> pending_datagrams_;
 };
 
 }  // namespace node
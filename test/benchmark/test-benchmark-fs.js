@@ -12,6 +12,7 @@ runBenchmark('fs', [
   'dur=0.1',
   'len=1024',
   'concurrent=1',
+  'iouring=0',
   'pathType=relative',
   'statType=fstat',
   'statSyncType=fstatSync',
@@ -21,6 +21,7 @@ runBenchmark('http2',
                'n=1',
                'nheaders=0',
                'requests=1',
+               'size=1024',
                'streams=1'
              ],
              {
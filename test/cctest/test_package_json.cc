@@ -0,0 +1,82 @@
+#include "node_package_json.h"
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using node::package_json::PackageFields;
+using node::package_json::Scan;
+
+static bool ScanString(const std::string& source, PackageFields* fields) {
+  return Scan(source.data(), source.size(), fields);
+}
+
+TEST(PackageJsonScanTest, ExtractsFields) {
+  PackageFields fields;
+  ASSERT_TRUE(ScanString(
+      "{\n"
+      "  \"name\": \"pkg\",\n"
+      "  \"version\": \"1.0.0\",\n"
+      "  \"main\": \"lib/index.js\",\n"
+      "  \"type\": \"module\",\n"
+      "  \"exports\": { \".\": [\"./a.js\", { \"x\": -1.5e+3 }] },\n"
+      "  \"dependencies\": { \"a\": \"^1.0.0\" },\n"
+      "  \"private\": true, \"bin\": null, \"files\": []\n"
+      "}\n", &fields));
+  EXPECT_TRUE(fields.has_main);
+  EXPECT_EQ("lib/index.js", fields.main);
+  EXPECT_TRUE(fields.has_type);
+  EXPECT_EQ("module", fields.type);
+  EXPECT_TRUE(fields.has_exports);
+  EXPECT_EQ("{ \".\": [\"./a.js\", { \"x\": -1.5e+3 }] }", fields.exports);
+}
+
+TEST(PackageJsonScanTest, MissingFields) {
+  PackageFields fields;
+  ASSERT_TRUE(ScanString("{}", &fields));
+  EXPECT_FALSE(fields.has_main);
+  EXPECT_FALSE(fields.has_exports);
+  EXPECT_FALSE(fields.has_type);
+
+  // Only top-level members count.
+  ASSERT_TRUE(ScanString("{\"config\": {\"main\": \"x.js\"}}", &fields));
+  EXPECT_FALSE(fields.has_main);
+}
+
+TEST(PackageJsonScanTest, DecodesStrings) {
+  PackageFields fields;
+  ASSERT_TRUE(ScanString(
+      "\xEF\xBB\xBF{\"m\\u0061in\": \"a\\\\b\\/c\\\"\\u00e9\\ud83d\\ude00\"}",
+      &fields));
+  EXPECT_TRUE(fields.has_main);
+  EXPECT_EQ("a\\b/c\"\xC3\xA9\xF0\x9F\x98\x80", fields.main);
+}
+
+TEST(PackageJsonScanTest, LaterDuplicatesWin) {
+  PackageFields fields;
+  ASSERT_TRUE(ScanString("{\"main\": \"a.js\", \"main\": \"b.js\"}", &fields));
+  EXPECT_EQ("b.js", fields.main);
+}
+
+TEST(PackageJsonScanTest, FallsBack) {
+  auto fails = [](const char* source) {
+    PackageFields fields;
+    return !Scan(source, strlen(source), &fields);
+  };
+
+  // Invalid JSON.
+  EXPECT_TRUE(fails(""));
+  EXPECT_TRUE(fails("[]"));
+  EXPECT_TRUE(fails("{"));
+  EXPECT_TRUE(fails("{\"main\": \"a.js\",}"));
+  EXPECT_TRUE(fails("{\"a\": 01}"));
+  EXPECT_TRUE(fails("{\"a\": tru}"));
+  EXPECT_TRUE(fails("{\"a\": \"\t\"}"));
+  EXPECT_TRUE(fails("{} {}"));
+  // Valid JSON that is left to the full parser.
+  EXPECT_TRUE(fails("{\"main\": 1}"));
+  EXPECT_TRUE(fails("{\"main\": \"\\ud800\"}"));
+  EXPECT_TRUE(fails(("{\"a\": " + std::string(2000, '[') +
+                     std::string(2000, ']') + "}").c_str()));
+}
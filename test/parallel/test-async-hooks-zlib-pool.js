@@ -0,0 +1,41 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const async_hooks = require('async_hooks');
+const zlib = require('zlib');
+
+// Checks that a zlib handle taken from the pool is asyncReset(), i.e. that
+// every stream gets an async id of its own and the previous one is
+// destroyed.
+
+const inits = [];
+const destroys = [];
+async_hooks.createHook({
+  init(asyncId, type) {
+    if (type === 'ZLIB')
+      inits.push(asyncId);
+  },
+  destroy(asyncId) {
+    destroys.push(asyncId);
+  }
+}).enable();
+
+const input = Buffer.from('hello pooled world '.repeat(100));
+const first = zlib.gzipSync(input, { pool: true });
+const second = zlib.gzipSync(input, { pool: true });
+assert.deepStrictEqual(first, second);
+
+assert.strictEqual(inits.length, 2);
+assert.notStrictEqual(inits[0], inits[1]);
+
+zlib.gzip(input, { pool: true }, common.mustCall((err, result) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(result, first);
+  assert.strictEqual(inits.length, 3);
+  assert.strictEqual(new Set(inits).size, 3);
+  // destroy() hooks are emitted asynchronously.
+  setImmediate(common.mustCall(() => {
+    assert(destroys.includes(inits[0]));
+    assert(destroys.includes(inits[1]));
+  }));
+}));
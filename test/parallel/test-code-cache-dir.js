@@ -0,0 +1,54 @@
+'use strict';
+
+// Tests that --code-cache-dir produces code cache for CommonJS and ES modules
+// and that later runs consume it.
+
+require('../common');
+const assert = require('assert');
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+
+const cacheDir = path.join(tmpdir.path, 'code-cache');
+const cjs = path.join(tmpdir.path, 'entry.js');
+const esm = path.join(tmpdir.path, 'entry.mjs');
+fs.writeFileSync(cjs, 'function add(a, b) { return a + b; }\n' +
+                      'console.log(add(1, 2));');
+fs.writeFileSync(esm, 'const mul = (a, b) => a * b;\n' +
+                      'console.log(mul(2, 3));');
+
+function run(...args) {
+  return execFileSync(process.execPath, [
+    `--code-cache-dir=${cacheDir}`,
+    ...args
+  ]).toString().trim();
+}
+
+function cacheFiles() {
+  return fs.readdirSync(cacheDir).filter((name) => name.endsWith('.cache'));
+}
+
+assert.strictEqual(run(cjs), '3');
+assert(fs.statSync(cacheDir).isDirectory());
+const afterCjs = cacheFiles();
+assert(afterCjs.length >= 1);
+
+// The second run consumes the cache and does not need to write a new one.
+assert.strictEqual(run(cjs), '3');
+assert.deepStrictEqual(cacheFiles().sort(), afterCjs.sort());
+
+assert.strictEqual(run('--experimental-modules', esm), '6');
+assert(cacheFiles().length > afterCjs.length);
+assert.strictEqual(run('--experimental-modules', esm), '6');
+
+// A changed module gets a new cache file instead of using a stale one.
+fs.writeFileSync(cjs, 'console.log(4);');
+assert.strictEqual(run(cjs), '4');
+
+// Corrupt caches are rejected by V8 and replaced.
+for (const name of cacheFiles())
+  fs.writeFileSync(path.join(cacheDir, name), 'garbage');
+assert.strictEqual(run(cjs), '4');
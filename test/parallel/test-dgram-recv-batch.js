@@ -0,0 +1,51 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const N = 20;
+
+[0, 65, 1.5, -1].forEach((recvBatch) => {
+  common.expectsError(() => {
+    dgram.createSocket({ type: 'udp4', recvBatch });
+  }, {
+    code: 'ERR_OUT_OF_RANGE',
+    type: RangeError
+  });
+});
+
+common.expectsError(() => {
+  dgram.createSocket({ type: 'udp4', recvBatch: '8' });
+}, {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError
+});
+
+const receiver = dgram.createSocket({ type: 'udp4', recvBatch: 8 });
+const sender = dgram.createSocket('udp4');
+const seen = new Set();
+
+receiver.on('message', common.mustCall((msg, rinfo) => {
+  const id = msg.toString();
+  assert(/^message \d+$/.test(id), id);
+  assert(!seen.has(id));
+  seen.add(id);
+
+  assert.strictEqual(rinfo.address, '127.0.0.1');
+  assert.strictEqual(rinfo.family, 'IPv4');
+  assert.strictEqual(rinfo.port, sender.address().port);
+  assert.strictEqual(rinfo.size, msg.length);
+
+  if (seen.size === N) {
+    receiver.close();
+    sender.close();
+  }
+}, N));
+
+receiver.bind(0, '127.0.0.1', common.mustCall(() => {
+  const { port } = receiver.address();
+  sender.bind(0, '127.0.0.1', common.mustCall(() => {
+    for (let i = 0; i < N; i++)
+      sender.send(`message ${i}`, port, '127.0.0.1');
+  }));
+}));
@@ -0,0 +1,100 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const client = dgram.createSocket('udp4');
+
+common.expectsError(() => client.sendBatch('foo'), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError
+});
+
+common.expectsError(() => client.sendBatch([]), {
+  code: 'ERR_MISSING_ARGS',
+  type: TypeError
+});
+
+common.expectsError(() => client.sendBatch([{ msg: 42, port: 1234 }]), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError
+});
+
+common.expectsError(() => client.sendBatch([{ msg: 'a', port: 0 }]), {
+  code: 'ERR_SOCKET_BAD_PORT',
+  type: RangeError
+});
+
+common.expectsError(() => {
+  client.sendBatch([{ msg: 'a', port: 1234 }], { gso: 1 });
+}, {
+  code: 'ERR_INVALID_OPT_VALUE',
+  type: TypeError
+});
+
+const server = dgram.createSocket('udp4');
+// Two rounds: a mixed-size batch and a same-size batch eligible for GSO.
+const expected = [];
+for (let i = 0; i < 10; i++)
+  expected.push(`message ${i}`);
+for (let i = 0; i < 10; i++)
+  expected.push(`gso ${i % 10}`);
+const received = [];
+
+server.on('message', common.mustCall((msg, rinfo) => {
+  received.push(msg.toString());
+  assert.strictEqual(rinfo.port, client.address().port);
+
+  if (received.length === expected.length) {
+    assert.deepStrictEqual(received.sort(), expected.slice().sort());
+    server.close();
+    client.close();
+  }
+}, expected.length));
+
+server.bind(0, common.mustCall(() => {
+  const { port } = server.address();
+  const batch = expected.slice(0, 10).map((msg) => ({ msg, port }));
+
+  client.sendBatch(batch, common.mustCall((err, sent) => {
+    assert.ifError(err);
+    assert.strictEqual(sent, batch.reduce((n, m) => n + m.msg.length, 0));
+
+    const gsoBatch = expected.slice(10).map((msg) => ({
+      msg: Buffer.from(msg),
+      port,
+      address: '127.0.0.1'
+    }));
+    client.sendBatch(gsoBatch, { gso: true }, common.mustCall((err, sent) => {
+      assert.ifError(err);
+      assert.strictEqual(sent, 50);
+    }));
+  }));
+}));
+
+{
+  // Messages without an address go where socket.send() sends them by
+  // default, even next to messages with an explicit address.
+  const receiver = dgram.createSocket('udp4');
+  const sender = dgram.createSocket('udp4');
+  const messages = ['default', 'localhost', 'loopback'];
+  const received = [];
+
+  receiver.on('message', common.mustCall((msg) => {
+    received.push(msg.toString());
+    if (received.length === messages.length) {
+      assert.deepStrictEqual(received.sort(), messages.slice().sort());
+      receiver.close();
+      sender.close();
+    }
+  }, messages.length));
+
+  receiver.bind(0, '127.0.0.1', common.mustCall(() => {
+    const { port } = receiver.address();
+    sender.sendBatch([
+      { msg: 'default', port },
+      { msg: 'localhost', port, address: 'localhost' },
+      { msg: 'loopback', port, address: '127.0.0.1' }
+    ], common.mustCall((err) => assert.ifError(err)));
+  }));
+}
@@ -0,0 +1,111 @@
+'use strict';
+const common = require('../common');
+const tmpdir = require('../common/tmpdir');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { COPYFILE_EXCL } = fs.constants;
+
+tmpdir.refresh();
+
+// Builds a tree that is deep and wide enough for several requests to be in
+// flight at the same time.
+const src = path.join(tmpdir.path, 'copydir-src');
+const files = [];
+for (let i = 0; i < 4; i++) {
+  const dir = path.join(src, `dir${i}`, 'nested');
+  fs.mkdirSync(dir, { recursive: true });
+  for (let j = 0; j < 10; j++) {
+    const file = path.join(dir, `file${j}.txt`);
+    fs.writeFileSync(file, `contents of ${i}/${j}`.repeat(i * 100 + 1));
+    files.push(path.relative(src, file));
+  }
+}
+fs.mkdirSync(path.join(src, 'empty'));
+fs.writeFileSync(path.join(src, 'top.txt'), 'top');
+files.push('top.txt');
+
+const canLink = common.canCreateSymLink();
+if (canLink)
+  fs.symlinkSync('top.txt', path.join(src, 'link'));
+
+function verify(dest) {
+  for (const file of files) {
+    assert.strictEqual(fs.readFileSync(path.join(dest, file), 'utf8'),
+                       fs.readFileSync(path.join(src, file), 'utf8'));
+  }
+  assert(fs.statSync(path.join(dest, 'empty')).isDirectory());
+  if (canLink) {
+    assert(fs.lstatSync(path.join(dest, 'link')).isSymbolicLink());
+    assert.strictEqual(fs.readlinkSync(path.join(dest, 'link')), 'top.txt');
+  }
+}
+
+{
+  const dest = path.join(tmpdir.path, 'copydir-sync');
+  fs.copyDirSync(src, dest);
+  verify(dest);
+
+  // Copying again merges with, and overwrites, what is already there.
+  fs.copyDirSync(src, dest);
+  verify(dest);
+
+  assert.throws(() => fs.copyDirSync(src, dest, COPYFILE_EXCL), {
+    code: 'EEXIST',
+    syscall: 'copyfile'
+  });
+}
+
+const asyncDest = path.join(tmpdir.path, 'copydir-async');
+fs.copyDir(src, asyncDest, common.mustCall((err) => {
+  assert.ifError(err);
+  verify(asyncDest);
+
+  fs.copyDir(src, asyncDest, COPYFILE_EXCL, common.mustCall((err) => {
+    assert.strictEqual(err.code, 'EEXIST');
+    assert.strictEqual(err.syscall, 'copyfile');
+  }));
+}));
+
+const promiseDest = path.join(tmpdir.path, 'copydir-promise');
+fs.promises.copyDir(src, promiseDest)
+  .then(common.mustCall(() => verify(promiseDest)));
+
+// The source has to be a directory.
+assert.throws(() => {
+  fs.copyDirSync(path.join(src, 'top.txt'), path.join(tmpdir.path, 'x'));
+}, { code: 'ENOTDIR' });
+
+fs.copyDir(path.join(tmpdir.path, 'missing'), path.join(tmpdir.path, 'x'),
+           common.mustCall((err) => {
+             assert.strictEqual(err.code, 'ENOENT');
+             assert.strictEqual(err.syscall, 'stat');
+           }));
+
+// A directory cannot be copied into itself.
+assert.throws(() => {
+  fs.copyDirSync(src, path.join(src, 'dir0', 'copy'));
+}, { code: 'EINVAL', syscall: 'copydir' });
+
+assert.rejects(fs.promises.copyDir(src, src), {
+  code: 'EINVAL',
+  syscall: 'copydir'
+}).then(common.mustCall());
+
+{
+  // Like every other error, it is reported asynchronously.
+  let sync = true;
+  const dest = path.join(src, 'dir0', 'copy');
+  fs.copyDir(src, dest, common.mustCall((err) => {
+    assert.strictEqual(sync, false);
+    assert.strictEqual(err.code, 'EINVAL');
+    assert.strictEqual(err.syscall, 'copydir');
+    assert.strictEqual(err.dest, dest);
+    assert(!fs.existsSync(dest));
+  }));
+  sync = false;
+}
+
+assert.throws(() => fs.copyDir(src, src), {
+  code: 'ERR_INVALID_CALLBACK'
+});
@@ -0,0 +1,171 @@
+'use strict';
+const common = require('../common');
+const tmpdir = require('../common/tmpdir');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+tmpdir.refresh();
+
+// More files than fit into a single batch, spread over a few levels.
+const root = path.join(tmpdir.path, 'walk');
+const expected = [];
+function add(relative, isDir) {
+  const full = path.join(root, relative);
+  if (isDir)
+    fs.mkdirSync(full);
+  else
+    fs.writeFileSync(full, '');
+  expected.push(full);
+}
+
+fs.mkdirSync(root);
+add('many', true);
+for (let i = 0; i < 5000; i++)
+  add(path.join('many', `file${i}`), false);
+add('a', true);
+add(path.join('a', 'b'), true);
+add(path.join('a', 'b', 'c'), true);
+add(path.join('a', 'b', 'c', 'deep.txt'), false);
+add(path.join('a', 'top.txt'), false);
+add('skip', true);
+add(path.join('skip', 'inner'), true);
+add(path.join('skip', 'inner', 'hidden.txt'), false);
+add('empty', true);
+
+if (common.canCreateSymLink()) {
+  // Links are reported but not followed.
+  fs.symlinkSync(path.join(root, 'a'), path.join(root, 'link'), 'dir');
+  expected.push(path.join(root, 'link'));
+}
+expected.sort();
+
+async function collect(walker) {
+  const entries = [];
+  for await (const entry of walker)
+    entries.push(entry);
+  return entries;
+}
+
+(async () => {
+  // Paths of everything in the tree.
+  {
+    const entries = await collect(fs.walk(root));
+    assert.deepStrictEqual(entries.sort(), expected);
+  }
+
+  // Dirents carry the path, inode and, optionally, the stats of the entry.
+  {
+    const entries = await collect(fs.walk(root, { stat: true }));
+    assert.strictEqual(entries.length, expected.length);
+    for (const entry of entries) {
+      assert(entry instanceof fs.Dirent);
+      assert.strictEqual(entry.name, path.basename(entry.path));
+      const stats = fs.lstatSync(entry.path);
+      assert.strictEqual(entry.isDirectory(), stats.isDirectory());
+      assert.strictEqual(entry.isSymbolicLink(), stats.isSymbolicLink());
+      assert(entry.stats instanceof fs.Stats);
+      assert.strictEqual(entry.stats.ino, stats.ino);
+      if (!common.isWindows)
+        assert.strictEqual(entry.ino, stats.ino);
+    }
+  }
+
+  // maxDepth: 0 only lists the root.
+  {
+    const entries = await collect(fs.walk(root, { maxDepth: 0 }));
+    assert.deepStrictEqual(
+      entries.sort(),
+      expected.filter((p) => path.dirname(p) === root));
+  }
+
+  // Filtered directories are not descended into.
+  {
+    const entries = await collect(fs.walk(root, {
+      withFileTypes: true,
+      filter: (entry) => entry.name !== 'skip' && !entry.name.startsWith('file')
+    }));
+    assert.deepStrictEqual(
+      entries.map((entry) => entry.path).sort(),
+      expected.filter((p) => {
+        const relative = path.relative(root, p);
+        return !relative.startsWith('skip') &&
+               !path.basename(p).startsWith('file');
+      }));
+  }
+
+  // Batches can be read one by one.
+  {
+    const walker = fs.walk(root);
+    assert.strictEqual(walker.path, root);
+    let count = 0;
+    let batches = 0;
+    let batch;
+    while ((batch = await walker.read()) !== null) {
+      assert(batch.length > 0);
+      count += batch.length;
+      batches++;
+    }
+    assert.strictEqual(count, expected.length);
+    assert(batches > 1);
+    assert.strictEqual(await walker.read(), null);
+  }
+
+  // An empty directory has no batches at all.
+  {
+    const walker = fs.walk(path.join(root, 'empty'));
+    assert(walker instanceof fs.Walker);
+    assert.strictEqual(await walker.read(), null);
+    assert.deepStrictEqual(await collect(fs.walk(path.join(root, 'empty'))),
+                           []);
+  }
+
+  // Leaving the loop early closes the walker.
+  {
+    const walker = fs.walk(root);
+    for await (const entry of walker) {
+      assert.strictEqual(typeof entry, 'string');
+      break;
+    }
+    assert.strictEqual(await walker.read(), null);
+  }
+
+  // Errors reject the read, and end the walk.
+  {
+    const missing = path.join(tmpdir.path, 'missing');
+    const walker = fs.walk(missing);
+    await assert.rejects(walker.read(), {
+      code: 'ENOENT',
+      syscall: 'scandir',
+      path: missing
+    });
+    assert.strictEqual(await walker.read(), null);
+  }
+
+  {
+    const error = new Error('filter error');
+    await assert.rejects(collect(fs.walk(root, {
+      filter() { throw error; }
+    })), error);
+  }
+})().then(common.mustCall());
+
+[null, 1, 'options'].forEach((options) => {
+  assert.throws(() => fs.walk(root, options), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+});
+
+[-1, 1.5].forEach((maxDepth) => {
+  assert.throws(() => fs.walk(root, { maxDepth }), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+});
+
+assert.throws(() => fs.walk(root, { filter: true }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+assert.throws(() => fs.walk(1), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
@@ -0,0 +1,74 @@
+// Flags: --max-http-header-size=65536
+'use strict';
+
+// Tests the serialization of the header block of outgoing messages, both when
+// it is done natively and when it has to fall back to JS, and the errors for
+// invalid headers that are passed to writeHead().
+
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+
+const large = 'x'.repeat(20 * 1024);
+
+const cases = {
+  '/': {
+    headers: { 'X-Number': 42, 'Set-Cookie': ['a=1', 'b=2'] },
+    expected: { 'x-number': '42', 'set-cookie': ['a=1', 'b=2'] }
+  },
+  '/obs-text': {
+    headers: { 'X-City': 'Düsseldorf' },
+    expected: { 'x-city': 'DÃ¼sseldorf' },
+    body: 'ü'
+  },
+  '/large': {
+    headers: [['X-Large', large]],
+    expected: { 'x-large': large }
+  }
+};
+
+const server = http.createServer(common.mustCall((req, res) => {
+  if (req.url === '/invalid') {
+    assert.throws(() => res.writeHead(200, { 'X Space': 'x' }), {
+      code: 'ERR_INVALID_HTTP_TOKEN'
+    });
+    assert.throws(() => res.writeHead(200, { 'X-Char': 'a\r\nb' }), {
+      code: 'ERR_INVALID_CHAR'
+    });
+    assert.throws(() => res.writeHead(200, [['X-Undefined', undefined]]), {
+      code: 'ERR_HTTP_INVALID_HEADER_VALUE'
+    });
+    assert.strictEqual(res.headersSent, false);
+    res.end();
+    return;
+  }
+
+  const { headers, body } = cases[req.url];
+  res.writeHead(200, headers);
+  assert.strictEqual(typeof res._header, 'string');
+  assert(res._header.startsWith('HTTP/1.1 200 OK\r\n'));
+  assert(res._header.endsWith('\r\n\r\n'));
+  res.end(body);
+}, Object.keys(cases).length + 1));
+
+server.listen(0, common.mustCall(() => {
+  const paths = Object.keys(cases).concat('/invalid');
+  let remaining = paths.length;
+
+  for (const path of paths) {
+    http.get({ port: server.address().port, path }, common.mustCall((res) => {
+      assert.strictEqual(res.statusCode, 200);
+      const { expected, body = '' } = cases[path] || {};
+      for (const name in expected)
+        assert.deepStrictEqual(res.headers[name], expected[name]);
+      res.setEncoding('utf8');
+      let received = '';
+      res.on('data', (chunk) => received += chunk);
+      res.on('end', common.mustCall(() => {
+        assert.strictEqual(received, body);
+        if (--remaining === 0)
+          server.close();
+      }));
+    }));
+  }
+}));
@@ -505,6 +505,35 @@ function expectBody(expected) {
 }
 
 
+//
+// Test many headers spread over multiple buffers, on a reused parser.
+//
+{
+  const expected = [];
+  let request = 'GET /many HTTP/1.1\r\n';
+  for (let i = 0; i < 100; i++) {
+    expected.push(`X-Header-${i}`, `value ${i}`);
+    request += `X-Header-${i}: value ${i}\r\n`;
+  }
+  request = Buffer.from(`${request}\r\n`);
+
+  const onHeadersComplete = (versionMajor, versionMinor, headers,
+                             method, url) => {
+    assert.strictEqual(url, '/many');
+    assert.deepStrictEqual(headers, expected);
+  };
+
+  const parser = newParser(REQUEST);
+  parser[kOnHeaders] = mustNotCall();
+  parser[kOnHeadersComplete] = mustCall(onHeadersComplete, 2);
+
+  for (let i = 0; i < request.length; i += 7) {
+    parser.execute(request.slice(i, i + 7));
+  }
+  parser.execute(request);
+}
+
+
 //
 // Test parser reinit sequence.
 //
@@ -0,0 +1,54 @@
+'use strict';
+
+// Header names and values that are sent as references into the HPACK dynamic
+// table reuse previously created strings. Make sure that they are delivered
+// correctly, also once the cache has been filled up with unique values.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const http2 = require('http2');
+
+const count = 600;
+
+const server = http2.createServer();
+server.on('stream', common.mustCall((stream, headers) => {
+  assert.strictEqual(headers['content-type'], 'application/grpc');
+  assert.strictEqual(headers.te, 'trailers');
+  assert.strictEqual(headers['x-repeated'], 'repeated value');
+  assert.strictEqual(headers['x-unique'], `unique value ${headers['x-id']}`);
+  stream.respond({
+    ':status': 200,
+    'x-id': headers['x-id']
+  });
+  stream.end();
+}, count));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`);
+  let remaining = count;
+
+  for (let i = 0; i < count; i++) {
+    const req = client.request({
+      ':method': 'POST',
+      'content-type': 'application/grpc',
+      'te': 'trailers',
+      'x-repeated': 'repeated value',
+      'x-unique': `unique value ${i}`,
+      'x-id': `${i}`
+    });
+    req.on('response', common.mustCall((headers) => {
+      assert.strictEqual(headers['x-id'], `${i}`);
+    }));
+    req.resume();
+    req.on('end', common.mustCall(() => {
+      if (--remaining === 0) {
+        client.close();
+        server.close();
+      }
+    }));
+    req.end();
+  }
+}));
@@ -0,0 +1,56 @@
+'use strict';
+
+// Tests that destroying the stream while the file is being read on the
+// threadpool neither crashes nor closes the caller's fd, and that the
+// session keeps working.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const fs = require('fs');
+const http2 = require('http2');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+const fname = path.join(tmpdir.path, 'large.bin');
+const data = Buffer.alloc(8 * 1024 * 1024, 'x');
+fs.writeFileSync(fname, data);
+const fd = fs.openSync(fname, 'r');
+
+const server = http2.createServer();
+let requests = 0;
+server.on('stream', common.mustCall((stream) => {
+  if (requests++ === 0) {
+    // respondWithFD() starts the first read right away.
+    stream.respondWithFD(fd);
+    stream.destroy();
+  } else {
+    stream.respondWithFD(fd);
+  }
+}, 2));
+server.on('close', common.mustCall(() => {
+  fs.fstatSync(fd);
+  fs.closeSync(fd);
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`);
+
+  const req = client.request();
+  req.on('error', common.mustNotCall());
+  req.resume();
+  req.on('close', common.mustCall(() => {
+    const again = client.request();
+    let length = 0;
+    again.on('data', (chunk) => length += chunk.length);
+    again.on('end', common.mustCall(() => {
+      assert.strictEqual(length, data.length);
+      client.close();
+      server.close();
+    }));
+    again.end();
+  }));
+  req.end();
+}));
@@ -0,0 +1,48 @@
+'use strict';
+
+// Tests that a read of the file that fails on the threadpool resets the
+// stream with NGHTTP2_INTERNAL_ERROR, and leaves the caller's fd open.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const fs = require('fs');
+const http2 = require('http2');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+const { NGHTTP2_INTERNAL_ERROR } = http2.constants;
+
+tmpdir.refresh();
+const fname = path.join(tmpdir.path, 'write-only.txt');
+fs.writeFileSync(fname, 'not readable through the fd');
+// The file has data, but reading it through this fd fails.
+const fd = fs.openSync(fname, 'a');
+
+const server = http2.createServer();
+server.on('stream', common.mustCall((stream) => {
+  stream.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ERR_HTTP2_STREAM_ERROR');
+  }));
+  stream.respondWithFD(fd);
+}));
+server.on('close', common.mustCall(() => {
+  fs.fstatSync(fd);
+  fs.closeSync(fd);
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`);
+  const req = client.request();
+  req.on('data', common.mustNotCall());
+  req.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ERR_HTTP2_STREAM_ERROR');
+  }));
+  req.on('close', common.mustCall(() => {
+    assert.strictEqual(req.rstCode, NGHTTP2_INTERNAL_ERROR);
+    client.close();
+    server.close();
+  }));
+  req.end();
+}));
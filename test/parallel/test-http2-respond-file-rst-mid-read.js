@@ -0,0 +1,52 @@
+'use strict';
+
+// Tests that a RST_STREAM from the client while the server is still reading
+// the file stops the response, and that the session keeps working.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const fs = require('fs');
+const http2 = require('http2');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+const { NGHTTP2_CANCEL } = http2.constants;
+
+tmpdir.refresh();
+const fname = path.join(tmpdir.path, 'large.bin');
+const data = Buffer.alloc(8 * 1024 * 1024, 'x');
+fs.writeFileSync(fname, data);
+
+const server = http2.createServer();
+let requests = 0;
+server.on('stream', common.mustCall((stream) => {
+  if (requests++ === 0) {
+    stream.on('close', common.mustCall(() => {
+      assert.strictEqual(stream.rstCode, NGHTTP2_CANCEL);
+    }));
+  }
+  stream.respondWithFile(fname);
+}, 2));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`);
+
+  const req = client.request();
+  req.once('data', common.mustCall(() => req.close(NGHTTP2_CANCEL)));
+  req.on('close', common.mustCall(() => {
+    assert.strictEqual(req.rstCode, NGHTTP2_CANCEL);
+
+    const again = client.request();
+    let length = 0;
+    again.on('data', (chunk) => length += chunk.length);
+    again.on('end', common.mustCall(() => {
+      assert.strictEqual(length, data.length);
+      client.close();
+      server.close();
+    }));
+    again.end();
+  }));
+  req.end();
+}));
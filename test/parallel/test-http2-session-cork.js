@@ -0,0 +1,116 @@
+'use strict';
+
+// Tests that a corked Http2Session holds back its frames until it has been
+// uncorked as many times as it was corked, and that the writes to the socket
+// are reported in the Http2Session performance entry.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const http2 = require('http2');
+const net = require('net');
+const { PerformanceObserver } = require('perf_hooks');
+
+const count = 10;
+const kTypeData = 0;
+const kTypeHeaders = 1;
+
+const obs = new PerformanceObserver(common.mustCallAtLeast((items) => {
+  for (const entry of items.getEntries()) {
+    if (entry.name !== 'Http2Session' || entry.type !== 'server')
+      continue;
+    assert(Number.isInteger(entry.writeCount) && entry.writeCount > 0);
+    assert(Number.isInteger(entry.writeBufferCount) &&
+           entry.writeBufferCount > 0);
+    obs.disconnect();
+  }
+}));
+obs.observe({ entryTypes: ['http2'] });
+
+// Whether the server session is corked. The proxy below checks that no
+// response frames reach the socket in the meantime.
+let corked = false;
+let streams = 0;
+let responseFrames = 0;
+
+const server = http2.createServer({ writeCoalescingThreshold: 1024 });
+server.on('session', common.mustCall((session) => {
+  session.cork();
+  session.cork();
+  corked = true;
+}));
+server.on('stream', common.mustCall((stream) => {
+  stream.respond();
+  stream.end('ok');
+  if (++streams === count) {
+    const session = stream.session;
+    session.uncork();
+    // Give frames that were not held back time to arrive at the proxy.
+    setTimeout(common.mustCall(() => {
+      corked = false;
+      session.uncork();
+    }), common.platformTimeout(100));
+  }
+}, count));
+
+// Forwards the connection and parses the frames that the server writes.
+const proxy = net.createServer(common.mustCall((clientSocket) => {
+  const serverSocket = net.connect(server.address().port);
+  let pending = Buffer.alloc(0);
+  serverSocket.on('data', (chunk) => {
+    pending = Buffer.concat([pending, chunk]);
+    while (pending.length >= 9) {
+      const length = pending.readUIntBE(0, 3);
+      if (pending.length < 9 + length)
+        break;
+      const type = pending[3];
+      if (type === kTypeData || type === kTypeHeaders) {
+        assert(!corked, `frame of type ${type} written while corked`);
+        responseFrames++;
+      }
+      pending = pending.slice(9 + length);
+    }
+    clientSocket.write(chunk);
+  });
+  clientSocket.pipe(serverSocket);
+  serverSocket.on('end', () => clientSocket.end());
+  clientSocket.on('error', () => {});
+  serverSocket.on('error', () => {});
+}));
+
+server.listen(0, common.mustCall(() => {
+  proxy.listen(0, common.mustCall(() => {
+    const client = http2.connect(`http://localhost:${proxy.address().port}`);
+    let remaining = count;
+
+    for (let i = 0; i < count; i++) {
+      const req = client.request();
+      req.on('response', common.mustCall(() => {
+        assert.strictEqual(corked, false);
+      }));
+      req.setEncoding('utf8');
+      let body = '';
+      req.on('data', (chunk) => body += chunk);
+      req.on('end', common.mustCall(() => {
+        assert.strictEqual(body, 'ok');
+        if (--remaining === 0) {
+          // A HEADERS and at least one DATA frame for every response.
+          assert(responseFrames >= 2 * count);
+          client.close();
+          proxy.close();
+          server.close();
+        }
+      }));
+      req.end();
+    }
+  }));
+}));
+
+assert.throws(() => {
+  const session = http2.connect('http://localhost:1');
+  session.on('error', () => {});
+  session.destroy();
+  session.cork();
+}, { code: 'ERR_HTTP2_INVALID_SESSION' });
@@ -0,0 +1,72 @@
+'use strict';
+
+// Tests that --module-resolution-cache persists resolution results across
+// runs and drops entries whose resolved file, or any directory or
+// package.json that the search looked at, changed.
+
+require('../common');
+const assert = require('assert');
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+
+const cacheFile = path.join(tmpdir.path, 'resolution.cache');
+const depDir = path.join(tmpdir.path, 'node_modules', 'dep');
+const entry = path.join(tmpdir.path, 'entry.js');
+
+fs.mkdirSync(depDir, { recursive: true });
+fs.writeFileSync(path.join(depDir, 'package.json'), '{"main": "a.js"}');
+fs.writeFileSync(path.join(depDir, 'a.js'), 'module.exports = "a";');
+fs.writeFileSync(entry, 'console.log(require("dep"));');
+
+function run(file = entry) {
+  return execFileSync(process.execPath, [
+    `--module-resolution-cache=${cacheFile}`,
+    file
+  ]).toString().trim();
+}
+
+// The first run populates the cache, the second one reads it.
+assert.strictEqual(run(), 'a');
+assert(fs.existsSync(cacheFile));
+assert.strictEqual(run(), 'a');
+
+// A cached result whose file is gone must not be used.
+fs.unlinkSync(path.join(depDir, 'a.js'));
+fs.writeFileSync(path.join(depDir, 'package.json'), '{"main": "b.js"}');
+fs.writeFileSync(path.join(depDir, 'b.js'), 'module.exports = "b";');
+assert.strictEqual(run(), 'b');
+assert.strictEqual(run(), 'b');
+
+// A new "main" is picked up even though the old one still exists.
+fs.writeFileSync(path.join(depDir, 'a.js'), 'module.exports = "a";');
+assert.strictEqual(run(), 'b');
+assert.strictEqual(run(), 'b');
+fs.writeFileSync(path.join(depDir, 'package.json'), '{"main": "a.js"}');
+assert.strictEqual(run(), 'a');
+assert.strictEqual(run(), 'a');
+
+// So is a file that takes precedence over the cached directory.
+const shadow = path.join(tmpdir.path, 'node_modules', 'dep.js');
+fs.writeFileSync(shadow, 'module.exports = "shadow";');
+assert.strictEqual(run(), 'shadow');
+fs.unlinkSync(shadow);
+assert.strictEqual(run(), 'a');
+
+// And so is a node_modules directory closer to the requiring module.
+const nested = path.join(tmpdir.path, 'nested');
+const nestedEntry = path.join(nested, 'entry.js');
+fs.mkdirSync(nested);
+fs.writeFileSync(nestedEntry, 'console.log(require("dep"));');
+assert.strictEqual(run(nestedEntry), 'a');
+fs.mkdirSync(path.join(nested, 'node_modules'));
+fs.writeFileSync(path.join(nested, 'node_modules', 'dep.js'),
+                 'module.exports = "nested";');
+assert.strictEqual(run(nestedEntry), 'nested');
+
+// Garbage in the cache file is ignored.
+fs.writeFileSync(cacheFile, 'not a cache');
+assert.strictEqual(run(), 'a');
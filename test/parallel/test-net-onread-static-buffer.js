@@ -0,0 +1,77 @@
+'use strict';
+
+// Tests the `onread` option of net.Socket, with a static buffer and with a
+// function that returns the buffer for each read.
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+const message = Buffer.alloc(64 * 1024, 'abc');
+
+const server = net.createServer((c) => {
+  c.end(message);
+}).listen(0, common.mustCall(() => {
+  const port = server.address().port;
+
+  {
+    const buffer = Buffer.alloc(1024);
+    const received = [];
+    net.connect({
+      port,
+      onread: {
+        buffer,
+        callback: common.mustCallAtLeast((nread, buf) => {
+          assert.strictEqual(buf, buffer);
+          assert(nread > 0 && nread <= buffer.length);
+          received.push(Buffer.from(buf.slice(0, nread)));
+        })
+      }
+    }).on('data', common.mustNotCall()).on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(received), message);
+      done();
+    }));
+  }
+
+  {
+    const buffers = [];
+    let total = 0;
+    net.connect({
+      port,
+      onread: {
+        buffer: common.mustCallAtLeast(() => {
+          buffers.push(Buffer.alloc(512));
+          return buffers[buffers.length - 1];
+        }),
+        callback: common.mustCallAtLeast((nread, buf) => {
+          assert.strictEqual(buf, buffers[buffers.length - 1]);
+          total += nread;
+        })
+      }
+    }).on('end', common.mustCall(() => {
+      assert.strictEqual(total, message.length);
+      done();
+    }));
+  }
+
+  {
+    // Returning `false` stops reading, so the callback is called only once
+    // although the message does not fit into the buffer.
+    net.connect({
+      port,
+      onread: {
+        buffer: Buffer.alloc(1024),
+        callback: common.mustCall(function() {
+          setImmediate(() => this.destroy());
+          return false;
+        })
+      }
+    }).on('close', common.mustCall(done));
+  }
+
+  let pending = 3;
+  function done() {
+    if (--pending === 0)
+      server.close();
+  }
+}));
@@ -0,0 +1,78 @@
+// Flags: --expose-gc
+'use strict';
+
+// Tests that sockets created with `receiveSlab: true` receive their data as
+// views into shared chunks, and that the data is intact.
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+const kChunks = 64;
+const kChunkSize = 48 * 1024;
+const payloads = [];
+for (let i = 0; i < kChunks; i++)
+  payloads.push(Buffer.alloc(kChunkSize, i % 256));
+const expected = Buffer.concat(payloads);
+
+const server = net.createServer({ receiveSlab: true }, common.mustCall((c) => {
+  const received = [];
+  c.on('data', (buf) => {
+    assert.strictEqual(buf.byteOffset % 8, 0);
+    received.push(buf);
+  });
+  c.on('end', common.mustCall(() => {
+    assert(received.some((buf) => buf.buffer.byteLength === 1024 * 1024));
+    assert.deepStrictEqual(Buffer.concat(received), expected);
+    c.end();
+    received.length = 0;
+    global.gc();
+    server.close(testRetention);
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect({
+    port: server.address().port,
+    receiveSlab: true
+  }, common.mustCall(() => {
+    for (const payload of payloads)
+      client.write(payload);
+    client.end();
+  }));
+  client.resume();
+}));
+
+// Data that is retained keeps its chunks alive. Once too many of them are,
+// reads fall back to separate allocations.
+function testRetention() {
+  const kSlabChunkSize = 1024 * 1024;
+  const kMaxRetiredChunks = 16;
+  const total = (kMaxRetiredChunks + 8) * kSlabChunkSize;
+
+  const options = { receiveSlab: true };
+  const server = net.createServer(options, common.mustCall((c) => {
+    const received = [];
+    let length = 0;
+    c.on('data', (buf) => {
+      received.push(buf);
+      length += buf.length;
+    });
+    c.on('end', common.mustCall(() => {
+      assert.strictEqual(length, total);
+      const chunks = new Set(received.map((buf) => buf.buffer)
+        .filter((ab) => ab.byteLength === kSlabChunkSize));
+      assert(chunks.size <= kMaxRetiredChunks + 1);
+      assert(received.some((buf) => buf.buffer.byteLength !== kSlabChunkSize));
+      c.end();
+      server.close();
+    }));
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port, common.mustCall(() => {
+      client.end(Buffer.alloc(total));
+    }));
+    client.resume();
+  }));
+}
@@ -0,0 +1,68 @@
+'use strict';
+
+// Checks that perf_hooks.monitorThreadpool() records the wait and run times of
+// threadpool work per threadpool, and only while it is enabled.
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const zlib = require('zlib');
+const { monitorThreadpool } = require('perf_hooks');
+
+const monitor = monitorThreadpool();
+const pools = ['cpu', 'fastIO', 'slowIO'];
+
+function recorded() {
+  return pools.filter((pool) => monitor[pool].runTime.max > 0);
+}
+
+for (const pool of pools) {
+  for (const histogram of [monitor[pool].waitTime, monitor[pool].runTime]) {
+    assert.strictEqual(histogram.max, 0);
+    assert.strictEqual(histogram.exceeds, 0);
+    ['', {}, undefined].forEach((percentile) => {
+      common.expectsError(() => histogram.percentile(percentile), {
+        type: TypeError,
+        code: 'ERR_INVALID_ARG_TYPE'
+      });
+    });
+    [-1, 0, 101].forEach((percentile) => {
+      common.expectsError(() => histogram.percentile(percentile), {
+        type: RangeError,
+        code: 'ERR_INVALID_ARG_VALUE'
+      });
+    });
+  }
+}
+
+// Work that is done while the monitor is disabled isn't recorded.
+zlib.deflate('hello world', common.mustCall((err) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(recorded(), []);
+
+  assert.strictEqual(monitor.enable(), true);
+  assert.strictEqual(monitor.enable(), false);
+
+  // fs.access() doesn't have a fast path that bypasses the threadpool.
+  fs.access(__filename, common.mustCall((err) => {
+    assert.ifError(err);
+    zlib.deflate('hello world', common.mustCall((err) => {
+      assert.ifError(err);
+      assert.strictEqual(monitor.disable(), true);
+      assert.strictEqual(monitor.disable(), false);
+
+      assert.deepStrictEqual(recorded(), ['cpu', 'fastIO']);
+      for (const pool of ['cpu', 'fastIO']) {
+        const { waitTime, runTime } = monitor[pool];
+        assert(waitTime.max >= waitTime.min);
+        assert(runTime.percentile(50) > 0);
+        assert(runTime.percentiles.size > 0);
+        assert.strictEqual(waitTime.exceeds, 0);
+        assert.strictEqual(runTime.exceeds, 0);
+      }
+
+      monitor.reset();
+      assert.deepStrictEqual(recorded(), []);
+    }));
+  }));
+}));
@@ -0,0 +1,49 @@
+'use strict';
+
+// Checks that the statistics of each of libuv's threadpools account for the
+// work that is submitted to it.
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const zlib = require('zlib');
+const { getThreadpoolStats } = require('perf_hooks');
+
+const fields = [
+  'threads', 'idleThreads', 'queued', 'maxQueued', 'running', 'submitted',
+  'completed', 'waitTime', 'maxWaitTime', 'runTime'
+];
+
+function check(stats) {
+  assert.deepStrictEqual(Object.keys(stats), ['cpu', 'fastIO', 'slowIO']);
+  for (const pool of Object.values(stats)) {
+    assert.deepStrictEqual(Object.keys(pool), fields);
+    for (const field of fields) {
+      assert(Number.isSafeInteger(pool[field]) && pool[field] >= 0, field);
+    }
+    assert(pool.threads > 0);
+    assert(pool.idleThreads <= pool.threads);
+    assert(pool.queued <= pool.maxQueued);
+    assert(pool.running <= pool.threads);
+    assert(pool.completed <= pool.submitted);
+    assert(pool.maxWaitTime <= pool.waitTime);
+  }
+}
+
+const before = getThreadpoolStats();
+check(before);
+
+// fs.access() doesn't have a fast path that bypasses the threadpool.
+fs.access(__filename, common.mustCall((err) => {
+  assert.ifError(err);
+  zlib.deflate('hello world', common.mustCall((err) => {
+    assert.ifError(err);
+    const after = getThreadpoolStats();
+    check(after);
+    assert(after.fastIO.submitted > before.fastIO.submitted);
+    assert(after.fastIO.completed > before.fastIO.completed);
+    assert(after.cpu.submitted > before.cpu.submitted);
+    assert(after.cpu.completed > before.cpu.completed);
+    assert.strictEqual(after.slowIO.submitted, before.slowIO.submitted);
+  }));
+}));
@@ -0,0 +1,107 @@
+'use strict';
+
+// Tests handshakes of servers with the `asyncHandshake` option, with RSA and
+// EC keys, with and without the callbacks that the server makes into JS
+// during a handshake.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const tls = require('tls');
+const { SSL_OP_NO_TICKET } = require('constants');
+const fixtures = require('../common/fixtures');
+
+const rsa = {
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem')
+};
+const ec = {
+  key: fixtures.readKey('ec-key.pem'),
+  cert: fixtures.readKey('ec-cert.pem')
+};
+
+const cases = [
+  { ...rsa, maxVersion: 'TLSv1.2' },
+  { ...rsa, maxVersion: 'TLSv1.3' },
+  { ...ec, maxVersion: 'TLSv1.2' },
+  { ...ec, maxVersion: 'TLSv1.3' },
+  // RSA key exchange, the key decrypts instead of signing.
+  { ...rsa, maxVersion: 'TLSv1.2', ciphers: 'AES128-GCM-SHA256' },
+  { ...rsa, maxVersion: 'TLSv1.2', sni: true },
+  { ...rsa, maxVersion: 'TLSv1.2', newSession: true },
+  { ...rsa, maxVersion: 'TLSv1.2', alpn: true },
+  { ...ec, maxVersion: 'TLSv1.3', alpn: true },
+  { ...rsa, maxVersion: 'TLSv1.2', ocsp: true },
+];
+
+function test(options, cb) {
+  const server = tls.createServer({
+    key: options.key,
+    cert: options.cert,
+    maxVersion: options.maxVersion,
+    ciphers: options.ciphers,
+    // 'newSession' is only emitted for sessions without tickets.
+    secureOptions: options.newSession ? SSL_OP_NO_TICKET : 0,
+    asyncHandshake: true,
+    ALPNProtocols: options.alpn ? ['b', 'a'] : undefined,
+    SNICallback: options.sni ?
+      common.mustCall((servername, done) => {
+        assert.strictEqual(servername, 'agent1');
+        done(null, tls.createSecureContext(ec));
+      }) : undefined
+  }, common.mustCall((socket) => {
+    socket.pipe(socket);
+  }));
+
+  if (options.ocsp) {
+    server.on('OCSPRequest', common.mustCall((cert, issuer, done) => {
+      done(null, Buffer.from('ocsp response'));
+    }));
+  }
+
+  if (options.newSession) {
+    server.on('newSession', common.mustCall((id, data, done) => {
+      setImmediate(done);
+    }));
+  }
+
+  server.listen(0, common.mustCall(() => {
+    const received = [];
+    const client = tls.connect({
+      port: server.address().port,
+      servername: 'agent1',
+      rejectUnauthorized: false,
+      ALPNProtocols: options.alpn ? ['a', 'b'] : undefined,
+      requestOCSP: options.ocsp
+    }, common.mustCall(() => {
+      if (options.alpn)
+        assert.strictEqual(client.alpnProtocol, 'b');
+      const expected = options.sni || options.key === ec.key ?
+        'agent2' : 'agent1';
+      assert.strictEqual(client.getPeerCertificate().subject.CN, expected);
+      client.end('hello');
+    }));
+    if (options.ocsp) {
+      client.on('OCSPResponse', common.mustCall((response) => {
+        assert.strictEqual(response.toString(), 'ocsp response');
+      }));
+    }
+    client.on('data', (buf) => received.push(buf));
+    client.on('end', common.mustCall(() => {
+      assert.strictEqual(Buffer.concat(received).toString(), 'hello');
+      server.close(cb);
+    }));
+  }));
+}
+
+(function next() {
+  const options = cases.shift();
+  if (options !== undefined)
+    test(options, common.mustCall(next));
+})();
+
+assert.throws(() => tls.createServer({ asyncHandshake: 'yes' }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
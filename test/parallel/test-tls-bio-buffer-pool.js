@@ -0,0 +1,53 @@
+// Flags: --expose-internals
+'use strict';
+
+// Tests that the buffers of the BIOs behind TLS sockets are returned to a
+// per-Environment pool and reused by later connections, instead of being
+// allocated again for each one.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+const { internalBinding } = require('internal/test/binding');
+const { getBIOBufferPoolStats } = internalBinding('tls_wrap');
+
+const payload = Buffer.alloc(64 * 1024, 'x');
+
+const server = tls.createServer({
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem')
+}, (socket) => {
+  socket.end(payload);
+});
+
+function connect(cb) {
+  let received = 0;
+  const client = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  });
+  client.on('data', (buf) => received += buf.length);
+  client.on('end', common.mustCall(() => {
+    assert.strictEqual(received, payload.length);
+    client.destroy();
+    // Let the handles of both sides be freed before the next connection.
+    setImmediate(cb);
+  }));
+}
+
+server.listen(0, common.mustCall(() => {
+  connect(common.mustCall(() => {
+    const [allocated, reused] = getBIOBufferPoolStats();
+    assert(allocated > 0);
+    connect(common.mustCall(() => {
+      const [allocatedAfter, reusedAfter] = getBIOBufferPoolStats();
+      assert(reusedAfter > reused);
+      assert(allocatedAfter - allocated < reusedAfter - reused);
+      server.close();
+    }));
+  }));
+}));
@@ -0,0 +1,92 @@
+'use strict';
+
+// Tests that decrypted data is read directly into the buffers of the
+// stream's listener, including buffers that are smaller than a TLS record,
+// and that the handle reports no copied bytes for it, while it does report
+// the data that it has to copy.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const net = require('net');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const payload = Buffer.alloc(256 * 1024);
+for (let i = 0; i < payload.length; i++)
+  payload[i] = i % 251;
+
+const key = fixtures.readKey('agent1-key.pem');
+const cert = fixtures.readKey('agent1-cert.pem');
+
+const server = tls.createServer({ key, cert }, (socket) => {
+  socket.end(payload);
+});
+
+server.listen(0, common.mustCall(() => {
+  const port = server.address().port;
+  let pending = 2;
+  const done = () => {
+    if (--pending === 0)
+      server.close();
+  };
+
+  {
+    const received = [];
+    const client = tls.connect({ port, rejectUnauthorized: false });
+    client.on('data', (buf) => received.push(buf));
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(received), payload);
+      assert.strictEqual(client._handle.bytesRead, payload.length);
+      assert.strictEqual(client._handle.bytesCopied, 0);
+      done();
+    }));
+  }
+
+  {
+    const buffer = Buffer.alloc(1000);
+    const received = [];
+    const client = tls.connect({
+      port,
+      rejectUnauthorized: false,
+      onread: {
+        buffer,
+        callback: common.mustCallAtLeast((nread, buf) => {
+          assert(nread <= buffer.length);
+          received.push(Buffer.from(buf.slice(0, nread)));
+        })
+      }
+    });
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(received), payload);
+      assert.strictEqual(client._handle.bytesCopied, 0);
+      done();
+    }));
+  }
+}));
+
+// Data that the socket has buffered before it is wrapped is handed to the
+// TLS handle with a copy, and counted.
+const netServer = net.createServer(common.mustCall((socket) => {
+  socket.once('readable', common.mustCall(() => {
+    const buffered = socket.readableLength;
+    assert(buffered > 0);
+    const tlsSocket = new tls.TLSSocket(socket, { isServer: true, key, cert });
+    tlsSocket.on('secure', common.mustCall(() => {
+      // The client sends nothing but its hello before the server replies.
+      assert.strictEqual(tlsSocket._handle.bytesCopied, buffered);
+      tlsSocket.end();
+    }));
+  }));
+}));
+
+netServer.listen(0, common.mustCall(() => {
+  const client = tls.connect({
+    port: netServer.address().port,
+    rejectUnauthorized: false
+  });
+  client.resume();
+  client.on('end', common.mustCall(() => netServer.close()));
+}));
@@ -0,0 +1,98 @@
+'use strict';
+
+// Tests the `ktls` option over loopback connections. Data has to arrive
+// intact whether or not the kernel takes over, and for the cases that are
+// supported it must take over if the `tls` module is loaded.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const fs = require('fs');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+let kernelSupport = false;
+if (common.isLinux) {
+  try {
+    kernelSupport = fs.readFileSync('/proc/sys/net/ipv4/tcp_available_ulp',
+                                    'latin1').split(/\s+/).includes('tls');
+  } catch {}
+}
+
+const key = fixtures.readKey('agent1-key.pem');
+const cert = fixtures.readKey('agent1-cert.pem');
+
+const payload = Buffer.alloc(1024 * 1024);
+for (let i = 0; i < payload.length; i++)
+  payload[i] = i % 251;
+
+const cases = [
+  { ciphers: 'ECDHE-RSA-AES128-GCM-SHA256', server: true, client: true },
+  { ciphers: 'ECDHE-RSA-AES256-GCM-SHA384', server: true, client: true },
+  { ciphers: 'ECDHE-RSA-CHACHA20-POLY1305', server: true, client: true },
+  // Only one side uses the kernel, the other one keeps using OpenSSL.
+  { ciphers: 'ECDHE-RSA-AES128-GCM-SHA256', server: true, client: false },
+  { ciphers: 'ECDHE-RSA-AES128-GCM-SHA256', server: false, client: true },
+  // Not supported, the option is ignored.
+  { ciphers: 'ECDHE-RSA-AES128-SHA256', server: true, client: true,
+    unsupported: true },
+  { maxVersion: 'TLSv1.3', server: true, client: true, unsupported: true },
+];
+
+function test(options, cb) {
+  const maxVersion = options.maxVersion || 'TLSv1.2';
+  const expectKTLS = (enabled) =>
+    enabled && !options.unsupported && kernelSupport;
+
+  const server = tls.createServer({
+    key,
+    cert,
+    maxVersion,
+    ciphers: options.ciphers,
+    ktls: options.server
+  }, common.mustCall((socket) => {
+    socket.pipe(socket);
+    socket.on('end', common.mustCall(() => {
+      if (expectKTLS(options.server))
+        assert.strictEqual(socket.isKTLSEnabled(), true);
+      if (!options.server || options.unsupported)
+        assert.strictEqual(socket.isKTLSEnabled(), false);
+    }));
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const received = [];
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false,
+      maxVersion,
+      ktls: options.client
+    }, common.mustCall(() => {
+      assert.strictEqual(client.getProtocol(), maxVersion);
+      for (let i = 0; i < payload.length; i += 16 * 1024)
+        client.write(payload.slice(i, i + 16 * 1024));
+      client.end();
+    }));
+    client.on('data', (buf) => received.push(buf));
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(received), payload);
+      if (expectKTLS(options.client))
+        assert.strictEqual(client.isKTLSEnabled(), true);
+      if (!options.client || options.unsupported)
+        assert.strictEqual(client.isKTLSEnabled(), false);
+      server.close(cb);
+    }));
+  }));
+}
+
+(function next() {
+  const options = cases.shift();
+  if (options !== undefined)
+    test(options, common.mustCall(next));
+})();
+
+assert.throws(() => tls.createServer({ ktls: 'yes' }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
@@ -0,0 +1,105 @@
+'use strict';
+
+// Tests that a session created by a server with the `sharedSessionCache`
+// option can be resumed by a server in another thread of the same process,
+// without any 'newSession'/'resumeSession' handlers, both from the cache and
+// from a session ticket, but not by a server with another session ID context.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const tls = require('tls');
+const { SSL_OP_NO_TICKET } = require('constants');
+const { Worker } = require('worker_threads');
+const fixtures = require('../common/fixtures');
+
+// TLSv1.3 and session tickets, as by default.
+const ticketOptions = {
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem'),
+  sessionIdContext: 'test-tls-shared-session-cache',
+  sharedSessionCache: true
+};
+
+// Session tickets would be resumed without a lookup in the cache.
+const idOptions = {
+  ...ticketOptions,
+  maxVersion: 'TLSv1.2',
+  secureOptions: SSL_OP_NO_TICKET
+};
+
+const otherContextOptions = {
+  ...idOptions,
+  sessionIdContext: 'another-context'
+};
+
+const worker = new Worker(`
+  const tls = require('tls');
+  const { parentPort, workerData } = require('worker_threads');
+  const servers = workerData.map((options) => {
+    return tls.createServer(options, (socket) => socket.end()).listen(0);
+  });
+  servers[servers.length - 1].on('listening', () => {
+    parentPort.postMessage(servers.map((server) => server.address().port));
+  });
+  parentPort.once('message', () => {
+    for (const server of servers)
+      server.close();
+  });
+`, { eval: true, workerData: [idOptions, ticketOptions, otherContextOptions] });
+
+// Connects to a server in this thread, then tries to resume the session on
+// `port` in the worker.
+function resume(options, port, reused, callback) {
+  const server = tls.createServer(options, (socket) => socket.end());
+  server.listen(0, common.mustCall(() => {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false
+    }, common.mustCall(() => {
+      assert.strictEqual(client.isSessionReused(), false);
+    }));
+    client.resume();
+    client.once('session', common.mustCall((session) => {
+      const resumed = tls.connect({
+        port,
+        rejectUnauthorized: false,
+        session
+      }, common.mustCall(() => {
+        assert.strictEqual(resumed.isSessionReused(), reused);
+      }));
+      resumed.resume();
+      resumed.on('end', common.mustCall(() => {
+        server.close();
+        callback();
+      }));
+    }));
+  }));
+}
+
+worker.once('message', common.mustCall((ports) => {
+  const [idPort, ticketPort, otherContextPort] = ports;
+  const { hits, misses, size } = tls.getSharedSessionCacheStats();
+
+  resume(idOptions, idPort, true, common.mustCall(() => {
+    let stats = tls.getSharedSessionCacheStats();
+    assert.strictEqual(stats.size, size + 1);
+    assert.strictEqual(stats.hits, hits + 1);
+
+    resume(idOptions, otherContextPort, false, common.mustCall(() => {
+      stats = tls.getSharedSessionCacheStats();
+      assert.strictEqual(stats.hits, hits + 1);
+      assert.strictEqual(stats.misses, misses + 1);
+
+      resume(ticketOptions, ticketPort, true, common.mustCall(() => {
+        worker.postMessage('close');
+      }));
+    }));
+  }));
+}));
+
+assert.throws(() => tls.createServer({ sharedSessionCache: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
@@ -0,0 +1,58 @@
+'use strict';
+
+// Tests that the `parallel` option of Deflate and Gzip produces streams that
+// decompress to the original input, with the async, sync and stream APIs.
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+// Several blocks, the last of which is not full, with data that refers back
+// across block boundaries.
+const words = ['lorem', 'ipsum', 'dolor', 'sit', 'amet', 'consectetur'];
+const parts = [];
+for (let i = 0; parts.length < 100000; i++)
+  parts.push(words[(i * 7 + (i >> 10)) % words.length]);
+const input = Buffer.from(parts.join(' '));
+assert(input.length > 4 * 128 * 1024);
+
+const cases = [
+  [zlib.gzip, zlib.gzipSync, zlib.createGzip, zlib.gunzipSync],
+  [zlib.deflate, zlib.deflateSync, zlib.createDeflate, zlib.inflateSync]
+];
+
+for (const [async, sync, create, decompress] of cases) {
+  for (const parallel of [2, 4]) {
+    const opts = { parallel };
+
+    const compressed = sync(input, opts);
+    assert.deepStrictEqual(decompress(compressed), input);
+
+    async(input, opts, common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(result, compressed);
+    }));
+
+    // Small writes and an explicit flush in between.
+    const stream = create(opts);
+    const chunks = [];
+    stream.on('data', (chunk) => chunks.push(chunk));
+    stream.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(decompress(Buffer.concat(chunks)), input);
+      assert.strictEqual(stream.bytesWritten, input.length);
+    }));
+    const half = input.length >> 1;
+    for (let i = 0; i < half; i += 1000)
+      stream.write(input.slice(i, Math.min(i + 1000, half)));
+    stream.flush(common.mustCall(() => {
+      stream.end(input.slice(half));
+    }));
+  }
+
+  assert.deepStrictEqual(decompress(sync(Buffer.alloc(0), { parallel: 2 })),
+                         Buffer.alloc(0));
+}
+
+assert.throws(() => zlib.createGzip({ parallel: 0 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
@@ -0,0 +1,51 @@
+'use strict';
+
+// Tests that zlib streams created with `pool: true` reuse the state of
+// earlier streams and still produce correct results.
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+const input = Buffer.from('hello pooled world '.repeat(1000));
+
+// Sequential use of the same pooled state, with both the sync and the
+// async APIs.
+for (let i = 0; i < 3; i++) {
+  const compressed = zlib.gzipSync(input, { pool: true });
+  assert.deepStrictEqual(zlib.gunzipSync(compressed, { pool: true }), input);
+  assert.deepStrictEqual(compressed, zlib.gzipSync(input));
+}
+
+let pending = 10;
+for (let i = 0; i < 10; i++) {
+  zlib.deflate(input, { pool: true, level: 1 }, common.mustCall((err, buf) => {
+    assert.ifError(err);
+    zlib.inflate(buf, { pool: true }, common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(result, input);
+      if (--pending === 0)
+        testStreams();
+    }));
+  }));
+}
+
+// A stream that was destroyed before it finished must not leave state
+// behind that affects the next stream.
+function testStreams() {
+  const gzip = zlib.createGzip({ pool: true });
+  gzip.write(input.slice(0, 100));
+  gzip.close(common.mustCall(() => {
+    const chunks = [];
+    zlib.createGzip({ pool: true })
+      .on('data', (chunk) => chunks.push(chunk))
+      .on('end', common.mustCall(() => {
+        assert.deepStrictEqual(zlib.gunzipSync(Buffer.concat(chunks)), input);
+      }))
+      .end(input);
+  }));
+}
+
+assert.throws(() => zlib.createGzip({ pool: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
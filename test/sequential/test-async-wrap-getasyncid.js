@@ -145,6 +145,11 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
 
   const StatWatcher = binding.StatWatcher;
   testInitialized(new StatWatcher(), 'StatWatcher');
+
+  const DirWalker = binding.DirWalker;
+  const walker = new DirWalker(path.toNamespacedPath('../'), 0, false);
+  testInitialized(walker, 'DirWalker');
+  walker.close();
 }
 
 
@@ -73,6 +73,7 @@ const customTypesMap = {
   'fs.FSWatcher': 'fs.html#fs_class_fs_fswatcher',
   'fs.ReadStream': 'fs.html#fs_class_fs_readstream',
   'fs.Stats': 'fs.html#fs_class_fs_stats',
+  'fs.Walker': 'fs.html#fs_class_fs_walker',
   'fs.WriteStream': 'fs.html#fs_class_fs_writestream',
 
   'http.Agent': 'http.html#http_class_http_agent',
@@ -113,6 +114,7 @@ const customTypesMap = {
     'perf_hooks.html#perf_hooks_class_performanceobserver',
   'PerformanceObserverEntryList':
     'perf_hooks.html#perf_hooks_class_performanceobserverentrylist',
+  'ThreadpoolMonitor': 'perf_hooks.html#perf_hooks_class_threadpoolmonitor',
 
   'readline.Interface': 'readline.html#readline_class_interface',
 